@@ -0,0 +1,88 @@
+/**********************************************************************
+* File:        BinarizeDialog.cpp
+* Description: Binarization method dialog
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "dialogs/BinarizeDialog.h"
+#include "ui_BinarizeDialog.h"
+
+BinarizeDialog::BinarizeDialog(QWidget* parent,
+                               const Binarizer::Options& options) :
+    QDialog(parent),
+    ui(new Ui::BinarizeDialog) {
+    ui->setupUi(this);
+
+    ui->methodComboBox->addItems(Binarizer::methodNames());
+    ui->methodComboBox->setCurrentIndex(static_cast<int>(options.method));
+    ui->windowSpinBox->setValue(options.windowSize);
+    ui->kSpinBox->setValue(options.k);
+    methodChanged(ui->methodComboBox->currentIndex());
+
+    connect(ui->methodComboBox, SIGNAL(currentIndexChanged(int)), this,
+            SLOT(methodChanged(int)));
+    connect(ui->methodComboBox, SIGNAL(currentIndexChanged(int)), this,
+            SLOT(emitOptionsChanged()));
+    connect(ui->windowSpinBox, SIGNAL(valueChanged(int)), this,
+            SLOT(emitOptionsChanged()));
+    connect(ui->kSpinBox, SIGNAL(valueChanged(double)), this,
+            SLOT(emitOptionsChanged()));
+    connect(ui->previewCheckBox, SIGNAL(toggled(bool)), this,
+            SLOT(emitOptionsChanged()));
+}
+
+BinarizeDialog::~BinarizeDialog() {
+    delete ui;
+}
+
+Binarizer::Options BinarizeDialog::options() const {
+    Binarizer::Options options;
+    options.method =
+            static_cast<Binarizer::Method>(ui->methodComboBox->currentIndex());
+    options.windowSize = ui->windowSpinBox->value();
+    options.k = ui->kSpinBox->value();
+    return options;
+}
+
+bool BinarizeDialog::isPreviewEnabled() const {
+    return ui->previewCheckBox->isChecked();
+}
+
+void BinarizeDialog::setPreviewInfo(const QString& info) {
+    ui->infoLabel->setText(info);
+}
+
+void BinarizeDialog::emitOptionsChanged() {
+    emit optionsChanged();
+}
+
+void BinarizeDialog::methodChanged(int index) {
+    bool adaptive = (index == Binarizer::Sauvola ||
+                     index == Binarizer::Niblack);
+    ui->windowSpinBox->setEnabled(adaptive);
+    ui->kSpinBox->setEnabled(adaptive);
+
+    // Sauvola and Niblack use k of different sign; offer usual default
+    ui->kSpinBox->blockSignals(true);
+    if (index == Binarizer::Sauvola && ui->kSpinBox->value() < 0)
+        ui->kSpinBox->setValue(0.34);
+    else if (index == Binarizer::Niblack && ui->kSpinBox->value() > 0)
+        ui->kSpinBox->setValue(-0.2);
+    ui->kSpinBox->blockSignals(false);
+}
@@ -0,0 +1,60 @@
+/**********************************************************************
+* File:        BinarizeDialog.h
+* Description: Binarization method dialog
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef DIALOGS_BINARIZEDIALOG_H_
+#define DIALOGS_BINARIZEDIALOG_H_
+
+#include <QDialog>
+
+#include "Binarizer.h"
+
+namespace Ui {
+    class BinarizeDialog;
+}
+
+class BinarizeDialog : public QDialog {
+  Q_OBJECT
+
+  public:
+    explicit BinarizeDialog(QWidget* parent = 0,
+                            const Binarizer::Options& options =
+                                Binarizer::Options());
+    ~BinarizeDialog();
+
+    Binarizer::Options options() const;
+    bool isPreviewEnabled() const;
+    void setPreviewInfo(const QString& info);
+
+  public slots:
+    void emitOptionsChanged();
+
+  private slots:
+    void methodChanged(int index);
+
+  signals:
+    void optionsChanged();
+
+  private:
+    Ui::BinarizeDialog *ui;
+};
+
+#endif  // DIALOGS_BINARIZEDIALOG_H_
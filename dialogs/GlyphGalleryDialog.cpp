@@ -0,0 +1,76 @@
+/**********************************************************************
+* File:        GlyphGalleryDialog.cpp
+* Description: Thumbnails of all instances of one letter
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "dialogs/GlyphGalleryDialog.h"
+#include "ui_GlyphGalleryDialog.h"
+
+namespace {
+
+// Space around thumbnail in grid
+const int kSpacing = 8;
+
+}  // namespace
+
+GlyphGalleryDialog::GlyphGalleryDialog(QWidget* parent) :
+    QDialog(parent),
+    ui(new Ui::GlyphGalleryDialog) {
+    ui->setupUi(this);
+    model = new GlyphGalleryModel(this);
+
+    // fixed grid without per item size hints keeps layout cheap for
+    // tens of thousands of thumbnails
+    const int size = GlyphGalleryModel::kThumbnailSize;
+    ui->galleryView->setViewMode(QListView::IconMode);
+    ui->galleryView->setMovement(QListView::Static);
+    ui->galleryView->setResizeMode(QListView::Adjust);
+    ui->galleryView->setUniformItemSizes(true);
+    ui->galleryView->setLayoutMode(QListView::Batched);
+    ui->galleryView->setBatchSize(1000);
+    ui->galleryView->setIconSize(QSize(size, size));
+    ui->galleryView->setGridSize(QSize(size + kSpacing, size + kSpacing));
+    ui->galleryView->setModel(model);
+    connect(ui->galleryView, SIGNAL(clicked(QModelIndex)),
+            this, SLOT(itemActivated(QModelIndex)));
+    connect(ui->galleryView, SIGNAL(activated(QModelIndex)),
+            this, SLOT(itemActivated(QModelIndex)));
+}
+
+GlyphGalleryDialog::~GlyphGalleryDialog() {
+    delete ui;
+}
+
+void GlyphGalleryDialog::setGlyphs(
+        const QString& letter, const QString& imageFile,
+        const QHash<int, PageImagePtr>& loaded,
+        const QVector<GlyphGalleryModel::Item>& items) {
+    setWindowTitle(tr("Instances of '%1'").arg(letter));
+    ui->summaryLabel->setText(tr("%n box(es)", "", items.size()));
+    model->setItems(imageFile, loaded, items);
+    ui->galleryView->scrollToTop();
+}
+
+void GlyphGalleryDialog::itemActivated(const QModelIndex& index) {
+    if (!index.isValid())
+        return;
+    const GlyphGalleryModel::Item& item = model->item(index.row());
+    emit glyphActivated(item.page, item.row);
+}
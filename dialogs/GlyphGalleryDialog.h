@@ -0,0 +1,63 @@
+/**********************************************************************
+* File:        GlyphGalleryDialog.h
+* Description: Thumbnails of all instances of one letter
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef DIALOGS_GLYPHGALLERYDIALOG_H_
+#define DIALOGS_GLYPHGALLERYDIALOG_H_
+
+#include <QDialog>
+#include <QHash>
+#include <QModelIndex>
+#include <QVector>
+
+#include "GlyphGalleryModel.h"
+
+namespace Ui {
+    class GlyphGalleryDialog;
+}
+
+/**
+ * Non-modal grid with thumbnails of boxes (e.g. all instances of letter
+ * selected in statistics). Clicking a thumbnail asks editor to show the box.
+ */
+class GlyphGalleryDialog : public QDialog {
+  Q_OBJECT
+
+  public:
+    explicit GlyphGalleryDialog(QWidget* parent = 0);
+    ~GlyphGalleryDialog();
+
+    void setGlyphs(const QString& letter, const QString& imageFile,
+                   const QHash<int, PageImagePtr>& loaded,
+                   const QVector<GlyphGalleryModel::Item>& items);
+
+  private slots:
+    void itemActivated(const QModelIndex& index);
+
+  signals:
+    void glyphActivated(int page, int row);
+
+  private:
+    Ui::GlyphGalleryDialog *ui;
+    GlyphGalleryModel* model;
+};
+
+#endif  // DIALOGS_GLYPHGALLERYDIALOG_H_
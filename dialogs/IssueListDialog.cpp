@@ -0,0 +1,73 @@
+/**********************************************************************
+* File:        IssueListDialog.cpp
+* Description: List of problems found in document
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "dialogs/IssueListDialog.h"
+#include "ui_IssueListDialog.h"
+
+namespace {
+
+// Item data roles with position of box
+const int kPageRole = Qt::UserRole;
+const int kRowRole = Qt::UserRole + 1;
+
+}  // namespace
+
+IssueListDialog::IssueListDialog(QWidget* parent) :
+    QDialog(parent),
+    ui(new Ui::IssueListDialog) {
+    ui->setupUi(this);
+    ui->issueTree->setRootIsDecorated(false);
+    ui->issueTree->setUniformRowHeights(true);
+    connect(ui->issueTree, SIGNAL(itemActivated(QTreeWidgetItem*, int)),
+            this, SLOT(itemActivated(QTreeWidgetItem*, int)));
+}
+
+IssueListDialog::~IssueListDialog() {
+    delete ui;
+}
+
+void IssueListDialog::clear() {
+    ui->issueTree->clear();
+    ui->summaryLabel->clear();
+}
+
+void IssueListDialog::addIssue(int page, int row, const QString& letter,
+                               const QString& category,
+                               const QString& message) {
+    QTreeWidgetItem* item = new QTreeWidgetItem(ui->issueTree);
+    item->setText(0, QString::number(page + 1));
+    item->setText(1, QString::number(row + 1));
+    item->setText(2, letter);
+    item->setText(3, category);
+    item->setText(4, message);
+    item->setData(0, kPageRole, page);
+    item->setData(0, kRowRole, row);
+}
+
+void IssueListDialog::setSummary(const QString& summary) {
+    ui->summaryLabel->setText(summary);
+}
+
+void IssueListDialog::itemActivated(QTreeWidgetItem* item, int /*column*/) {
+    emit issueActivated(item->data(0, kPageRole).toInt(),
+                        item->data(0, kRowRole).toInt());
+}
@@ -0,0 +1,61 @@
+/**********************************************************************
+* File:        IssueListDialog.h
+* Description: List of problems found in document
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef DIALOGS_ISSUELISTDIALOG_H_
+#define DIALOGS_ISSUELISTDIALOG_H_
+
+#include <QDialog>
+
+namespace Ui {
+    class IssueListDialog;
+}
+
+class QTreeWidgetItem;
+
+/**
+ * Non-modal list of problems found in document (validation, suspicious
+ * labels...). Activating an entry asks editor to show the box.
+ */
+class IssueListDialog : public QDialog {
+  Q_OBJECT
+
+  public:
+    explicit IssueListDialog(QWidget* parent = 0);
+    ~IssueListDialog();
+
+    void clear();
+    /** Add entry; page and row are 0-based. */
+    void addIssue(int page, int row, const QString& letter,
+                  const QString& category, const QString& message);
+    void setSummary(const QString& summary);
+
+  private slots:
+    void itemActivated(QTreeWidgetItem* item, int column);
+
+  signals:
+    void issueActivated(int page, int row);
+
+  private:
+    Ui::IssueListDialog *ui;
+};
+
+#endif  // DIALOGS_ISSUELISTDIALOG_H_
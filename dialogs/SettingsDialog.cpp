@@ -209,6 +209,7 @@ void SettingsDialog::initSettings() {
   if (settings.contains("Tesseract/DataPath")) {
     lnPrefix->setText(settings.value("Tesseract/DataPath").toString());
   }
+  sbTimeLimit->setValue(settings.value("Tesseract/TimeLimit", 0).toInt());
 }
 
 void SettingsDialog::saveSettings() {
@@ -254,6 +255,7 @@ void SettingsDialog::saveSettings() {
   settings.setValue("Text/Ligatures", str);
 
   settings.setValue("Tesseract/DataPath", lnPrefix->text());
+  settings.setValue("Tesseract/TimeLimit", sbTimeLimit->value());
   if (!cbLang->itemData(cbLang->currentIndex()).isNull())
       settings.setValue("Tesseract/Lang",
                     cbLang->itemData(cbLang->currentIndex()).toString());
@@ -12,6 +12,7 @@ INCLUDEPATH += ./ \
     src
 
 QT += network svg
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
 #QT += testlib
 
 #CONFIG += debug warn_on
@@ -29,31 +30,98 @@ FORMS += \
     dialogs/SettingsDialog.ui \
     dialogs/FindDialog.ui \
     dialogs/DrawRectangle.ui \
-    dialogs/StatisticsDialog.ui
+    dialogs/StatisticsDialog.ui \
+    dialogs/BinarizeDialog.ui \
+    dialogs/IssueListDialog.ui \
+    dialogs/GlyphGalleryDialog.ui
 
 SOURCES += src/main.cpp \
     src/MainWindow.cpp \
     src/ChildWidget.cpp \
     src/DelegateEditors.cpp \
     src/TessTools.cpp \
+    src/PageImage.cpp \
+    src/Binarizer.cpp \
+    src/Glyph.cpp \
+    src/FontSplitter.cpp \
+    src/GlyphImage.cpp \
+    src/TrainingExport.cpp \
+    src/TextExport.cpp \
+    src/BalloonItem.cpp \
+    src/SelectionTracker.cpp \
+    src/DocumentCache.cpp \
+    src/EditJournal.cpp \
+    src/GlyphDiff.cpp \
+    src/ComponentIndex.cpp \
+    src/BoxTightener.cpp \
+    src/BoxValidator.cpp \
+    src/PageStructure.cpp \
+    src/DocumentMemoryManager.cpp \
+    src/BoxRecognizer.cpp \
+    src/Instrumentation.cpp \
+    src/LabelChecker.cpp \
+    src/ShapeIndex.cpp \
+    src/GlyphGalleryModel.cpp \
+    src/BilevelImageItem.cpp \
+    src/WorkspaceIndex.cpp \
+    src/WorkspaceDock.cpp \
+    src/JobScheduler.cpp \
+    src/JobsDock.cpp \
+    src/RecognitionJob.cpp \
     dialogs/SettingsDialog.cpp \
     dialogs/GetRowIDDialog.cpp \
     dialogs/ShortCutsDialog.cpp \
     dialogs/FindDialog.cpp \
     dialogs/DrawRectangle.cpp \
-    dialogs/Statistics.cpp
+    dialogs/Statistics.cpp \
+    dialogs/BinarizeDialog.cpp \
+    dialogs/IssueListDialog.cpp \
+    dialogs/GlyphGalleryDialog.cpp
 
 HEADERS += src/MainWindow.h \
     src/ChildWidget.h \
     src/Settings.h \
     src/TessTools.h \
+    src/PageImage.h \
+    src/PageRunner.h \
+    src/Binarizer.h \
+    src/Glyph.h \
+    src/FontSplitter.h \
+    src/GlyphImage.h \
+    src/TrainingExport.h \
+    src/TextExport.h \
+    src/BalloonItem.h \
+    src/SelectionTracker.h \
+    src/DocumentCache.h \
+    src/EditJournal.h \
+    src/GlyphDiff.h \
+    src/ComponentIndex.h \
+    src/BoxTightener.h \
+    src/BoxValidator.h \
+    src/PageStructure.h \
+    src/DocumentMemoryManager.h \
+    src/BoxRecognizer.h \
+    src/Instrumentation.h \
+    src/LabelChecker.h \
+    src/ShapeIndex.h \
+    src/GlyphGalleryModel.h \
+    src/BilevelImageItem.h \
+    src/WorkspaceIndex.h \
+    src/WorkspaceDock.h \
+    src/CancelToken.h \
+    src/JobScheduler.h \
+    src/JobsDock.h \
+    src/RecognitionJob.h \
     src/DelegateEditors.h \
     dialogs/SettingsDialog.h \
     dialogs/GetRowIDDialog.h \
     dialogs/ShortCutsDialog.h \
     dialogs/FindDialog.h \
     dialogs/DrawRectangle.h \
-    dialogs/Statistics.h
+    dialogs/Statistics.h \
+    dialogs/BinarizeDialog.h \
+    dialogs/IssueListDialog.h \
+    dialogs/GlyphGalleryDialog.h
 
 RESOURCES = resources/application.qrc \
     resources/QBE-GNOME.qrc \
@@ -0,0 +1,115 @@
+/**********************************************************************
+* File:        BalloonItem.cpp
+* Description: Overlay with symbols displayed above boxes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "BalloonItem.h"
+
+#include <QFontMetricsF>
+#include <QPainter>
+
+namespace {
+
+// QGraphicsTextItem places text inside document margin; keep the same
+// position of symbols as before
+const qreal kTextMargin = 4;
+
+}  // namespace
+
+BalloonItem::BalloonItem(QGraphicsItem* parent)
+    : QGraphicsItem(parent), m_color(Qt::red), m_count(0) {
+    setZValue(4);
+    setAcceptedMouseButtons(Qt::NoButton);
+    m_fontKey = m_font.key();
+}
+
+void BalloonItem::setFont(const QFont& font) {
+    if (font == m_font)
+        return;
+    m_font = font;
+    m_fontKey = font.key();
+    clear();
+}
+
+void BalloonItem::setColor(const QColor& color) {
+    m_color = color;
+    update();
+}
+
+void BalloonItem::clear() {
+    if (m_count == 0)
+        return;
+    prepareGeometryChange();
+    m_count = 0;
+    m_bounds = QRectF();
+}
+
+const QPainterPath& BalloonItem::outline(const QString& letter) {
+    QPair<QString, QString> key(letter, m_fontKey);
+    QHash<QPair<QString, QString>, QPainterPath>::iterator it =
+            m_cache.find(key);
+    if (it == m_cache.end()) {
+        QPainterPath path;
+        QFontMetricsF metrics(m_font);
+        path.addText(QPointF(kTextMargin, kTextMargin + metrics.ascent()),
+                     m_font, letter);
+        it = m_cache.insert(key, path);
+    }
+    return it.value();
+}
+
+void BalloonItem::addSymbol(const QString& letter, const QPointF& pos) {
+    prepareGeometryChange();
+    if (m_count == m_symbols.size())
+        m_symbols.resize(m_count + 1);
+    Symbol& symbol = m_symbols[m_count++];
+    symbol.path = outline(letter);  // implicitly shared with cache
+    symbol.pos = pos;
+    m_bounds |= symbol.path.boundingRect().translated(pos).adjusted(
+                -haloShift, -haloShift, haloShift, haloShift);
+}
+
+QRectF BalloonItem::boundingRect() const {
+    return m_bounds;
+}
+
+void BalloonItem::paint(QPainter* painter,
+                        const QStyleOptionGraphicsItem* /*option*/,
+                        QWidget* /*widget*/) {
+    if (m_count == 0)
+        return;
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    // halo: white outline around symbol
+    QPen haloPen(Qt::white, 2 * haloShift, Qt::SolidLine, Qt::RoundCap,
+                 Qt::RoundJoin);
+    // all halos first, so they never cover neighbouring symbol
+    for (int i = 0; i < m_count; ++i) {
+        painter->translate(m_symbols[i].pos);
+        painter->strokePath(m_symbols[i].path, haloPen);
+        painter->translate(-m_symbols[i].pos);
+    }
+    for (int i = 0; i < m_count; ++i) {
+        painter->translate(m_symbols[i].pos);
+        painter->fillPath(m_symbols[i].path, m_color);
+        painter->translate(-m_symbols[i].pos);
+    }
+    painter->restore();
+}
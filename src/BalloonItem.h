@@ -0,0 +1,81 @@
+/**********************************************************************
+* File:        BalloonItem.h
+* Description: Overlay with symbols displayed above boxes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_BALLOONITEM_H_
+#define SRC_BALLOONITEM_H_
+
+#include <QColor>
+#include <QFont>
+#include <QGraphicsItem>
+#include <QHash>
+#include <QPainterPath>
+#include <QPair>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+/**
+ * Overhead symbols displayed in Show symbol mode.
+ * One scene item draws all symbols with their white halo. Outlines of
+ * symbols are cached by (letter, font), so changing selection only
+ * updates positions and does not create new objects.
+ */
+class BalloonItem : public QGraphicsItem {
+  public:
+    // TODO(all): Temp const, to be replaced by user-adjusted setting
+    static const int haloShift = 2;
+
+    explicit BalloonItem(QGraphicsItem* parent = 0);
+
+    void setFont(const QFont& font);
+    void setColor(const QColor& color);
+
+    /** Remove all symbols (cached outlines are kept). */
+    void clear();
+    /** Add symbol; pos is top left corner of text (as QGraphicsTextItem). */
+    void addSymbol(const QString& letter, const QPointF& pos);
+    int symbolCount() const {
+        return m_count;
+    }
+
+    QRectF boundingRect() const;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+               QWidget* widget = 0);
+
+  private:
+    struct Symbol {
+        QPainterPath path;
+        QPointF pos;
+    };
+
+    const QPainterPath& outline(const QString& letter);
+
+    QFont m_font;
+    QString m_fontKey;
+    QColor m_color;
+    QHash<QPair<QString, QString>, QPainterPath> m_cache;
+    QVector<Symbol> m_symbols;  /**< never shrinks, first m_count used */
+    int m_count;
+    QRectF m_bounds;
+};
+
+#endif  // SRC_BALLOONITEM_H_
@@ -0,0 +1,214 @@
+/**********************************************************************
+* File:        BilevelImageItem.cpp
+* Description: Scene item displaying packed 1 bpp page image
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "BilevelImageItem.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QVector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif  // __SSE2__
+
+namespace {
+
+// Side of tile in pixels of its level
+const int kTileSize = 256;
+// Coarsest level reduces 16x16 pixels to one
+const int kMaxLevel = 4;
+// Cached tiles (kB); 1:1 tiles of two full HD screens
+const int kCacheCost = 24 * 1024;
+
+struct BitCountTable {
+    uchar v[256];
+    BitCountTable() {
+        for (int i = 0; i < 256; ++i) {
+            int count = 0;
+            for (int b = 0; b < 8; ++b)
+                if (i & (1 << b))
+                    ++count;
+            v[i] = count;
+        }
+    }
+};
+const BitCountTable kBitCount;
+
+/*
+ * Expand width pixels of packed row (first pixel in MSB) to 32 bpp
+ */
+void expandRow(const uchar* bits, int width, QRgb color0, QRgb color1,
+               QRgb* dst) {
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i c0 = _mm_set1_epi32(static_cast<int>(color0));
+    const __m128i c1 = _mm_set1_epi32(static_cast<int>(color1));
+    const __m128i high = _mm_setr_epi32(0x80, 0x40, 0x20, 0x10);
+    const __m128i low = _mm_setr_epi32(0x08, 0x04, 0x02, 0x01);
+    for (; x + 8 <= width; x += 8) {
+        __m128i byte = _mm_set1_epi32(bits[x >> 3]);
+        __m128i set = _mm_cmpeq_epi32(_mm_and_si128(byte, high), high);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                         _mm_or_si128(_mm_and_si128(set, c1),
+                                      _mm_andnot_si128(set, c0)));
+        set = _mm_cmpeq_epi32(_mm_and_si128(byte, low), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 4),
+                         _mm_or_si128(_mm_and_si128(set, c1),
+                                      _mm_andnot_si128(set, c0)));
+    }
+#endif  // __SSE2__
+    for (; x < width; ++x)
+        dst[x] = ((bits[x >> 3] >> (7 - (x & 7))) & 1) ? color1 : color0;
+}
+
+inline QRgb mix(QRgb color0, QRgb color1, int share, int total) {
+    int rest = total - share;
+    return qRgb((qRed(color0) * rest + qRed(color1) * share) / total,
+                (qGreen(color0) * rest + qGreen(color1) * share) / total,
+                (qBlue(color0) * rest + qBlue(color1) * share) / total);
+}
+
+}  // namespace
+
+BilevelImageItem::BilevelImageItem(const QImage& image, QGraphicsItem* parent)
+    : QGraphicsItem(parent), m_tiles(kCacheCost) {
+    m_image = image.format() == QImage::Format_Mono
+            ? image : image.convertToFormat(QImage::Format_Mono);
+    if (m_image.colorCount() >= 2) {
+        m_colors[0] = m_image.color(0) | 0xff000000;
+        m_colors[1] = m_image.color(1) | 0xff000000;
+    } else {
+        m_colors[0] = qRgb(255, 255, 255);
+        m_colors[1] = qRgb(0, 0, 0);
+    }
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+}
+
+qint64 BilevelImageItem::memoryUsage() const {
+    return qint64(m_tiles.totalCost()) * 1024;
+}
+
+QRectF BilevelImageItem::boundingRect() const {
+    return QRectF(0, 0, m_image.width(), m_image.height());
+}
+
+QImage BilevelImageItem::expand(const QImage& mono, const QRect& rect) {
+    QRect r = rect.intersected(mono.rect());
+    QImage result(r.size(), QImage::Format_RGB32);
+    if (r.isEmpty())
+        return result;
+    QRgb color0 = qRgb(255, 255, 255);
+    QRgb color1 = qRgb(0, 0, 0);
+    if (mono.colorCount() >= 2) {
+        color0 = mono.color(0) | 0xff000000;
+        color1 = mono.color(1) | 0xff000000;
+    }
+    for (int y = 0; y < r.height(); ++y)
+        expandRow(mono.constScanLine(r.top() + y) + (r.left() >> 3),
+                  r.width(), color0, color1,
+                  reinterpret_cast<QRgb*>(result.scanLine(y)));
+    return result;
+}
+
+/*
+ * Tile of level is reduced 2^level times: every output pixel gets color
+ * mixed by share of index 1 pixels in its block
+ */
+QImage BilevelImageItem::renderTile(int level, int tileX, int tileY) const {
+    const int span = kTileSize << level;
+    QRect source = QRect(tileX * span, tileY * span, span, span)
+                   .intersected(m_image.rect());
+    if (level == 0)
+        return expand(m_image, source);
+
+    const int factor = 1 << level;
+    const int width = (source.width() + factor - 1) >> level;
+    const int height = (source.height() + factor - 1) >> level;
+    QImage tile(width, height, QImage::Format_RGB32);
+    QVector<int> counts(width);
+    const int firstByte = source.left() >> 3;
+    const int bytes = (source.width() + 7) >> 3;
+    for (int y = 0; y < height; ++y) {
+        counts.fill(0);
+        int* count = counts.data();
+        int rows = qMin(factor, source.height() - (y << level));
+        for (int i = 0; i < rows; ++i) {
+            const uchar* bits = m_image.constScanLine(
+                        source.top() + (y << level) + i) + firstByte;
+            if (level >= 3) {
+                // whole bytes belong to one block
+                for (int b = 0; b < bytes; ++b)
+                    count[(b << 3) >> level] += kBitCount.v[bits[b]];
+            } else {
+                for (int x = 0; x < source.width(); ++x)
+                    count[x >> level] += (bits[x >> 3] >> (7 - (x & 7))) & 1;
+            }
+        }
+        // padding bits of last byte are not reliable
+        QRgb* dst = reinterpret_cast<QRgb*>(tile.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            int columns = qMin(factor, source.width() - (x << level));
+            int total = rows * columns;
+            dst[x] = mix(m_colors[0], m_colors[1],
+                         qMin(count[x], total), total);
+        }
+    }
+    return tile;
+}
+
+void BilevelImageItem::paint(QPainter* painter,
+                             const QStyleOptionGraphicsItem* option,
+                             QWidget* widget) {
+    Q_UNUSED(widget);
+    qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+                painter->worldTransform());
+    int level = 0;
+    while (level < kMaxLevel && scale * (2 << level) <= 1.0)
+        ++level;
+
+    const int span = kTileSize << level;
+    QRect exposed = option->exposedRect.toAlignedRect()
+                    .intersected(m_image.rect());
+    if (exposed.isEmpty())
+        return;
+    for (int ty = exposed.top() / span; ty <= exposed.bottom() / span;
+         ++ty) {
+        for (int tx = exposed.left() / span; tx <= exposed.right() / span;
+             ++tx) {
+            quint32 key = (quint32(level) << 28) | (quint32(ty) << 14) |
+                          quint32(tx);
+            QPixmap* pixmap = m_tiles.object(key);
+            if (!pixmap) {
+                pixmap = new QPixmap(QPixmap::fromImage(
+                                         renderTile(level, tx, ty)));
+                int cost = qMax(1, pixmap->width() * pixmap->height() / 256);
+                // tile is deleted if it is larger than cache
+                if (!m_tiles.insert(key, pixmap, cost))
+                    continue;
+            }
+            QRectF target(tx * span, ty * span,
+                          qMin(span, m_image.width() - tx * span),
+                          qMin(span, m_image.height() - ty * span));
+            painter->drawPixmap(target, *pixmap, QRectF(pixmap->rect()));
+        }
+    }
+}
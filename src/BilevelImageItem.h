@@ -0,0 +1,74 @@
+/**********************************************************************
+* File:        BilevelImageItem.h
+* Description: Scene item displaying packed 1 bpp page image
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_BILEVELIMAGEITEM_H_
+#define SRC_BILEVELIMAGEITEM_H_
+
+#include <QCache>
+#include <QGraphicsItem>
+#include <QImage>
+#include <QPixmap>
+
+/**
+ * Scene item showing bilevel (1 bpp) page image without expanding whole
+ * page to display format.
+ * Page stays packed in memory; only tiles touched by exposed area are
+ * expanded to 32 bpp pixmaps (SSE2 bit expansion when available) and kept
+ * in small LRU cache. When view is zoomed out, tiles are reduced straight
+ * from packed bits (share of black pixels gives gray level), so whole page
+ * never needs its full size pixmap.
+ */
+class BilevelImageItem : public QGraphicsItem {
+  public:
+    enum { Type = UserType + 1 };
+
+    /** Item for mono image (converted to QImage::Format_Mono if needed). */
+    explicit BilevelImageItem(const QImage& image,
+                              QGraphicsItem* parent = 0);
+
+    QImage image() const {
+        return m_image;
+    }
+    /** Bytes of cached display tiles (packed image is shared with page). */
+    qint64 memoryUsage() const;
+
+    int type() const {
+        return Type;
+    }
+    QRectF boundingRect() const;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+               QWidget* widget = 0);
+
+    /** Expand rect of mono image to QImage::Format_RGB32. rect.left()
+     *  must be multiple of 8.
+     */
+    static QImage expand(const QImage& mono, const QRect& rect);
+
+  private:
+    QImage renderTile(int level, int tileX, int tileY) const;
+
+    QImage m_image;
+    QRgb m_colors[2];
+    QCache<quint32, QPixmap> m_tiles;  /**< cost in kB */
+};
+
+#endif  // SRC_BILEVELIMAGEITEM_H_
@@ -0,0 +1,431 @@
+/**********************************************************************
+* File:        Binarizer.cpp
+* Description: Native image binarization (Otsu, Sauvola, Niblack)
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "Binarizer.h"
+#include "PageImage.h"
+#include "Settings.h"
+#include "TessTools.h"
+
+#include <QObject>
+#include <QSettings>
+#include <QVector>
+#include <QtConcurrentMap>
+#include <qmath.h>
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Rows processed by one parallel task
+const int kStripeHeight = 64;
+
+// Sauvola dynamic range of standard deviation
+const float kSauvolaR = 128.0f;
+
+// QImage::Format_Mono stores first pixel in MSB, while _mm_movemask_epi8
+// puts first byte into LSB
+struct BitReverseTable {
+    uchar v[256];
+    BitReverseTable() {
+        for (int i = 0; i < 256; ++i) {
+            uchar r = 0;
+            for (int b = 0; b < 8; ++b)
+                if (i & (1 << b))
+                    r |= 0x80 >> b;
+            v[i] = r;
+        }
+    }
+};
+const BitReverseTable kBitReverse;
+
+/*
+ * Pack one row to 1 bpp: pixel is black (1) if gray <= threshold
+ */
+void packRow(const uchar* gray, const uchar* thr, uchar* mono, int width) {
+    int x = 0;
+#ifdef __SSE2__
+    for (; x + 16 <= width; x += 16) {
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gray + x));
+        __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(thr + x));
+        __m128i black = _mm_cmpeq_epi8(_mm_min_epu8(g, t), g);
+        int mask = _mm_movemask_epi8(black);
+        mono[x >> 3] = kBitReverse.v[mask & 0xff];
+        mono[(x >> 3) + 1] = kBitReverse.v[(mask >> 8) & 0xff];
+    }
+#endif
+    for (; x < width; x += 8) {
+        uchar byte = 0;
+        for (int b = 0; b < 8 && x + b < width; ++b)
+            if (gray[x + b] <= thr[x + b])
+                byte |= 0x80 >> b;
+        mono[x >> 3] = byte;
+    }
+}
+
+inline uchar clampThreshold(float t) {
+    if (t <= 0.0f)
+        return 0;
+    if (t >= 255.0f)
+        return 255;
+    return static_cast<uchar>(t);
+}
+
+struct Stripe {
+    int y0;
+    int y1;
+};
+
+/*
+ * Binarize one stripe of rows. Local sums of adaptive methods come from
+ * running column sums over the window height and their row prefix sums
+ * (integral image of the current window band), so memory stays O(width).
+ * Unsigned 32 bit arithmetic is exact for window up to 255x255: only
+ * differences of prefix sums are used and they fit into 32 bits.
+ */
+class StripeBinarizer {
+  public:
+    typedef void result_type;
+
+    StripeBinarizer(const QImage& gray, QImage* mono,
+                    const Binarizer::Options& options, int threshold,
+                    const CancelToken& cancel)
+        : m_gray(gray.constBits()), m_grayBpl(gray.bytesPerLine()),
+          m_mono(mono->bits()), m_monoBpl(mono->bytesPerLine()),
+          m_width(gray.width()), m_height(gray.height()),
+          m_options(options), m_threshold(threshold), m_cancel(cancel) {
+    }
+
+    void operator()(const Stripe& stripe) const {
+        if (m_cancel.isCancelled())
+            return;
+        QVector<uchar> thr(m_width + 16);
+        if (m_options.method == Binarizer::Otsu) {
+            thr.fill(static_cast<uchar>(m_threshold));
+            for (int y = stripe.y0; y < stripe.y1; ++y)
+                packRow(grayRow(y), thr.constData(), monoRow(y), m_width);
+            return;
+        }
+
+        int r = m_options.windowSize / 2;
+        QVector<quint32> colSum(m_width, 0);
+        QVector<quint32> colSq(m_width, 0);
+        QVector<quint32> prefixSum(m_width + 1, 0);
+        QVector<quint32> prefixSq(m_width + 1, 0);
+
+        int top = qMax(0, stripe.y0 - r);
+        int bottom = qMin(m_height, stripe.y0 + r + 1);  // exclusive
+        for (int y = top; y < bottom; ++y)
+            addRow(y, colSum.data(), colSq.data(), 1);
+
+        for (int y = stripe.y0; y < stripe.y1; ++y) {
+            // slide window band down to rows <y - r, y + r>
+            int newTop = qMax(0, y - r);
+            int newBottom = qMin(m_height, y + r + 1);
+            for (; top < newTop; ++top)
+                addRow(top, colSum.data(), colSq.data(), -1);
+            for (; bottom < newBottom; ++bottom)
+                addRow(bottom, colSum.data(), colSq.data(), 1);
+
+            quint32* ps = prefixSum.data();
+            quint32* pq = prefixSq.data();
+            for (int x = 0; x < m_width; ++x) {
+                ps[x + 1] = ps[x] + colSum[x];
+                pq[x + 1] = pq[x] + colSq[x];
+            }
+            rowThresholds(ps, pq, bottom - top, r, thr.data());
+            packRow(grayRow(y), thr.constData(), monoRow(y), m_width);
+        }
+    }
+
+  private:
+    const uchar* grayRow(int y) const {
+        return m_gray + y * m_grayBpl;
+    }
+    uchar* monoRow(int y) const {
+        return m_mono + y * m_monoBpl;
+    }
+
+    void addRow(int y, quint32* colSum, quint32* colSq, int sign) const {
+        const uchar* row = grayRow(y);
+        if (sign > 0) {
+            for (int x = 0; x < m_width; ++x) {
+                colSum[x] += row[x];
+                colSq[x] += row[x] * row[x];
+            }
+        } else {
+            for (int x = 0; x < m_width; ++x) {
+                colSum[x] -= row[x];
+                colSq[x] -= row[x] * row[x];
+            }
+        }
+    }
+
+    float localThreshold(float mean, float sd) const {
+        if (m_options.method == Binarizer::Sauvola)
+            return mean * (1.0f + m_options.k * (sd / kSauvolaR - 1.0f));
+        return mean + m_options.k * sd;  // Niblack
+    }
+
+    void scalarThreshold(const quint32* ps, const quint32* pq, int rows,
+                         int r, int x, uchar* thr) const {
+        int x0 = qMax(0, x - r);
+        int x1 = qMin(m_width, x + r + 1);
+        float n = static_cast<float>((x1 - x0) * rows);
+        float mean = (ps[x1] - ps[x0]) / n;
+        float sq = (pq[x1] - pq[x0]) / n;
+        float var = qMax(0.0f, sq - mean * mean);
+        thr[x] = clampThreshold(localThreshold(mean, qSqrt(var)));
+    }
+
+    void rowThresholds(const quint32* ps, const quint32* pq, int rows, int r,
+                       uchar* thr) const {
+        // Columns where window is not clipped by left/right border
+        int first = qMin(r, m_width);
+        int last = qMax(first, m_width - r - 1);  // exclusive
+
+        for (int x = 0; x < first; ++x)
+            scalarThreshold(ps, pq, rows, r, x, thr);
+
+        int x = first;
+#ifdef __SSE2__
+        const float invN = 1.0f / ((2 * r + 1) * rows);
+        const __m128 vInvN = _mm_set1_ps(invN);
+        const __m128 vInvN2 = _mm_set1_ps(2.0f * invN);
+        const __m128 vZero = _mm_setzero_ps();
+        const __m128 vMax = _mm_set1_ps(255.0f);
+        const __m128 vK = _mm_set1_ps(static_cast<float>(m_options.k));
+        const __m128 vOne = _mm_set1_ps(1.0f);
+        const __m128 vInvR = _mm_set1_ps(1.0f / kSauvolaR);
+        const bool sauvola = (m_options.method == Binarizer::Sauvola);
+        for (; x + 4 <= last; x += 4) {
+            __m128i sHi = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(ps + x + r + 1));
+            __m128i sLo = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(ps + x - r));
+            __m128i qHi = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(pq + x + r + 1));
+            __m128i qLo = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(pq + x - r));
+            __m128i s = _mm_sub_epi32(sHi, sLo);
+            // sum of squares may exceed INT_MAX: convert half of it
+            __m128i q = _mm_srli_epi32(_mm_sub_epi32(qHi, qLo), 1);
+
+            __m128 mean = _mm_mul_ps(_mm_cvtepi32_ps(s), vInvN);
+            __m128 sq = _mm_mul_ps(_mm_cvtepi32_ps(q), vInvN2);
+            __m128 var = _mm_max_ps(_mm_sub_ps(sq, _mm_mul_ps(mean, mean)),
+                                    vZero);
+            __m128 sd = _mm_sqrt_ps(var);
+            __m128 t;
+            if (sauvola) {
+                t = _mm_mul_ps(mean, _mm_add_ps(vOne, _mm_mul_ps(vK,
+                        _mm_sub_ps(_mm_mul_ps(sd, vInvR), vOne))));
+            } else {
+                t = _mm_add_ps(mean, _mm_mul_ps(vK, sd));
+            }
+            t = _mm_min_ps(_mm_max_ps(t, vZero), vMax);
+            __m128i ti = _mm_cvttps_epi32(t);
+            ti = _mm_packs_epi32(ti, ti);
+            ti = _mm_packus_epi16(ti, ti);
+            int packed = _mm_cvtsi128_si32(ti);
+            memcpy(thr + x, &packed, 4);
+        }
+#endif
+        for (; x < m_width; ++x)
+            scalarThreshold(ps, pq, rows, r, x, thr);
+    }
+
+    const uchar* m_gray;
+    int m_grayBpl;
+    uchar* m_mono;
+    int m_monoBpl;
+    int m_width;
+    int m_height;
+    Binarizer::Options m_options;
+    int m_threshold;
+    CancelToken m_cancel;
+};
+
+/*
+ * Tesseract thresholding; null image (and error) if engine is not
+ * available
+ */
+QImage thresholdByTesseract(const QImage& image, QString* error) {
+    QString message;
+    QImage result = TessTools::GetThresholded(image, &message);
+    if (result.isNull() && error)
+        *error = message;
+    return result;
+}
+
+}  // namespace
+
+Binarizer::Options::Options()
+    : method(Otsu), windowSize(31), k(0.34) {
+}
+
+Binarizer::Options Binarizer::Options::fromSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    Options options;
+    if (settings.contains("Binarize/Method"))
+        options.method = static_cast<Method>(
+                    settings.value("Binarize/Method").toInt());
+    if (settings.contains("Binarize/WindowSize"))
+        options.windowSize = settings.value("Binarize/WindowSize").toInt();
+    if (settings.contains("Binarize/K"))
+        options.k = settings.value("Binarize/K").toDouble();
+
+    // keep window odd and inside range where 32 bit sums are exact
+    options.windowSize = qBound(3, options.windowSize | 1, 255);
+    return options;
+}
+
+void Binarizer::Options::save() const {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    settings.setValue("Binarize/Method", static_cast<int>(method));
+    settings.setValue("Binarize/WindowSize", windowSize);
+    settings.setValue("Binarize/K", k);
+}
+
+QStringList Binarizer::methodNames() {
+    QStringList names;
+    names << QObject::tr("Tesseract (Otsu)")
+          << QObject::tr("Otsu (global)")
+          << QObject::tr("Sauvola (adaptive)")
+          << QObject::tr("Niblack (adaptive)");
+    return names;
+}
+
+int Binarizer::otsuThreshold(const QImage& gray) {
+    // four partial histograms break dependency on repeated values
+    QVector<quint32> hist(4 * 256, 0);
+    quint32* h = hist.data();
+    for (int y = 0; y < gray.height(); ++y) {
+        const uchar* row = gray.constScanLine(y);
+        int x = 0;
+        for (; x + 4 <= gray.width(); x += 4) {
+            h[row[x]]++;
+            h[256 + row[x + 1]]++;
+            h[512 + row[x + 2]]++;
+            h[768 + row[x + 3]]++;
+        }
+        for (; x < gray.width(); ++x)
+            h[row[x]]++;
+    }
+    for (int i = 0; i < 256; ++i)
+        h[i] += h[256 + i] + h[512 + i] + h[768 + i];
+
+    double total = static_cast<double>(gray.width()) * gray.height();
+    double sum = 0;
+    for (int i = 0; i < 256; ++i)
+        sum += static_cast<double>(i) * h[i];
+
+    double sumB = 0;
+    double wB = 0;
+    double best = -1;
+    int threshold = 0;
+    for (int t = 0; t < 256; ++t) {
+        wB += h[t];
+        if (wB == 0)
+            continue;
+        double wF = total - wB;
+        if (wF == 0)
+            break;
+        sumB += static_cast<double>(t) * h[t];
+        double mB = sumB / wB;
+        double mF = (sum - sumB) / wF;
+        double between = wB * wF * (mB - mF) * (mB - mF);
+        if (between > best) {
+            best = between;
+            threshold = t;
+        }
+    }
+    return threshold;
+}
+
+QImage Binarizer::binarize(const PageImage& page, const Options& options,
+                           QString* error, const CancelToken& cancel) {
+    // bilevel scan needs no threshold (and no 8 bpp copy), only index 1
+    // has to be black
+    if (page.isBilevel()) {
+        QImage mono = page.image();
+        if (PageImage::blackIndex(mono) == 0) {
+            mono.invertPixels();
+            mono.setColor(0, qRgb(255, 255, 255));
+            mono.setColor(1, qRgb(0, 0, 0));
+        }
+        return mono;
+    }
+    Options opts = options;
+    if (opts.method == Tesseract) {
+        QImage result = thresholdByTesseract(page.image(), error);
+        if (!result.isNull())
+            return result;
+        opts.method = Otsu;
+    }
+    if (cancel.isCancelled())
+        return QImage();
+    return binarize(page.grayscale(), opts, error, cancel);
+}
+
+QImage Binarizer::binarize(const QImage& image, const Options& options,
+                           QString* error, const CancelToken& cancel) {
+    if (image.isNull() || cancel.isCancelled())
+        return QImage();
+    Options opts = options;
+    if (opts.method == Tesseract) {
+        QImage result = thresholdByTesseract(image, error);
+        if (!result.isNull())
+            return result;
+        opts.method = Otsu;
+    }
+
+    QImage gray = PageImage::toGrayscale(image);
+    QImage mono(gray.width(), gray.height(), QImage::Format_Mono);
+    QVector<QRgb> bwTable;
+    bwTable.append(qRgb(255, 255, 255));
+    bwTable.append(qRgb(0, 0, 0));
+    mono.setColorTable(bwTable);
+    mono.setDotsPerMeterX(gray.dotsPerMeterX());
+    mono.setDotsPerMeterY(gray.dotsPerMeterY());
+
+    opts.windowSize = qBound(3, opts.windowSize | 1, 255);
+    int threshold = (opts.method == Otsu) ? otsuThreshold(gray) : 0;
+
+    QVector<Stripe> stripes;
+    for (int y = 0; y < gray.height(); y += kStripeHeight) {
+        Stripe stripe;
+        stripe.y0 = y;
+        stripe.y1 = qMin(gray.height(), y + kStripeHeight);
+        stripes.append(stripe);
+    }
+    QtConcurrent::blockingMap(stripes, StripeBinarizer(gray, &mono, opts,
+                                                       threshold, cancel));
+    if (cancel.isCancelled())
+        return QImage();
+    return mono;
+}
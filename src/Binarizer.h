@@ -0,0 +1,79 @@
+/**********************************************************************
+* File:        Binarizer.h
+* Description: Native image binarization (Otsu, Sauvola, Niblack)
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_BINARIZER_H_
+#define SRC_BINARIZER_H_
+
+#include <QImage>
+#include <QString>
+#include <QStringList>
+
+#include "CancelToken.h"
+
+class PageImage;
+
+/**
+ * Built-in binarization without tesseract engine.
+ * Global Otsu threshold and adaptive Sauvola/Niblack thresholds based on
+ * local mean and deviation from integral images. Image is processed in
+ * horizontal stripes in parallel; thresholding and bit packing of each
+ * row use SSE2 when available.
+ * Result is 1 bpp QImage::Format_Mono with index 1 = black.
+ */
+class Binarizer {
+  public:
+    enum Method {
+        Tesseract = 0,  /**< TessBaseAPI::GetThresholdedImage */
+        Otsu,
+        Sauvola,
+        Niblack
+    };
+
+    struct Options {
+        Options();
+        static Options fromSettings();
+        void save() const;
+
+        Method method;
+        int windowSize;  /**< side of local window (adaptive methods) */
+        double k;        /**< Sauvola/Niblack k parameter */
+    };
+
+    /** Binarize image of page (uses cached grayscale of page). If
+     *  tesseract thresholding fails, Otsu is used instead and error (if
+     *  given) tells why. Cancel is checked between stripes; cancelled
+     *  binarization returns null image.
+     */
+    static QImage binarize(const PageImage& page, const Options& options,
+                           QString* error = 0,
+                           const CancelToken& cancel = CancelToken());
+    /** Binarize any image (same fallback and cancel as above). */
+    static QImage binarize(const QImage& image, const Options& options,
+                           QString* error = 0,
+                           const CancelToken& cancel = CancelToken());
+    /** Global Otsu threshold of 8 bit grayscale image. */
+    static int otsuThreshold(const QImage& gray);
+
+    static QStringList methodNames();
+};
+
+#endif  // SRC_BINARIZER_H_
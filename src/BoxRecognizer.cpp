@@ -0,0 +1,167 @@
+/**********************************************************************
+* File:        BoxRecognizer.cpp
+* Description: Live recognition of single box by warm tesseract engine
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include <tesseract/baseapi.h>
+#include <tesseract/resultiterator.h>
+#include <leptonica/allheaders.h>
+
+#include "BoxRecognizer.h"
+#include "TessTools.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+namespace {
+
+// Number of alternatives reported for box
+const int kMaxChoices = 5;
+
+void recognizeRect(tesseract::TessBaseAPI* api,
+                   BoxRecognizer::Result* result) {
+    QElapsedTimer timer;
+    timer.start();
+    const QRect& rect = result->rect;
+    api->SetRectangle(rect.left(), rect.top(), rect.width(), rect.height());
+    if (api->Recognize(0) == 0) {
+        tesseract::ResultIterator* it = api->GetIterator();
+        if (it && !it->Empty(tesseract::RIL_SYMBOL)) {
+            tesseract::ChoiceIterator choice(*it);
+            do {
+                const char* text = choice.GetUTF8Text();
+                if (!text)
+                    continue;
+                BoxRecognizer::Choice item;
+                item.text = QString::fromUtf8(text);
+                item.confidence = choice.Confidence();
+                result->choices.append(item);
+            } while (result->choices.size() < kMaxChoices && choice.Next());
+        }
+        delete it;
+    }
+    result->elapsed = timer.elapsed();
+}
+
+}  // namespace
+
+BoxRecognizer::BoxRecognizer(QObject* parent)
+    : QThread(parent), m_stop(false), m_pageChanged(false),
+      m_pending(false), m_generation(0), m_row(-1) {
+    qRegisterMetaType<BoxRecognizer::Result>("BoxRecognizer::Result");
+}
+
+BoxRecognizer::~BoxRecognizer() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stop = true;
+        m_wake.wakeOne();
+    }
+    wait();
+}
+
+void BoxRecognizer::setPage(const PageImagePtr& page) {
+    QMutexLocker locker(&m_mutex);
+    if (page == m_page)
+        return;
+    m_page = page;
+    m_pageChanged = true;
+}
+
+void BoxRecognizer::recognize(int row, const QRect& rect) {
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_row = row;
+    m_rect = rect;
+    m_pending = true;
+    m_wake.wakeOne();
+}
+
+void BoxRecognizer::cancel() {
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_pending = false;
+}
+
+bool BoxRecognizer::isCurrent(const Result& result) {
+    QMutexLocker locker(&m_mutex);
+    return result.generation == m_generation;
+}
+
+void BoxRecognizer::run() {
+    tesseract::TessBaseAPI* api = 0;
+    PIX* pix = NULL;
+    PageImagePtr page;          // page not yet given to engine
+
+    forever {
+        QMutexLocker locker(&m_mutex);
+        while (!m_stop && !m_pending)
+            m_wake.wait(&m_mutex);
+        if (m_stop)
+            break;
+        if (m_pageChanged) {
+            page = m_page;
+            m_pageChanged = false;
+        }
+        Result result;
+        result.generation = m_generation;
+        result.row = m_row;
+        result.rect = m_rect;
+        result.elapsed = 0;
+        m_pending = false;
+        locker.unlock();
+
+        // failed init is tried again with next request (user may have
+        // fixed language or data path meanwhile)
+        if (!api) {
+            QString initError;
+            api = new tesseract::TessBaseAPI();
+            if (TessTools::initApi(api, &initError)) {
+                api->SetPageSegMode(tesseract::PSM_SINGLE_CHAR);
+            } else {
+                delete api;
+                api = 0;
+                result.error = initError;
+                emit recognized(result);
+                continue;
+            }
+        }
+        if (page) {
+            // engine keeps image, following requests only set rectangle
+            pixDestroy(&pix);
+            pix = TessTools::qImage2PIX(page->image());
+            api->SetImage(pix);
+            page.clear();
+        }
+        if (!pix) {
+            result.error = tr("No image to recognize.");
+            emit recognized(result);
+            continue;
+        }
+        recognizeRect(api, &result);
+        emit recognized(result);
+    }
+
+    if (api) {
+        api->End();
+        delete api;
+    }
+    pixDestroy(&pix);
+}
@@ -0,0 +1,95 @@
+/**********************************************************************
+* File:        BoxRecognizer.h
+* Description: Live recognition of single box by warm tesseract engine
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_BOXRECOGNIZER_H_
+#define SRC_BOXRECOGNIZER_H_
+
+#include <QList>
+#include <QMetaType>
+#include <QMutex>
+#include <QRect>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "PageImage.h"
+
+/**
+ * Recognizes single box with tesseract on worker thread.
+ * Engine is initialized once and keeps image of current page, so every
+ * request costs only SetRectangle and recognition of the box. Only the
+ * newest request is kept: requests arriving while engine is busy replace
+ * older pending ones and results of outdated requests are marked stale.
+ */
+class BoxRecognizer : public QThread {
+    Q_OBJECT
+
+  public:
+    struct Choice {
+        QString text;
+        float confidence;  /**< 0..100 */
+    };
+
+    struct Result {
+        int generation;  /**< request number (see isCurrent()) */
+        int row;
+        QRect rect;      /**< image coordinates */
+        QList<Choice> choices;  /**< best first */
+        int elapsed;     /**< ms */
+        QString error;
+    };
+
+    explicit BoxRecognizer(QObject* parent = 0);
+    ~BoxRecognizer();
+
+    /** Image for next requests (nothing happens for the same page). */
+    void setPage(const PageImagePtr& page);
+    /** Recognize rect (image coordinates) of table row. Replaces pending
+     *  request.
+     */
+    void recognize(int row, const QRect& rect);
+    /** Drop pending request and mark running one as stale. */
+    void cancel();
+    /** Result belongs to newest request. */
+    bool isCurrent(const Result& result);
+
+  signals:
+    void recognized(const BoxRecognizer::Result& result);
+
+  protected:
+    void run();
+
+  private:
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    bool m_stop;
+    PageImagePtr m_page;
+    bool m_pageChanged;
+    bool m_pending;
+    int m_generation;
+    int m_row;
+    QRect m_rect;
+};
+
+Q_DECLARE_METATYPE(BoxRecognizer::Result)
+
+#endif  // SRC_BOXRECOGNIZER_H_
@@ -0,0 +1,95 @@
+/**********************************************************************
+* File:        BoxTightener.cpp
+* Description: Snap boxes to ink of connected components
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "BoxTightener.h"
+#include "PageRunner.h"
+
+namespace {
+
+// Smaller components are noise
+const int kMinComponentPixels = 2;
+
+struct TightenTask : PageTask {
+    TightenTask() : changed(0) {
+    }
+
+    int changed;
+};
+
+class PageTightener {
+  public:
+    void operator()(TightenTask& task) const {
+        ComponentIndexPtr components = task.image->components();
+        task.changed = BoxTightener::tightenPage(*components, &task.glyphs);
+    }
+};
+
+}  // namespace
+
+int BoxTightener::tightenPage(const ComponentIndex& components,
+                              GlyphPage* glyphs) {
+    int changed = 0;
+    int imageHeight = components.height();
+    for (int i = 0; i < glyphs->size(); ++i) {
+        const Glyph& glyph = glyphs->at(i);
+        QRect ink = components.inkRect(glyph.imageRect(imageHeight),
+                                       kMinComponentPixels);
+        if (ink.isNull())
+            continue;
+        Glyph tight = glyph;
+        tight.setImageRect(ink, imageHeight);
+        if (tight != glyph) {
+            (*glyphs)[i] = tight;
+            changed++;
+        }
+    }
+    return changed;
+}
+
+bool BoxTightener::tightenDocument(const QString& imageFile,
+                                   QVector<GlyphPage>* pages,
+                                   const QHash<int, PageImagePtr>& loaded,
+                                   int* changed, QString* error,
+                                   const CancelToken& cancel) {
+    QVector<GlyphPage> result = *pages;
+    *changed = 0;
+    PageRunner<TightenTask> runner(
+                PageRunner<TightenTask>::forPages(imageFile, result, loaded));
+    while (runner.next(PageTightener())) {
+        if (cancel.isCancelled())
+            return false;
+        const QVector<TightenTask>& tasks = runner.chunk();
+        for (int t = 0; t < tasks.size(); ++t) {
+            const TightenTask& task = tasks.at(t);
+            if (!task.error.isEmpty()) {
+                *error = task.error;
+                return false;
+            }
+            // keep unchanged pages shared with original document
+            if (task.changed > 0)
+                result[task.page] = task.glyphs;
+            *changed += task.changed;
+        }
+    }
+    *pages = result;
+    return true;
+}
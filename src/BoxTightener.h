@@ -0,0 +1,58 @@
+/**********************************************************************
+* File:        BoxTightener.h
+* Description: Snap boxes to ink of connected components
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_BOXTIGHTENER_H_
+#define SRC_BOXTIGHTENER_H_
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "CancelToken.h"
+#include "ComponentIndex.h"
+#include "Glyph.h"
+#include "PageImage.h"
+
+/**
+ * Shrinks (or extends) boxes to the ink they contain.
+ * New box is union of parts of connected components lying mostly inside
+ * the old box, so ink of touching neighbours is not taken over. Boxes
+ * without ink (e.g. spaces) are kept.
+ */
+class BoxTightener {
+  public:
+    /** Tighten glyphs of page. Returns number of changed boxes. */
+    static int tightenPage(const ComponentIndex& components,
+                           GlyphPage* glyphs);
+    /** Tighten all pages of document. Pages are processed in parallel;
+     *  images not found in loaded are decoded from imageFile. Nothing is
+     *  changed if any page fails or cancel is set (checked between chunks
+     *  of pages; no error then).
+     */
+    static bool tightenDocument(const QString& imageFile,
+                                QVector<GlyphPage>* pages,
+                                const QHash<int, PageImagePtr>& loaded,
+                                int* changed, QString* error,
+                                const CancelToken& cancel = CancelToken());
+};
+
+#endif  // SRC_BOXTIGHTENER_H_
@@ -0,0 +1,356 @@
+/**********************************************************************
+* File:        BoxValidator.cpp
+* Description: Consistency checks of boxes against page image
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "BoxValidator.h"
+#include "PageRunner.h"
+#include "Settings.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSettings>
+#include <QTextStream>
+
+#include <algorithm>
+
+namespace {
+
+/*
+ * Counts black pixels straight from packed bits of 1 bpp page, so
+ * nothing per pixel is allocated besides the page itself
+ */
+class InkCounter {
+  public:
+    explicit InkCounter(const QImage& bilevel)
+        : m_mono(PageImage::toMono(bilevel)),
+          m_black(PageImage::blackIndex(m_mono)) {
+        m_bitCount[0] = 0;
+        for (int i = 1; i < 256; ++i)
+            m_bitCount[i] = (i & 1) + m_bitCount[i / 2];
+    }
+
+    /** Black pixels in rect (clipped to image); counting stops at
+     *  first row which reaches limit.
+     */
+    int count(const QRect& rect, int limit) const {
+        QRect r = rect.intersected(m_mono.rect());
+        if (r.isEmpty())
+            return 0;
+        int firstByte = r.left() >> 3;
+        int lastByte = r.right() >> 3;
+        // pixels are stored from most significant bit
+        uchar firstMask = 0xff >> (r.left() & 7);
+        uchar lastMask = uchar(0xff << (7 - (r.right() & 7)));
+        int total = 0;
+        for (int y = r.top(); y <= r.bottom() && total < limit; ++y) {
+            const uchar* line = m_mono.constScanLine(y);
+            for (int i = firstByte; i <= lastByte; ++i) {
+                uchar bits = m_black ? line[i] : uchar(~line[i]);
+                if (i == firstByte)
+                    bits &= firstMask;
+                if (i == lastByte)
+                    bits &= lastMask;
+                total += m_bitCount[bits];
+            }
+        }
+        return total;
+    }
+
+  private:
+    QImage m_mono;
+    uchar m_black;
+    uchar m_bitCount[256];
+};
+
+struct Box {
+    int row;
+    QRect rect;
+};
+
+struct ByLeft {
+    bool operator()(const Box& a, const Box& b) const {
+        if (a.rect.left() != b.rect.left())
+            return a.rect.left() < b.rect.left();
+        return a.row < b.row;
+    }
+};
+
+struct ByPosition {
+    bool operator()(const BoxValidator::Issue& a,
+                    const BoxValidator::Issue& b) const {
+        if (a.page != b.page)
+            return a.page < b.page;
+        if (a.row != b.row)
+            return a.row < b.row;
+        return a.type < b.type;
+    }
+};
+
+BoxValidator::Issue makeIssue(int page, int row, const Glyph& glyph,
+                              BoxValidator::IssueType type,
+                              const QString& message, int other = -1) {
+    BoxValidator::Issue issue;
+    issue.page = page;
+    issue.row = row;
+    issue.type = type;
+    issue.other = other;
+    issue.glyph = glyph;
+    issue.message = message;
+    return issue;
+}
+
+qint64 area(const QRect& rect) {
+    return qint64(rect.width()) * rect.height();
+}
+
+struct ValidateTask : PageTask {
+    QVector<BoxValidator::Issue> issues;
+};
+
+class PageValidator {
+  public:
+    explicit PageValidator(const BoxValidator::Options& options)
+        : m_options(options) {
+    }
+
+    void operator()(ValidateTask& task) const {
+        task.issues = BoxValidator::validatePage(task.image->binarized(),
+                                                 task.glyphs, task.page,
+                                                 m_options);
+        for (int i = 0; i < task.issues.size(); ++i)
+            task.issues[i].imageFile = task.imageFile;
+    }
+
+  private:
+    BoxValidator::Options m_options;
+};
+
+void runTasks(const QVector<ValidateTask>& all,
+              const BoxValidator::Options& options,
+              QVector<BoxValidator::Issue>* issues, QStringList* errors,
+              bool serial = false,
+              const CancelToken& cancel = CancelToken()) {
+    PageRunner<ValidateTask> runner(all);
+    runner.setSerial(serial);
+    while (!cancel.isCancelled() && runner.next(PageValidator(options))) {
+        const QVector<ValidateTask>& tasks = runner.chunk();
+        for (int t = 0; t < tasks.size(); ++t) {
+            if (!tasks.at(t).error.isEmpty())
+                errors->append(tasks.at(t).error);
+            *issues += tasks.at(t).issues;
+        }
+    }
+}
+
+}  // namespace
+
+BoxValidator::Options::Options()
+    : overlapRatio(0.5), minInkPixels(1) {
+}
+
+BoxValidator::Options BoxValidator::Options::fromSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    Options options;
+    if (settings.contains("Validate/OverlapRatio"))
+        options.overlapRatio =
+                settings.value("Validate/OverlapRatio").toDouble();
+    if (settings.contains("Validate/MinInkPixels"))
+        options.minInkPixels = settings.value("Validate/MinInkPixels").toInt();
+    options.overlapRatio = qBound(0.0, options.overlapRatio, 1.0);
+    return options;
+}
+
+QString BoxValidator::typeName(IssueType type) {
+    switch (type) {
+    case OutsideImage:
+        return QObject::tr("outside image");
+    case InvertedBox:
+        return QObject::tr("inverted box");
+    case ZeroArea:
+        return QObject::tr("zero area");
+    case BlankBox:
+        return QObject::tr("blank box");
+    case Duplicate:
+        return QObject::tr("duplicate");
+    case Overlap:
+        return QObject::tr("overlap");
+    default:
+        return QString();
+    }
+}
+
+QVector<BoxValidator::Issue> BoxValidator::validatePage(
+        const QImage& bilevel, const GlyphPage& glyphs, int page,
+        const Options& options) {
+    QVector<Issue> issues;
+    InkCounter ink(bilevel);
+    int width = bilevel.width();
+    int height = bilevel.height();
+
+    QVector<Box> boxes;
+    boxes.reserve(glyphs.size());
+    for (int row = 0; row < glyphs.size(); ++row) {
+        const Glyph& glyph = glyphs.at(row);
+        if (glyph.left > glyph.right || glyph.bottom > glyph.top) {
+            issues.append(makeIssue(page, row, glyph, InvertedBox,
+                                    QObject::tr("left > right or "
+                                                "bottom > top")));
+            continue;
+        }
+        if (glyph.left < 0 || glyph.bottom < 0 || glyph.right > width ||
+                glyph.top > height)
+            issues.append(makeIssue(page, row, glyph, OutsideImage,
+                                    QObject::tr("box exceeds image %1x%2")
+                                    .arg(width).arg(height)));
+        if (glyph.left == glyph.right || glyph.bottom == glyph.top) {
+            issues.append(makeIssue(page, row, glyph, ZeroArea,
+                                    QObject::tr("box has zero area")));
+            continue;
+        }
+        QRect rect = glyph.imageRect(height);
+        if (!glyph.letter.trimmed().isEmpty() &&
+                ink.count(rect, options.minInkPixels) <
+                options.minInkPixels)
+            issues.append(makeIssue(page, row, glyph, BlankBox,
+                                    QObject::tr("no ink inside box")));
+        Box box = {row, rect};
+        boxes.append(box);
+    }
+
+    // sweep line: active boxes are those still crossing current left edge
+    std::sort(boxes.begin(), boxes.end(), ByLeft());
+    QVector<Box> active;
+    for (int i = 0; i < boxes.size(); ++i) {
+        const Box& box = boxes.at(i);
+        int kept = 0;
+        for (int j = 0; j < active.size(); ++j) {
+            if (active.at(j).rect.right() >= box.rect.left())
+                active[kept++] = active.at(j);
+        }
+        active.resize(kept);
+
+        for (int j = 0; j < active.size(); ++j) {
+            const Box& other = active.at(j);
+            int row = qMax(box.row, other.row);
+            int otherRow = qMin(box.row, other.row);
+            if (box.rect == other.rect) {
+                issues.append(makeIssue(page, row, glyphs.at(row), Duplicate,
+                                        QObject::tr("same box as row %1")
+                                        .arg(otherRow + 1), otherRow));
+                continue;
+            }
+            QRect common = box.rect.intersected(other.rect);
+            if (common.isEmpty())
+                continue;
+            qint64 smaller = qMin(area(box.rect), area(other.rect));
+            if (area(common) >= options.overlapRatio * smaller)
+                issues.append(makeIssue(page, row, glyphs.at(row), Overlap,
+                                        QObject::tr("overlaps row %1 by "
+                                                    "%2%")
+                                        .arg(otherRow + 1)
+                                        .arg(100 * area(common) / smaller),
+                                        otherRow));
+        }
+        active.append(box);
+    }
+
+    std::sort(issues.begin(), issues.end(), ByPosition());
+    return issues;
+}
+
+bool BoxValidator::validateDocument(const QString& imageFile,
+                                    const QVector<GlyphPage>& pages,
+                                    const QHash<int, PageImagePtr>& loaded,
+                                    const Options& options,
+                                    QVector<Issue>* issues, QString* error,
+                                    bool serial, const CancelToken& cancel) {
+    QStringList errors;
+    runTasks(PageRunner<ValidateTask>::forPages(imageFile, pages, loaded),
+             options, issues, &errors, serial, cancel);
+    if (cancel.isCancelled())
+        return false;
+    if (!errors.isEmpty()) {
+        *error = errors.join("\n");
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Same page splitting as editor uses (new page when page number changes)
+ */
+bool BoxValidator::readBoxFile(const QString& fileName,
+                               QVector<GlyphPage>* pages, QString* error) {
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        *error = QObject::tr("Cannot read file %1:\n%2.").arg(fileName)
+                .arg(file.errorString());
+        return false;
+    }
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    GlyphPage page;
+    int pagePrev = 0;
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        lineNumber++;
+        if (line.isEmpty())
+            continue;
+        Glyph glyph;
+        if (!Glyph::fromBoxLine(line, &glyph)) {
+            *error = QObject::tr("Wrong box file format at line %1 of %2.")
+                    .arg(lineNumber).arg(fileName);
+            return false;
+        }
+        if (glyph.page != pagePrev) {
+            pagePrev = glyph.page;
+            pages->append(page);
+            page.clear();
+        }
+        page.append(glyph);
+    }
+    pages->append(page);
+    return true;
+}
+
+void BoxValidator::validateFiles(const QStringList& imageFiles,
+                                 const Options& options,
+                                 QVector<Issue>* issues,
+                                 QStringList* errors) {
+    QVector<ValidateTask> tasks;
+    for (int i = 0; i < imageFiles.size(); ++i) {
+        QFileInfo info(imageFiles.at(i));
+        QString boxFile = info.path() + "/" + info.completeBaseName() + ".box";
+        QVector<GlyphPage> pages;
+        QString error;
+        if (!readBoxFile(boxFile, &pages, &error)) {
+            errors->append(error);
+            continue;
+        }
+        tasks += PageRunner<ValidateTask>::forPages(
+                    imageFiles.at(i), pages, QHash<int, PageImagePtr>());
+    }
+    // pages of all files share one pool of workers
+    runTasks(tasks, options, issues, errors);
+}
@@ -0,0 +1,107 @@
+/**********************************************************************
+* File:        BoxValidator.h
+* Description: Consistency checks of boxes against page image
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_BOXVALIDATOR_H_
+#define SRC_BOXVALIDATOR_H_
+
+#include <QHash>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "CancelToken.h"
+#include "Glyph.h"
+#include "PageImage.h"
+
+/**
+ * Lint of box files: finds boxes that should not get into training.
+ * Ink inside box is counted from packed bits of binarized page (eight
+ * pixels per table lookup, no extra memory per pixel); duplicates and
+ * overlaps are found by sweep line over boxes sorted by left edge. Pages (of one or many documents) are validated in
+ * parallel.
+ */
+class BoxValidator {
+  public:
+    enum IssueType {
+        OutsideImage = 0,
+        InvertedBox,
+        ZeroArea,
+        BlankBox,      /**< no ink inside non-space box */
+        Duplicate,     /**< same box as other symbol */
+        Overlap,       /**< overlaps other box heavily */
+        IssueTypeCount
+    };
+
+    struct Issue {
+        QString imageFile;
+        int page;        /**< index of page in document */
+        int row;         /**< index of box in page */
+        IssueType type;
+        int other;       /**< row of other box (duplicate, overlap) or -1 */
+        Glyph glyph;
+        QString message;
+    };
+
+    struct Options {
+        Options();
+        static Options fromSettings();
+
+        double overlapRatio;  /**< part of smaller box to report overlap */
+        int minInkPixels;     /**< fewer black pixels means blank box */
+    };
+
+    /** Validate boxes of one page against its image. */
+    static QVector<Issue> validatePage(const QImage& bilevel,
+                                       const GlyphPage& glyphs, int page,
+                                       const Options& options);
+    /** Validate all pages of document. Pages missing in loaded are decoded
+     *  from imageFile. Returns false (and error) if page can not be loaded.
+     *  Pages are validated in parallel on global pool, or on calling
+     *  thread when serial is true (background indexing). Cancel is
+     *  checked between chunks of pages; cancelled run returns false
+     *  without error.
+     */
+    static bool validateDocument(const QString& imageFile,
+                                 const QVector<GlyphPage>& pages,
+                                 const QHash<int, PageImagePtr>& loaded,
+                                 const Options& options,
+                                 QVector<Issue>* issues, QString* error,
+                                 bool serial = false,
+                                 const CancelToken& cancel = CancelToken());
+    /** Read box file split to pages as editor does (new page when page
+     *  number changes).
+     */
+    static bool readBoxFile(const QString& fileName,
+                            QVector<GlyphPage>* pages, QString* error);
+    /** Validate image files and their box files (image name with .box
+     *  suffix). Files that can not be read are reported in errors.
+     */
+    static void validateFiles(const QStringList& imageFiles,
+                              const Options& options, QVector<Issue>* issues,
+                              QStringList* errors);
+
+    static QString typeName(IssueType type);
+};
+
+#endif  // SRC_BOXVALIDATOR_H_
@@ -0,0 +1,48 @@
+/**********************************************************************
+* File:        CancelToken.h
+* Description: Shared cancellation flag of background work
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_CANCELTOKEN_H_
+#define SRC_CANCELTOKEN_H_
+
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+/**
+ * Shared cancellation flag of job. Copies refer to the same flag; long
+ * loops (exports, binarization) check it between pages or stripes.
+ */
+class CancelToken {
+  public:
+    CancelToken() : m_flag(new QAtomicInt(0)) {
+    }
+    void cancel() {
+        m_flag->fetchAndStoreRelaxed(1);
+    }
+    bool isCancelled() const {
+        return m_flag->fetchAndAddRelaxed(0) != 0;
+    }
+
+  private:
+    QSharedPointer<QAtomicInt> m_flag;
+};
+
+#endif  // SRC_CANCELTOKEN_H_
@@ -27,15 +27,32 @@
 #include <algorithm>
 #include <leptonica/allheaders.h>
 
+#include <QPointer>
+
 #include "ChildWidget.h"
 #include "Settings.h"
 #include "DelegateEditors.h"
 #include "TessTools.h"
+#include "FontSplitter.h"
+#include "TrainingExport.h"
+#include "TextExport.h"
+#include "SelectionTracker.h"
+#include "DocumentCache.h"
+#include "EditJournal.h"
+#include "BoxTightener.h"
+#include "BoxValidator.h"
+#include "JobScheduler.h"
+#include "LabelChecker.h"
+#include "GlyphDiff.h"
+#include "BilevelImageItem.h"
 #include "dialogs/SettingsDialog.h"
 #include "dialogs/GetRowIDDialog.h"
 #include "dialogs/FindDialog.h"
 #include "dialogs/DrawRectangle.h"
 #include "dialogs/Statistics.h"
+#include "dialogs/BinarizeDialog.h"
+#include "dialogs/IssueListDialog.h"
+#include "dialogs/GlyphGalleryDialog.h"
 
 // This allows storing QGraphicsRectItem's in table model data
 Q_DECLARE_METATYPE(QGraphicsRectItem*)
@@ -52,6 +69,621 @@ int my_max(int arg1, int arg2) {
     return((arg1 > arg2) ? arg1 : arg2);
 }
 
+namespace {
+
+// Approximate memory of one glyph in pages
+const int kGlyphBytes = sizeof(Glyph) + 16;
+// Approximate memory of one table row (ten model items)
+const int kTableRowBytes = 1200;
+// Approximate memory of bbox scene item of one row
+const int kBoxItemBytes = 300;
+// Letter item role with recognizer confidence of generated glyph
+const int kConfidenceRole = Qt::UserRole + 1;
+
+// Glyph of table row in tesseract coordinates
+Glyph glyphFromModel(const QStandardItemModel* model, int row,
+                     int imageHeight) {
+    Glyph glyph;
+    glyph.letter = model->index(row, 0).data().toString();
+    glyph.left = model->index(row, 1).data().toInt();
+    glyph.bottom = imageHeight - model->index(row, 2).data().toInt();
+    glyph.right = model->index(row, 3).data().toInt();
+    glyph.top = imageHeight - model->index(row, 4).data().toInt();
+    glyph.page = model->index(row, 5).data().toInt();
+    glyph.italic = model->index(row, 6).data().toBool();
+    glyph.bold = model->index(row, 7).data().toBool();
+    glyph.underline = model->index(row, 8).data().toBool();
+    QVariant confidence = model->index(row, 0).data(kConfidenceRole);
+    if (confidence.isValid())
+        glyph.confidence = confidence.toFloat();
+    return glyph;
+}
+
+// Table of current page as source of PageStructure
+class ModelGlyphSource : public PageStructure::Source {
+  public:
+    ModelGlyphSource(const QStandardItemModel* model, int imageHeight)
+        : m_model(model), m_imageHeight(imageHeight) {
+    }
+    int size() const {
+        return m_model->rowCount();
+    }
+    Glyph glyph(int row) const {
+        return glyphFromModel(m_model, row, m_imageHeight);
+    }
+
+  private:
+    const QStandardItemModel* m_model;
+    int m_imageHeight;
+};
+
+}  // namespace
+
+/*
+ * Binarize page on worker; result is preview or new cached binarization
+ */
+class ChildWidget::BinarizeJob : public JobScheduler::Job {
+  public:
+    BinarizeJob(ChildWidget* child, const PageImagePtr& page,
+                const Binarizer::Options& options, BinarizeDialog* preview)
+        : JobScheduler::Job(preview ? tr("Binarization preview")
+                                    : tr("Binarization"),
+                            QString(), JobScheduler::Interactive),
+          m_child(child), m_page(page), m_options(options),
+          m_preview(preview), m_isPreview(preview != 0), m_msecs(0) {
+    }
+
+    bool run(QString* /*error*/) {
+        QElapsedTimer timer;
+        timer.start();
+        m_result = Binarizer::binarize(*m_page, m_options, &m_warning,
+                                       token());
+        m_msecs = timer.elapsed();
+        return !m_result.isNull();
+    }
+
+    void finish(JobScheduler::State state, const QString& /*error*/) {
+        // page changed meanwhile and shows its own image
+        if (!m_child || m_child->pageImage != m_page)
+            return;
+        if (state != JobScheduler::Finished) {
+            // preview left in scene is replaced by current image again
+            if (!m_isPreview)
+                m_child->showPageImage();
+            return;
+        }
+        if (m_isPreview) {
+            // dialog was closed meanwhile
+            if (!m_preview || !m_preview->isPreviewEnabled())
+                return;
+            m_child->setSceneImage(m_result);
+            m_preview->setPreviewInfo(m_warning.isEmpty()
+                                      ? tr("Binarized in %1 ms").arg(m_msecs)
+                                      : fallbackMessage());
+        } else {
+            m_page->setBinarized(m_result);
+            m_child->imageBinarized = true;
+            m_child->showPageImage();
+            if (!m_warning.isEmpty())
+                emit m_child->statusBarMessage(fallbackMessage());
+        }
+    }
+
+  private:
+    QString fallbackMessage() const {
+        return tr("%1 Otsu was used instead.").arg(m_warning);
+    }
+
+    QPointer<ChildWidget> m_child;
+    PageImagePtr m_page;
+    Binarizer::Options m_options;
+    QPointer<BinarizeDialog> m_preview;
+    bool m_isPreview;
+    QImage m_result;
+    QString m_warning;  /**< why tesseract thresholding failed */
+    qint64 m_msecs;
+};
+
+/*
+ * Decode page, so changing page does not wait for it
+ */
+class ChildWidget::PrefetchJob : public JobScheduler::Job {
+  public:
+    PrefetchJob(ChildWidget* child, const QString& imageFile, int page)
+        : JobScheduler::Job(tr("Load page %1").arg(page + 1), QString(),
+                            JobScheduler::Bulk),
+          m_child(child), m_imageFile(imageFile), m_page(page) {
+    }
+
+    bool run(QString* error) {
+        m_image = PageImage::load(m_imageFile, m_page);
+        if (!m_image)
+            *error = tr("Cannot load page %1 from file %2.")
+                    .arg(m_page + 1).arg(m_imageFile);
+        return !m_image.isNull();
+    }
+
+    void finish(JobScheduler::State state, const QString& /*error*/) {
+        if (!m_child || state != JobScheduler::Finished ||
+                m_child->imageFile != m_imageFile || m_child->hibernated)
+            return;
+        // page may have been decoded by editor meanwhile
+        PageImagePtr image = m_child->pageImages.value(m_page).toStrongRef();
+        if (!image) {
+            image = m_image;
+            m_child->pageImages.insert(m_page, image.toWeakRef());
+        }
+        if (qAbs(m_page - m_child->currPage) == 1)
+            m_child->prefetched.insert(m_page, image);
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QString m_imageFile;
+    int m_page;
+    PageImagePtr m_image;
+};
+
+/*
+ * Text export of snapshot of pages
+ */
+class ChildWidget::TextExportJob : public JobScheduler::Job {
+  public:
+    TextExportJob(ChildWidget* child, const QString& document,
+                  const QVector<GlyphPage>& pages, TextExport::Mode mode,
+                  const TextExport::Options& options,
+                  const QString& fileName)
+        : JobScheduler::Job(tr("Text export"), document,
+                            JobScheduler::Normal),
+          m_child(child), m_pages(pages), m_mode(mode), m_options(options),
+          m_fileName(fileName) {
+    }
+
+    bool run(QString* error) {
+        return TextExport::exportPages(m_pages, m_mode, m_options,
+                                       m_fileName, error, token());
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        else if (state == JobScheduler::Finished && m_child)
+            emit m_child->statusBarMessage(tr("Data exported to %1")
+                                           .arg(m_fileName));
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QVector<GlyphPage> m_pages;
+    TextExport::Mode m_mode;
+    TextExport::Options m_options;
+    QString m_fileName;
+};
+
+/*
+ * Split-by-font export of snapshot of current page
+ */
+class ChildWidget::SplitExportJob : public JobScheduler::Job {
+  public:
+    SplitExportJob(ChildWidget* child, const QString& document,
+                   const QImage& image, const QVector<Glyph>& glyphs,
+                   const QString& fileName)
+        : JobScheduler::Job(tr("Split to box files"), document,
+                            JobScheduler::Normal),
+          m_child(child), m_image(image), m_glyphs(glyphs),
+          m_fileName(fileName) {
+    }
+
+    bool run(QString* error) {
+        QStringList errors = FontSplitter::exportSplit(m_image, m_glyphs,
+                                                       m_fileName, token());
+        *error = errors.join("\n");
+        return errors.isEmpty();
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        else if (state == JobScheduler::Finished && m_child)
+            emit m_child->statusBarMessage(tr("Box files split"));
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QImage m_image;
+    QVector<Glyph> m_glyphs;
+    QString m_fileName;
+};
+
+/*
+ * Training glyph export of snapshot of pages
+ */
+class ChildWidget::TrainingExportJob : public JobScheduler::Job {
+  public:
+    TrainingExportJob(ChildWidget* child, const QString& document,
+                      const QString& imageFile,
+                      const QVector<GlyphPage>& pages,
+                      const QHash<int, PageImagePtr>& loaded,
+                      const QString& fileName,
+                      const TrainingExport::Options& options)
+        : JobScheduler::Job(tr("Training glyph export"), document,
+                            JobScheduler::Bulk),
+          m_child(child), m_imageFile(imageFile), m_pages(pages),
+          m_loaded(loaded), m_fileName(fileName), m_options(options),
+          m_exported(0) {
+    }
+
+    bool run(QString* error) {
+        bool ok = TrainingExport::exportGlyphs(m_imageFile, m_pages, m_loaded,
+                                               m_fileName, m_options,
+                                               &m_exported, error,
+                                               token());
+        // do not keep pages of editor alive longer than needed
+        m_loaded.clear();
+        return ok;
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        else if (state == JobScheduler::Finished && m_child)
+            emit m_child->statusBarMessage(tr("%1 glyphs exported")
+                                           .arg(m_exported));
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QString m_imageFile;
+    QVector<GlyphPage> m_pages;
+    QHash<int, PageImagePtr> m_loaded;
+    QString m_fileName;
+    TrainingExport::Options m_options;
+    int m_exported;
+};
+
+/*
+ * Shape index of snapshot of pages; only result of newest build is used
+ */
+class ChildWidget::ShapeIndexJob : public JobScheduler::Job {
+  public:
+    ShapeIndexJob(ChildWidget* child, int generation,
+                  const QString& document, const QString& imageFile,
+                  const QVector<GlyphPage>& pages,
+                  const QHash<int, PageImagePtr>& loaded)
+        : JobScheduler::Job(tr("Shape index"), document,
+                            JobScheduler::Bulk),
+          m_child(child), m_generation(generation), m_imageFile(imageFile),
+          m_pages(pages), m_loaded(loaded) {
+    }
+
+    bool run(QString* /*error*/) {
+        m_index = ShapeIndex::build(m_imageFile, m_pages, m_loaded, token());
+        m_loaded.clear();
+        return true;
+    }
+
+    void finish(JobScheduler::State state, const QString& /*error*/) {
+        if (!m_child || m_child->shapeIndexGeneration != m_generation)
+            return;
+        m_child->shapeIndexJob = -1;
+        if (state == JobScheduler::Finished)
+            m_child->shapeIndex = m_index;
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    int m_generation;
+    QString m_imageFile;
+    QVector<GlyphPage> m_pages;
+    QHash<int, PageImagePtr> m_loaded;
+    ShapeIndexPtr m_index;
+};
+
+/*
+ * Tighten boxes of snapshot of pages; result is one undo step
+ */
+class ChildWidget::TightenJob : public JobScheduler::Job {
+  public:
+    TightenJob(ChildWidget* child, const QString& document,
+               const QString& imageFile, const QVector<GlyphPage>& pages,
+               const QHash<int, PageImagePtr>& loaded)
+        : JobScheduler::Job(tr("Tighten boxes"), document,
+                            JobScheduler::Normal),
+          m_child(child), m_imageFile(imageFile), m_snapshot(pages),
+          m_pages(pages), m_loaded(loaded), m_changed(0) {
+    }
+
+    bool run(QString* error) {
+        bool ok = BoxTightener::tightenDocument(m_imageFile, &m_pages,
+                                                m_loaded, &m_changed, error,
+                                                token());
+        m_loaded.clear();
+        return ok;
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        if (state != JobScheduler::Finished || !m_child)
+            return;
+        if (m_changed > 0 && !m_child->applyJobDocument(m_snapshot, m_pages))
+            return;
+        emit m_child->statusBarMessage(tr("%1 boxes tightened")
+                                       .arg(m_changed));
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QString m_imageFile;
+    QVector<GlyphPage> m_snapshot;
+    QVector<GlyphPage> m_pages;
+    QHash<int, PageImagePtr> m_loaded;
+    int m_changed;
+};
+
+/*
+ * Validate snapshot of pages; issues are listed in issue dialog
+ */
+class ChildWidget::ValidateJob : public JobScheduler::Job {
+  public:
+    ValidateJob(ChildWidget* child, const QString& document,
+                const QString& imageFile, const QVector<GlyphPage>& pages,
+                const QHash<int, PageImagePtr>& loaded,
+                const BoxValidator::Options& options)
+        : JobScheduler::Job(tr("Validate boxes"), document,
+                            JobScheduler::Normal),
+          m_child(child), m_imageFile(imageFile), m_pages(pages),
+          m_loaded(loaded), m_options(options) {
+    }
+
+    bool run(QString* error) {
+        bool ok = BoxValidator::validateDocument(m_imageFile, m_pages,
+                                                 m_loaded, m_options,
+                                                 &m_issues, error, false,
+                                                 token());
+        m_loaded.clear();
+        return ok;
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        if (state != JobScheduler::Finished || !m_child)
+            return;
+        m_child->openIssueDialog(tr("Validation of %1")
+                                 .arg(m_child->userFriendlyCurrentFile()));
+        for (int i = 0; i < m_issues.size(); ++i) {
+            const BoxValidator::Issue& issue = m_issues.at(i);
+            m_child->issueDialog->addIssue(issue.page, issue.row,
+                                           issue.glyph.letter,
+                                           BoxValidator::typeName(issue.type),
+                                           issue.message);
+        }
+        m_child->showIssueSummary(m_issues.isEmpty()
+                                  ? tr("No problems found.")
+                                  : tr("%1 problems found.")
+                                    .arg(m_issues.size()));
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QString m_imageFile;
+    QVector<GlyphPage> m_pages;
+    QHash<int, PageImagePtr> m_loaded;
+    BoxValidator::Options m_options;
+    QVector<BoxValidator::Issue> m_issues;
+};
+
+/*
+ * Label check of snapshot of pages; suspects are listed in issue dialog
+ */
+class ChildWidget::LabelCheckJob : public JobScheduler::Job {
+  public:
+    LabelCheckJob(ChildWidget* child, const QString& document,
+                  const QString& imageFile, const QVector<GlyphPage>& pages,
+                  const QHash<int, PageImagePtr>& loaded,
+                  const LabelChecker::Options& options)
+        : JobScheduler::Job(tr("Check labels"), document,
+                            JobScheduler::Normal),
+          m_child(child), m_imageFile(imageFile), m_pages(pages),
+          m_loaded(loaded), m_options(options) {
+    }
+
+    bool run(QString* error) {
+        bool ok = LabelChecker::checkDocument(m_imageFile, m_pages, m_loaded,
+                                              m_options, &m_suspects, error,
+                                              token());
+        m_loaded.clear();
+        return ok;
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        if (state != JobScheduler::Finished || !m_child)
+            return;
+        m_child->openIssueDialog(tr("Suspicious labels of %1")
+                                 .arg(m_child->userFriendlyCurrentFile()));
+        for (int i = 0; i < m_suspects.size(); ++i) {
+            const LabelChecker::Suspect& suspect = m_suspects.at(i);
+            m_child->issueDialog->addIssue(
+                        suspect.page, suspect.row, suspect.glyph.letter,
+                        tr("Label"), tr("Looks like '%1' (%2% of %3 similar "
+                                        "boxes)").arg(suspect.expected)
+                        .arg(qRound(suspect.share * 100))
+                        .arg(suspect.clusterSize));
+        }
+        m_child->showIssueSummary(m_suspects.isEmpty()
+                                  ? tr("No suspicious labels found.")
+                                  : tr("%1 suspicious labels found.")
+                                    .arg(m_suspects.size()));
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QString m_imageFile;
+    QVector<GlyphPage> m_pages;
+    QHash<int, PageImagePtr> m_loaded;
+    LabelChecker::Options m_options;
+    QVector<LabelChecker::Suspect> m_suspects;
+};
+
+/*
+ * Give letter of source box to boxes of snapshot with similar shape; box
+ * missing in index (edited after build) is hashed here, not on GUI thread
+ */
+class ChildWidget::LabelShapesJob : public JobScheduler::Job {
+  public:
+    LabelShapesJob(ChildWidget* child, const QString& document,
+                   const QString& imageFile, const QVector<GlyphPage>& pages,
+                   const ShapeIndexPtr& index, int page,
+                   const PageImagePtr& image, const Glyph& source)
+        : JobScheduler::Job(tr("Label similar shapes"), document,
+                            JobScheduler::Interactive),
+          m_child(child), m_imageFile(imageFile), m_snapshot(pages),
+          m_pages(pages), m_index(index), m_page(page), m_image(image),
+          m_source(source), m_changed(0) {
+    }
+
+    bool run(QString* error) {
+        quint64 hash;
+        if (!m_index->hashOf(m_page, m_source, &hash)) {
+            if (!m_image)
+                m_image = PageImage::load(m_imageFile, m_page);
+            if (!m_image) {
+                *error = tr("Cannot load page %1 of %2.").arg(m_page + 1)
+                        .arg(m_imageFile);
+                return false;
+            }
+            QImage bilevel = m_image->binarized();
+            m_image.clear();
+            // box without ink has no shape to compare
+            if (!ShapeIndex::shapeHash(
+                        bilevel, m_source.imageRect(bilevel.height()), &hash))
+                return true;
+        }
+        QVector<ShapeIndex::Entry> entries = m_index->similar(
+                    hash, m_source.right - m_source.left,
+                    m_source.top - m_source.bottom);
+
+        // rows of pages by box, built for pages with similar shapes only
+        QHash<int, QHash<quint64, int> > rowsOfPage;
+        for (int i = 0; i < entries.size(); ++i) {
+            if (isCancelled())
+                return false;
+            const ShapeIndex::Entry& entry = entries.at(i);
+            if (entry.page >= m_pages.size())
+                continue;
+            if (!rowsOfPage.contains(entry.page)) {
+                QHash<quint64, int>& rows = rowsOfPage[entry.page];
+                const GlyphPage& page = m_pages.at(entry.page);
+                for (int r = 0; r < page.size(); ++r)
+                    rows.insert(ShapeIndex::boxKey(page.at(r).left,
+                                                   page.at(r).bottom,
+                                                   page.at(r).right,
+                                                   page.at(r).top), r);
+            }
+            int r = rowsOfPage.value(entry.page).value(
+                        ShapeIndex::boxKey(entry.left, entry.bottom,
+                                           entry.right, entry.top), -1);
+            if (r < 0 || m_pages.at(entry.page).at(r).letter ==
+                    m_source.letter)
+                continue;
+            m_pages[entry.page][r].letter = m_source.letter;
+            ++m_changed;
+        }
+        return true;
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        if (state != JobScheduler::Finished || !m_child)
+            return;
+        if (m_changed == 0) {
+            emit m_child->statusBarMessage(
+                        tr("All similar shapes are labeled '%1'.")
+                        .arg(m_source.letter));
+            return;
+        }
+        if (m_child->applyJobDocument(m_snapshot, m_pages))
+            emit m_child->statusBarMessage(tr("%1 boxes labeled '%2'")
+                                           .arg(m_changed)
+                                           .arg(m_source.letter));
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QString m_imageFile;
+    QVector<GlyphPage> m_snapshot;
+    QVector<GlyphPage> m_pages;
+    ShapeIndexPtr m_index;
+    int m_page;
+    PageImagePtr m_image;
+    Glyph m_source;
+    int m_changed;
+};
+
+/*
+ * Tesseract boxes of page (or of rectangle of it); engine of document is
+ * kept warm between jobs
+ */
+class ChildWidget::GenerateBoxesJob : public JobScheduler::Job {
+  public:
+    GenerateBoxesJob(ChildWidget* child, const QString& document,
+                     const QSharedPointer<TessTools>& tools,
+                     const QString& imageFile, int page,
+                     const PageImagePtr& image, const QRect& region,
+                     const QString& saveTo)
+        : JobScheduler::Job(region.isNull()
+                            ? tr("Generate boxes of page %1").arg(page + 1)
+                            : tr("Generate boxes in rectangle"),
+                            document, JobScheduler::Interactive),
+          m_child(child), m_tools(tools), m_imageFile(imageFile),
+          m_page(page), m_image(image), m_region(region), m_saveTo(saveTo),
+          m_imageHeight(0) {
+    }
+
+    bool run(QString* error) {
+        if (!m_image)
+            m_image = PageImage::load(m_imageFile, m_page);
+        if (!m_image) {
+            *error = tr("Cannot load page %1 of %2.").arg(m_page + 1)
+                    .arg(m_imageFile);
+            return false;
+        }
+        m_imageHeight = m_image->height();
+        m_tools->setSourceName(m_imageFile);
+        bool ok = m_tools->makeGlyphs(m_image->image(), m_page, &m_glyphs,
+                                      m_region, token(), error);
+        m_image.clear();
+        return ok;
+    }
+
+    void finish(JobScheduler::State state, const QString& error) {
+        if (state == JobScheduler::Failed)
+            QMessageBox::warning(m_child, SETTING_APPLICATION, error);
+        if (state != JobScheduler::Finished || !m_child)
+            return;
+        if (m_region.isNull())
+            m_child->applyGeneratedPage(m_page, m_glyphs, m_saveTo);
+        else
+            m_child->applyGeneratedRegion(m_page, m_imageHeight, m_region,
+                                          m_glyphs);
+    }
+
+  private:
+    QPointer<ChildWidget> m_child;
+    QSharedPointer<TessTools> m_tools;
+    QString m_imageFile;
+    int m_page;
+    PageImagePtr m_image;
+    QRect m_region;
+    QString m_saveTo;
+    int m_imageHeight;
+    GlyphPage m_glyphs;
+};
+
 // STATICS INITIALIZATION
 const Qt::CursorShape DragResizer::gripCursor[dirCount] = {
     Qt::SizeHorCursor, Qt::SizeBDiagCursor, Qt::SizeVerCursor,
@@ -188,6 +820,7 @@ bool DragResizer::sceneEventFilter(QGraphicsItem* watched, QEvent* event) {
         return true;
     case QEvent::GraphicsSceneMouseRelease:
         setFromRect(rect);
+        emit dragFinished();
         return true;
     default:
         break;
@@ -201,6 +834,8 @@ bool DragResizer::sceneEventFilter(QGraphicsItem* watched, QEvent* event) {
 ChildWidget::ChildWidget(QWidget* parent)
     : QSplitter(Qt::Horizontal, parent) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    selectionTracker = new SelectionTracker(this);
+    journal = new EditJournal(this);
     table = new QTableView;
     statisticsTable = new QTableView;
     table->resize(1, 1);
@@ -219,6 +854,10 @@ ChildWidget::ChildWidget(QWidget* parent)
     statisticsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
 #endif
     statisticsTable->installEventFilter(this);  // installs event filter
+    statisticsTable->setToolTip(tr("Double click letter to see all its "
+                                   "boxes"));
+    connect(statisticsTable, SIGNAL(doubleClicked(QModelIndex)), this,
+            SLOT(showGallery(QModelIndex)));
     initTable();
 
     // Make graphics Scene and View
@@ -233,8 +872,13 @@ ChildWidget::ChildWidget(QWidget* parent)
 
     resizer = new DragResizer;
     resizer->init(imageScene);
+
+    balloonItem = new BalloonItem;
+    imageScene->addItem(balloonItem);
     connect(resizer, SIGNAL(changed()), this, SLOT(boxDragChanged()));
+    connect(resizer, SIGNAL(dragFinished()), this, SLOT(boxEditFinished()));
 
+    recognizer = 0;
     readSettings();
 
     // Table toolbar
@@ -354,6 +998,8 @@ ChildWidget::ChildWidget(QWidget* parent)
     setSelectionRect();
     widgetWidth = parent->size().width();
     imageItem = NULL;
+    imageBinarized = false;
+    imagePageCount = 1;
     modified = false;
     boxesVisible = false;
     drawnRectangle = false;
@@ -361,6 +1007,8 @@ ChildWidget::ChildWidget(QWidget* parent)
     directTypingMode = false;
     f_dialog = 0;
     statisticsDialog = 0;
+    issueDialog = 0;
+    galleryDialog = 0;
     m_DrawRectangle = 0;
     rectangle = 0;
     vertLineLeft = 0;
@@ -375,6 +1023,14 @@ ChildWidget::ChildWidget(QWidget* parent)
     bIsSpinBoxChanged = false;
     bIsLineEditChanged = false;
     fileWatcher = 0;
+    hibernated = false;
+    hibernatedRow = -1;
+    previewJob = 0;
+    autoRecognize = false;
+    shapeIndexJob = -1;
+    shapeIndexGeneration = 0;
+    labelSourcePage = -1;
+    tessTools = QSharedPointer<TessTools>(new TessTools);
 }
 
 void ChildWidget::initTable() {
@@ -392,6 +1048,8 @@ void ChildWidget::initTable() {
     model->setHeaderData(9, Qt::Horizontal, tr("<Hidden> BB"));
     table->setModel(model);
     selectionModel = new QItemSelectionModel(model);
+    // tracker must see selection changes before selectionChanged() slot
+    selectionTracker->setSelectionModel(selectionModel);
     connect(
                 selectionModel,
                 SIGNAL(selectionChanged(const QItemSelection&, const QItemSelection&)),
@@ -448,10 +1106,23 @@ void ChildWidget::initTable() {
 
     connect(model,SIGNAL(dataChanged(QModelIndex,QModelIndex)),
             this,SLOT(updateStats(QModelIndex,QModelIndex)));
+
+    // edits only mark rows of page structure dirty
+    pageStructure.clear();
+    connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(structureRowsInserted(QModelIndex,int,int)));
+    connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            this, SLOT(structureRowsRemoved(QModelIndex,int,int)));
+    connect(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+            this, SLOT(structureDataChanged(QModelIndex,QModelIndex)));
 }
 
 void ChildWidget::readSettings() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    // box recognizer is initialized again with current tesseract settings
+    // when it is needed (tessTools checks them on its own)
+    delete recognizer;
+    recognizer = 0;
     // Font for table
     QSettings settings(QSettings::IniFormat, QSettings::UserScope,
                        SETTING_ORGANIZATION, SETTING_APPLICATION);
@@ -475,6 +1146,7 @@ void ChildWidget::readSettings() {
         }
     }
     m_imageFont.setPointSize(2 * m_imageFont.pointSize());
+    balloonItem->setFont(m_imageFont);
 
     if (settings.contains("GUI/ImageFontOffset")) {
         fontOffset = settings.value("GUI/ImageFontOffset").toInt();
@@ -493,6 +1165,7 @@ void ChildWidget::readSettings() {
     } else {
         imageFontColor = Qt::red;
     }
+    balloonItem->setColor(imageFontColor);
 
     if (settings.contains("GUI/Rectagle")) {
         rectColor = settings.value("GUI/Rectagle").value<QColor>();
@@ -520,6 +1193,11 @@ void ChildWidget::readSettings() {
     }
     imageView->setBackgroundBrush(backgroundColor);
 
+    textExportOptions = TextExport::Options::fromSettings();
+    autoRecognize = settings.value("Tesseract/RecognizeAfterEdit").toBool();
+    pageStructure.setOptions(textExportOptions.wordSpace,
+                             textExportOptions.paragraphIndent);
+
     if (model->rowCount() > 0) {
         table->resizeRowsToContents();
         statisticsTable->resizeRowsToContents();
@@ -557,31 +1235,23 @@ void ChildWidget::updateColWidthsOnSplitter(int /*pos*/, int /*index*/) {
 bool ChildWidget::loadImage(const QString& fileName) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
 
-    QImage image;
-    FILE   *fp;
-    PIX    *pix;
-    char   *filein;
-    int    nPages = 0;
-
-    filein = fileName.toLocal8Bit().data();
-    fp = lept_fopen(filein, "rb");
-    if (fileFormatIsTiff(fp)) {
-        tiffGetCount(fp, &nPages);
-        pix = pixReadStreamTiff(fp, currPage);  // open first page
-        image = TessTools::PIX2qImage(pix);
-        pixDestroy(&pix);
-        lept_fclose(fp);
-    } else {
-        //  pixReadStream/PIX2qImage was not able to display png image
-        //  So lets use QImage for other format than tiff...
-        image.load(fileName);
-    }
-
-    if (image.isNull()) {
+    QString boxFileName = QFileInfo(fileName).path() + "/"  // QDir::separator()
+            + QFileInfo(fileName).completeBaseName() + ".box";
+    // parsed document from binary cache (if it is up to date)
+    DocumentCache::Document cached;
+    bool cacheHit = QFile::exists(boxFileName) &&
+            DocumentCache::load(fileName, boxFileName, &cached);
+
+    int nPages = cacheHit ? cached.pageCount : PageImage::pageCount(fileName);
+    imagePageCount = nPages;
+    pageImage = PageImage::load(fileName, currPage);
+    if (!pageImage) {
         QMessageBox::information(this, tr("Wrong file"),
                                  tr("Cannot load %1.").arg(fileName));
         return false;
     }
+    pageImages.insert(currPage, pageImage.toWeakRef());
+
     if (nPages > 1) {
         currentPage->setMaximum(nPages);
         currentPage->setMinimum(1);
@@ -591,62 +1261,159 @@ bool ChildWidget::loadImage(const QString& fileName) {
     } else {
         pageWidget->hide();
     }
-    imageHeight = image.height();
-    imageWidth = image.width();
+    imageHeight = pageImage->height();
+    imageWidth = pageImage->width();
     setCurrentImageFile(fileName);
-    QString boxFileName = QFileInfo(fileName).path() + "/"  // QDir::separator()
-            + QFileInfo(fileName).completeBaseName() + ".box";
 
     if (!QFile::exists(boxFileName)) {
         qCreateBoxes(boxFileName);
+    } else if (cacheHit) {
+        pages = cached.pages;
+        if (!fillTableData(currPage)) return false;
     } else {
         if (!loadBoxes(boxFileName)) return false;
+        storeDocumentCache(boxFileName);
     }
 
+    // edits of crashed session are applied over box file from disk
+    bool recovered = EditJournal::hasRecovery(boxFileName) &&
+            recoverJournal(boxFileName);
+    journal->open(boxFileName, recovered);
+
     setCurrentBoxFile(boxFileName);
     setFileWatcher(boxFileName);
-    imageItem = imageScene->addPixmap(QPixmap::fromImage(image));
-    modified = false;
+    showPageImage();
+    modified = recovered;
     emit modifiedChanged();
     connect(model, SIGNAL(itemChanged(QStandardItem*)), this,
             SLOT(emitBoxChanged()));
     connect(model, SIGNAL(itemChanged(QStandardItem*)), this,
             SLOT(documentWasModified()));
+    buildShapeIndex();
     return true;
 }
 
-bool ChildWidget::qCreateBoxes(const QString &boxFileName) {
+bool ChildWidget::recoverJournal(const QString& boxFileName) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QMessageBox::StandardButton ret = QMessageBox::question(
+                this, SETTING_APPLICATION,
+                tr("'%1' has unsaved changes from previous session.\n"
+                   "Do you want to recover them?")
+                .arg(strippedName(boxFileName)),
+                QMessageBox::Yes | QMessageBox::No);
+    if (ret != QMessageBox::Yes)
+        return false;
+
+    int applied = 0;
+    QVector<GlyphPage> recovered = pages;
+    if (!EditJournal::replay(boxFileName, &recovered, &applied)) {
+        QMessageBox::warning(this, SETTING_APPLICATION,
+                             tr("Changes from previous session do not match "
+                                "box file %1 and can not be recovered.")
+                             .arg(boxFileName));
+        return false;
+    }
+    pages = recovered;
     loadTable();
-    save(boxFileName);
-    modified = false;
-    emit modifiedChanged();
+    emit statusBarMessage(tr("Recovered %1 changes").arg(applied));
     return true;
 }
 
+void ChildWidget::storeDocumentCache(const QString& boxFileName) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    DocumentCache::Document document;
+    document.pageCount = imagePageCount;
+    document.pageSizes.resize(imagePageCount);
+    QHash<int, QWeakPointer<PageImage> >::const_iterator it;
+    for (it = pageImages.constBegin(); it != pageImages.constEnd(); ++it) {
+        PageImagePtr image = it.value().toStrongRef();
+        if (image && it.key() < document.pageSizes.size())
+            document.pageSizes[it.key()] = QSize(image->width(),
+                                                 image->height());
+    }
+    document.pages = pages;
+    DocumentCache::store(imageFile, boxFileName, document);
+}
+
+/*
+ * Generate boxes of current page in background; they replace the page and
+ * are written to boxFileName when job ends
+ */
+bool ChildWidget::qCreateBoxes(const QString &boxFileName) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    return generateBoxes(QRect(), boxFileName);
+}
+
+/*
+ * Generate boxes of current page without data in background
+ */
 bool ChildWidget::makeBoxPage() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    return generateBoxes(QRect(), QString());
+}
+
+bool ChildWidget::generateBoxes(const QRect& region, const QString& saveTo) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     if (imageFile.isEmpty())
         return false;
-    QImage image;
-    if (pageWidget->isHidden()) {  // one page - QImage is ok
-        image.load(imageFile);
-    } else {  // multipage - use leptonica
-        PIX    *pix;
-        pix = pixReadTiff(imageFile.toLocal8Bit().data(), currPage);
-        image = TessTools::PIX2qImage(pix);
-        pixDestroy(&pix);
-    }
-
-    TessTools tt;
-    QString str = tt.makeBoxes(image, currPage);
-    if (str == "")
-        return false;
-
-    QTextStream boxdata(&str);
-    readToVector(boxdata);
+    // page missing in cache is decoded by job
+    PageImagePtr page = pageImage && pageImage->page() == currPage
+            ? pageImage : pageImages.value(currPage).toStrongRef();
+    QString document = saveTo.isEmpty() ? boxFile : saveTo;
+    trackViewJob(JobScheduler::instance()->submit(
+        new GenerateBoxesJob(this, document, tessTools, imageFile, currPage,
+                             page, region, saveTo)));
+    emit statusBarMessage(tr("Generating boxes..."));
     return true;
 }
 
+/*
+ * Take boxes generated for whole page: they fill page without data, or
+ * replace page (one undo step) when they are to be saved
+ */
+void ChildWidget::applyGeneratedPage(int page, const GlyphPage& glyphs,
+                                     const QString& saveTo) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    bool missing = page >= pages.size() || pages.at(page).isEmpty();
+    // page got data meanwhile (e.g. by reload); they are kept
+    if (!missing && saveTo.isEmpty())
+        return;
+    if (glyphs.isEmpty()) {
+        emit statusBarMessage(tr("No boxes found on page %1.")
+                              .arg(page + 1));
+        return;
+    }
+
+    if (missing) {
+        if (pages.size() <= page)
+            pages.resize(page + 1);
+        pages[page] = glyphs;
+        journal->recordPage(page, glyphs);
+        if (page == currPage && !hibernated)
+            loadTable();
+    } else {
+        QVector<GlyphPage> document = pages;
+        document[page] = glyphs;
+        wakeUp();
+        UndoItem ui;
+        ui.m_eop = euoDocument;
+        ui.m_origrow = table->currentIndex().row();
+        ui.m_extrarow = -1;
+        ui.m_pages = pages;
+        if (applyDocument(document))
+            m_undostack.push(ui);
+    }
+    documentWasModified();
+    if (!saveTo.isEmpty())
+        save(saveTo);
+    // new boxes are not in shape index yet
+    buildShapeIndex();
+    emit boxChanged();
+    emit statusBarMessage(tr("%1 boxes generated on page %2")
+                          .arg(glyphs.size()).arg(page + 1));
+}
+
 void ChildWidget::loadTable() {
     bool showFontColumns = isFontColumnsShown();
     cleanTable();
@@ -661,40 +1428,47 @@ void ChildWidget::loadTable() {
 
 bool ChildWidget::readToVector(QTextStream &boxdata) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QVector<GlyphPage> document;
+    if (!parseBoxes(boxdata, &document))
+        return false;
+    pages += document;
+    return true;
+}
+
+bool ChildWidget::parseBoxes(QTextStream &boxdata,
+                             QVector<GlyphPage>* document) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     boxdata.setCodec("UTF-8");
     QString data = boxdata.readAll();
     QStringList lineBoxes = data.split(QRegExp("\n"),
                                        QString::SkipEmptyParts);
-    QString pagePrev = "0";
-    QVector<QStringList> page;
+    int pagePrev = 0;
+    GlyphPage page;
 
     for (int i = 0; i < lineBoxes.size(); ++i) {
-        QString line = lineBoxes.at(i);
-        QStringList box = line.split(" ");
-        if (box.size() == 7) {
-            if (line.startsWith(" "))
-                box.removeFirst ();  // tess2image generate also box for spaces
-        } else if (box.size() != 6) {
-            qDebug() << "box:" << box;
+        Glyph glyph;
+        if (!Glyph::fromBoxLine(lineBoxes.at(i), &glyph)) {
+            qDebug() << "box:" << lineBoxes.at(i);
             QMessageBox::warning(this, SETTING_APPLICATION,
                                  tr("File can not be loaded because of wrong "
                                     "(non tesseract-ocr 3.02) box "
                                     "file format at line '%1'! (box.size: %2)")
-                                 .arg(i + 1).arg (box.size()));
+                                 .arg(i + 1)
+                                 .arg(lineBoxes.at(i).split(" ").size()));
             QApplication::restoreOverrideCursor();
             return false;
         }
 
-        if (box[5] == pagePrev) {
-            page.append(box);
+        if (glyph.page == pagePrev) {
+            page.append(glyph);
         } else {
-            pagePrev = box[5];
-            pages.append(page);
+            pagePrev = glyph.page;
+            document->append(page);
             page.clear();
-            page.append(box);
+            page.append(glyph);
         }
     }
-    pages.append(page);
+    document->append(page);
     return true;
 }
 
@@ -710,11 +1484,10 @@ bool ChildWidget::fillTableData(int pageNum) {
                     .arg(pageNum + 1),
                     QMessageBox::Yes |
                     QMessageBox::No)) {
-        case QMessageBox::Yes: {
+        case QMessageBox::Yes:
+            // table is filled when background job ends
             makeBoxPage();
-            documentWasModified();
-            break;
-        }
+            return false;
         case QMessageBox::No:
         case QMessageBox::Cancel:
         default:
@@ -737,49 +1510,18 @@ bool ChildWidget::fillTableData(int pageNum) {
         return false;
     }
 
-    QVector<QStringList> pageData = pages[pageNum];
+    // filling table is not an edit
+    journal->setSuspended(true);
+    const GlyphPage& pageData = pages.at(pageNum);
     for (int i = 0; i < pageData.size(); ++i) {
-        QFont letterFont;
-        QStringList pieces = pageData[i];
-        QString letter = pieces.value(0);
-        bool bold = false, italic = false, underline = false;
-        // formating is present only in case there are more than 2 letters
-        if (letter.at(0) == '@' && letter.size() > 1) {
-            bold = true;
-            letterFont.setBold(true);
-            letter.remove(0, 1);
-        }
-        if (letter.at(0) == '$' && letter.size() > 1) {
-            italic = true;
-            letterFont.setItalic(true);
-            letter.remove(0, 1);
-        }
-        if (letter.at(0) == '\'' && letter.size() > 1) {
-            underline = true;
-            letterFont.setUnderline(true);
-            letter.remove(0, 1);
-        }
-        int left = pieces.value(1).toInt();
-        int bottom = imageHeight - pieces.value(2).toInt();
-        int right = pieces.value(3).toInt();
-        int top = imageHeight - pieces.value(4).toInt();
-        int page = pieces.value(5).toInt();
-
         model->insertRow(row);
-        model->setData(model->index(row, 0, QModelIndex()), letterFont,
-                       Qt::FontRole);
-        model->setData(model->index(row, 0, QModelIndex()), letter);
-        model->setData(model->index(row, 1, QModelIndex()), left);
-        model->setData(model->index(row, 2, QModelIndex()), bottom);
-        model->setData(model->index(row, 3, QModelIndex()), right);
-        model->setData(model->index(row, 4, QModelIndex()), top);
-        model->setData(model->index(row, 5, QModelIndex()), page);
-        model->setData(model->index(row, 6, QModelIndex()), italic);
-        model->setData(model->index(row, 7, QModelIndex()), bold);
-        model->setData(model->index(row, 8, QModelIndex()), underline);
+        setRowGlyph(row, pageData[i]);
         createModelItemBox(row);
         row++;
     }
+    journal->attach(model, pageNum, imageHeight);
+    journal->setSuspended(false);
+    pageStructure.build(pageData);
 
     // Set table features
     table->resizeRowsToContents();
@@ -855,8 +1597,7 @@ void ChildWidget::slotfileChanged(const QString &fileName) {
         switch (QMessageBox::question(
                     this,
                     tr("Warning: File was modified..."),
-                    tr("File '%1' was modified outside of %2.\nReload it?\n\n" \
-                       "Warning: This operation can not be undone!")
+                    tr("File '%1' was modified outside of %2.\nReload it?")
                     .arg(fileName).arg(SETTING_APPLICATION),
                     QMessageBox::Yes |
                     QMessageBox::No,
@@ -875,48 +1616,262 @@ void ChildWidget::slotfileChanged(const QString &fileName) {
     }
 }
 
+/*
+ * Reload box file from disk. Only differences to current document are
+ * applied (see applyDocument), so the reload can be undone.
+ */
 bool ChildWidget::reload(const QString& fileName) {
-    if (boxesVisible) {
-        drawBoxes();
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    // differences are applied to table of current page
+    wakeUp();
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        QMessageBox::warning(this, SETTING_APPLICATION,
+                             tr("Cannot read file %1:\n%2.").arg(fileName).arg(
+                                 file.errorString()));
+        return false;
     }
-    deleteModelItemBox(table->currentIndex().row());
-    bool showFontColumns = isFontColumnsShown();
-    model->clear();
-    delete selectionModel;
-    delete model;
-    pages.clear();
-
+    QTextStream boxdata(&file);
+    QVector<GlyphPage> document;
+    if (!parseBoxes(boxdata, &document))
+        return false;
+    file.close();
 
-    initTable();
-    setShowFontColumns(showFontColumns);
-    loadBoxes(fileName);
-    updateSelectionRects();
+    storePage();
+    UndoItem ui;
+    ui.m_eop = euoDocument;
+    ui.m_origrow = table->currentIndex().row();
+    ui.m_extrarow = -1;
+    ui.m_pages = pages;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    if (applyDocument(document))
+        m_undostack.push(ui);
+    QApplication::restoreOverrideCursor();
 
+    // document matches box file again
+    journal->discard();
+    if (!imageFile.isEmpty()) {
+        storeDocumentCache(fileName);
+        buildShapeIndex();
+    }
     modified = false;
     emit modifiedChanged();
+    emit boxChanged();
+    return true;
+}
+
+/*
+ * Make document equal to given pages. Rows of current page are changed
+ * in place (scene items and selection of untouched rows are kept), other
+ * pages are just replaced in pages vector.
+ */
+bool ChildWidget::applyDocument(const QVector<GlyphPage>& document) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QVector<GlyphPage> target = document;
+    // current page must stay valid for storePage()
+    if (target.size() <= currPage)
+        target.resize(currPage + 1);
+
+    QVector<GlyphDiff::Hunk> hunks = GlyphDiff::diff(pages, target);
+    for (int i = 0; i < hunks.size(); ++i) {
+        const GlyphDiff::Hunk& hunk = hunks.at(i);
+        if (hunk.page == currPage)
+            applyPageHunk(hunk);
+        else  // model of journal shows only current page
+            journal->recordPage(hunk.page, hunk.page < target.size() ?
+                                    target.at(hunk.page) : GlyphPage());
+    }
+    pages = target;
+    if (hunks.isEmpty())
+        return false;
+
+    if (!table->currentIndex().isValid() && model->rowCount() > 0)
+        table->setCurrentIndex(model->index(0, 0));
+    penSelectedBoxes();
+    updateSelectionRects();
     return true;
 }
 
+void ChildWidget::applyPageHunk(const GlyphDiff::Hunk& hunk) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    int common = qMin(hunk.removed, hunk.inserted.size());
+    // changed rows are updated in place
+    for (int i = 0; i < common; ++i) {
+        int row = hunk.first + i;
+        const Glyph& glyph = hunk.inserted.at(i);
+        setRowGlyph(row, glyph);
+        // modelItemBox(row) works only with selection
+        model->index(row, 9).data().value<QGraphicsRectItem*>()->setRect(
+                    glyph.left, imageHeight - glyph.top,
+                    glyph.right - glyph.left, glyph.top - glyph.bottom);
+    }
+    for (int row = hunk.first + hunk.removed - 1; row >= hunk.first + common;
+         --row) {
+        deleteModelItemBox(row);
+        model->removeRow(row);
+    }
+    for (int i = common; i < hunk.inserted.size(); ++i) {
+        int row = hunk.first + i;
+        model->insertRow(row);
+        setRowGlyph(row, hunk.inserted.at(i));
+        createModelItemBox(row)->setVisible(boxesVisible);
+    }
+}
+
 /**
  * @brief reload current image/page from image file
   */
 bool ChildWidget::reloadImg() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    imageScene->removeItem(static_cast<QGraphicsItem*>(imageItem));
-    delete imageItem;
-    QImage image;
-    if (pageWidget->isHidden()) {  // one page - QImage is ok
-        image.load(imageFile);
-    } else {  // multipage - use leptonica
-        PIX    *pix;
-        pix = pixReadTiff(imageFile.toLocal8Bit().data(), currPage);
-        image = TessTools::PIX2qImage(pix);
-        pixDestroy(&pix);
-    }
-    imageItem = imageScene->addPixmap(QPixmap::fromImage(image));
+    // Decode file again - borrowers of old image keep their copy
+    PageImagePtr page = PageImage::load(imageFile, currPage);
+    if (!page)
+        return false;
+    pageImage = page;
+    pageImages.insert(currPage, pageImage.toWeakRef());
+    imageBinarized = false;
+    showPageImage();
     return true;
 }
 
+QHash<int, PageImagePtr> ChildWidget::loadedPageImages() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QHash<int, PageImagePtr> loaded;
+    QHash<int, QWeakPointer<PageImage> >::const_iterator it;
+    for (it = pageImages.constBegin(); it != pageImages.constEnd(); ++it) {
+        PageImagePtr image = it.value().toStrongRef();
+        if (image)
+            loaded.insert(it.key(), image);
+    }
+    return loaded;
+}
+
+qint64 ChildWidget::memoryUsage() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    qint64 bytes = 0;
+    QHash<int, PageImagePtr> loaded = loadedPageImages();
+    QHash<int, PageImagePtr>::const_iterator it;
+    for (it = loaded.constBegin(); it != loaded.constEnd(); ++it)
+        bytes += it.value()->memoryUsage();
+
+    QGraphicsPixmapItem* pixmapItem =
+            qgraphicsitem_cast<QGraphicsPixmapItem*>(imageItem);
+    if (pixmapItem) {
+        QPixmap pixmap = pixmapItem->pixmap();
+        bytes += qint64(pixmap.width()) * pixmap.height() *
+                qMax(1, pixmap.depth()) / 8;
+    }
+    BilevelImageItem* bilevelItem =
+            qgraphicsitem_cast<BilevelImageItem*>(imageItem);
+    if (bilevelItem)
+        bytes += bilevelItem->memoryUsage();
+
+    // table rows with their bboxes
+    bytes += qint64(model->rowCount()) * (kTableRowBytes + kBoxItemBytes);
+    if (shapeIndex)
+        bytes += shapeIndex->memoryUsage();
+
+    qint64 glyphs = 0;
+    for (int i = 0; i < pages.size(); ++i)
+        glyphs += pages.at(i).size();
+    for (int i = 0; i < m_undostack.size(); ++i)
+        for (int j = 0; j < m_undostack.at(i).m_pages.size(); ++j)
+            glyphs += m_undostack.at(i).m_pages.at(j).size();
+    for (int i = 0; i < m_redostack.size(); ++i)
+        for (int j = 0; j < m_redostack.at(i).m_pages.size(); ++j)
+            glyphs += m_redostack.at(i).m_pages.at(j).size();
+    bytes += glyphs * kGlyphBytes;
+    return bytes;
+}
+
+void ChildWidget::hibernate() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (hibernated || currPage >= pages.size())
+        return;
+    pages[currPage] = tableGlyphs();
+    hibernatedRow = table->currentIndex().row();
+
+    bool showFontColumns = isFontColumnsShown();
+    cleanTable();
+    initTable();
+    setShowFontColumns(showFontColumns);
+    clearBalloons();
+    resizer->disable();
+
+    if (imageItem) {
+        imageScene->removeItem(imageItem);
+        delete imageItem;
+        imageItem = 0;
+    }
+    pageImage.clear();
+    prefetched.clear();
+    // tesseract engine is the largest part of recognizer
+    delete recognizer;
+    recognizer = 0;
+    tessTools->releaseEngine();
+    hibernated = true;
+}
+
+void ChildWidget::wakeUp() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (!hibernated)
+        return;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    hibernated = false;
+    pageImage = pageImageFor(currPage);
+    if (pageImage)
+        showPageImage();
+    loadTable();
+    if (hibernatedRow >= 0 && hibernatedRow < model->rowCount()) {
+        table->setCurrentIndex(model->index(hibernatedRow, 0));
+        penSelectedBoxes();
+        updateSelectionRects();
+    }
+    QApplication::restoreOverrideCursor();
+}
+
+PageImagePtr ChildWidget::pageImageFor(int page) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (pageImage && pageImage->page() == page)
+        return pageImage;
+
+    PageImagePtr image = pageImages.value(page).toStrongRef();
+    if (!image) {
+        image = PageImage::load(imageFile, page);
+        if (image)
+            pageImages.insert(page, image.toWeakRef());
+    }
+    return image;
+}
+
+QImage ChildWidget::currentImage() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (!pageImage)
+        return QImage();
+    return imageBinarized ? pageImage->binarized() : pageImage->image();
+}
+
+void ChildWidget::showPageImage() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    setSceneImage(currentImage());
+}
+
+void ChildWidget::setSceneImage(const QImage& image) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (imageItem) {
+        imageScene->removeItem(imageItem);
+        delete imageItem;
+    }
+    if (image.format() == QImage::Format_Mono ||
+            image.format() == QImage::Format_MonoLSB) {
+        // 32 bpp pixmap of bilevel page would take 32 times more memory
+        imageItem = new BilevelImageItem(image);
+        imageScene->addItem(imageItem);
+    } else {
+        imageItem = imageScene->addPixmap(QPixmap::fromImage(image));
+    }
+}
+
 bool ChildWidget::save(const QString& fileName) {
     // TODO(zdenop): support multipage!
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
@@ -941,19 +1896,18 @@ bool ChildWidget::save(const QString& fileName) {
     QApplication::setOverrideCursor(Qt::WaitCursor);
 
     for (int i = 0; i < pages.size(); ++i) {
-        QVector<QStringList> page = pages[i];
-        for (int j = 0; j < page.size(); ++j) {
-            QStringList box = page[j];
-            for ( QStringList::Iterator it = box.begin(); it != box.end(); ++it ) {
-                out << *it;
-                if (it != (box.end() - 1))
-                    out << " ";
-            }
-            out << "\n";
-        }
+        const GlyphPage& page = pages.at(i);
+        for (int j = 0; j < page.size(); ++j)
+            out << page[j].toBoxLine() << "\n";
     }
 
     file.close();
+    // journaled edits are in box file now
+    if (QFileInfo(fileName).absoluteFilePath() == currentBoxFile())
+        journal->discard();
+    // box file changed - refresh cache, so next open does not parse it
+    if (!imageFile.isEmpty())
+        storeDocumentCache(fileName);
     QApplication::restoreOverrideCursor();
 
     modified = false;
@@ -964,91 +1918,14 @@ bool ChildWidget::save(const QString& fileName) {
 
 bool ChildWidget::splitToFeatureBF(const QString& fileName) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    // Todo(zdenop): there must be a smarter way how to do this
-
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    QString normBoxes = "", boldBoxes = "", italicBoxes = "", boldItaBoxes = "";
-    QString underBoxes = "";
-    for (int row = 0; row < model->rowCount(); ++row) {
-        QString letter = model->index(row, 0).data().toString();
-        int left = model->index(row, 1).data().toInt();
-        int bottom = model->index(row, 2).data().toInt();
-        int right = model->index(row, 3).data().toInt();
-        int top = model->index(row, 4).data().toInt();
-        int page = model->index(row, 5).data().toInt();
-        bool italic = model->index(row, 6).data().toBool();
-        bool bold = model->index(row, 7).data().toBool();
-        bool underline = model->index(row, 8).data().toBool();
-
-        if (bold && !italic) {
-            boldBoxes += QString("%1 %2 %3 %4 %5 %6\n").arg(letter).arg(left)
-                    .arg(imageHeight - bottom).arg(right).arg(imageHeight - top)
-                    .arg(page);
-        } else if (italic && !bold) {
-            italicBoxes += QString("%1 %2 %3 %4 %5 %6\n").arg(letter).arg(left)
-                    .arg(imageHeight - bottom).arg(right)
-                    .arg(imageHeight - top).arg(page);
-        } else if (italic && bold) {
-            boldItaBoxes += QString("%1 %2 %3 %4 %5 %6\n").arg(letter).arg(left)
-                    .arg(imageHeight - bottom).arg(right)
-                    .arg(imageHeight - top).arg(page);
-        } else if (underline) {
-            underBoxes += QString("%1 %2 %3 %4 %5 %6\n").arg(letter).arg(left)
-                    .arg(imageHeight - bottom).arg(right).arg(imageHeight - top)
-                    .arg(page);
-        } else {
-            normBoxes += QString("%1 %2 %3 %4 %5 %6\n").arg(letter).arg(left)
-                    .arg(imageHeight - bottom).arg(right).arg(imageHeight - top)
-                    .arg(page);
-        }
-    }
-
-    // find path + name + ext:
-    int dotCount = QFileInfo(fileName).fileName().count(".");
-    QStringList results = QFileInfo(fileName).fileName().split(".");
-    QString path, base, ext, imgExt;
-    path = QFileInfo(fileName).path() + QDir::separator();
-
-    if (dotCount < 3) {
-        base = QFileInfo(fileName).baseName();
-        ext = QFileInfo(fileName).completeSuffix();
-    } else  {
-        for (int dot = 0; dot < (dotCount - 1); ++dot) {
-            base += results[dot];
-            if (dot < (dotCount - 2))
-                base += ".";
-        }
-        ext = results[(dotCount - 1)] + "." + results[dotCount];
-    }
-    imgExt = ext;
-    imgExt.replace(imgExt.size() - 3 , 3, "png");
-
-    if (normBoxes.size()) {
-        saveString(path + base + "normal." + ext, normBoxes);
-        createStringImage(path + base + "normal." + imgExt, normBoxes);
-    }
-
-    if (boldBoxes.size()) {
-        saveString(path + base + "bold." + ext, boldBoxes);
-        createStringImage(path + base + "bold." + imgExt, boldBoxes);
-    }
-
-    if (italicBoxes.size()) {
-        saveString(path + base + "italic." + ext, italicBoxes);
-        createStringImage(path + base + "italic." + imgExt, italicBoxes);
-    }
-
-    if (boldItaBoxes.size()) {
-        saveString(path + base + "bolditalic." + ext, boldItaBoxes);
-        createStringImage(path + base + "bolditalic." + imgExt, boldItaBoxes);
-    }
-
-    if (underBoxes.size()) {
-        saveString(path + base + "underline." + ext, underBoxes);
-        createStringImage(path + base + "underline." + imgExt, underBoxes);
-    }
+    QVector<Glyph> glyphs;
+    glyphs.reserve(model->rowCount());
+    for (int row = 0; row < model->rowCount(); ++row)
+        glyphs.append(glyphAtRow(row));
 
-    QApplication::restoreOverrideCursor();
+    // files are written on worker; result is reported by job
+    JobScheduler::instance()->submit(
+        new SplitExportJob(this, boxFile, currentImage(), glyphs, fileName));
     return true;
 }
 
@@ -1071,35 +1948,6 @@ bool ChildWidget::saveString(const QString& fileName, const QString& qData) {
     return true;
 }
 
-/*
- * Copy defined boxes to new image file
- */
-
-bool ChildWidget::createStringImage(const QString& fileName,
-                                    const QString& qData) {
-    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QImage image = gItem2qImage();
-    QImage result = image;
-    result.fill(Qt::white);
-
-    QPainter painter(&result);
-    QStringList rowOfData = qData.split("\n");
-    for (int x = 0; x < rowOfData.size(); x++) {
-        QStringList rowData = rowOfData.at(x).split(" ");
-        if (rowData.size() < 4)
-            continue;  // skip rows without enough items
-        int x0 = rowData[1].toInt();
-        int y0 = imageHeight - rowData[2].toInt();
-        int w = rowData[3].toInt() - x0;
-        int h = rowData[4].toInt() - rowData[2].toInt() ;
-        QImage srcImage = image.copy(x0, y0 - h, w, h);
-        painter.drawImage(QPoint(x0, y0 - h), srcImage);
-    }
-    painter.end();
-    result.save(fileName, 0);
-    return true;
-}
-
 bool ChildWidget::importSPLToChild(const QString& fileName) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     QFile file(fileName);
@@ -1237,104 +2085,203 @@ bool ChildWidget::importTextToChild(const QString& fileName) {
 }
 
 /**
-   * Export symbols from table to text file. eType identify export format:
-   * 1 - one symbol per line
-   * 2 - one row per line
-   * 3 - one paragraph per line
-   * Returns false if export was not possible for some reason.
-   *
-   * Export will work only on one column text correctly.
-   * Words are identified if space between boxes is bigger than 6.
-   * Lines are identified if space between boxes is bigger than -6.
-   * Paragraph is identified based on left indentation (15) of from last left
-   * margin.
-*/
-bool ChildWidget::exportTxt(const int& eType, const QString& fileName) {
+ * Export normalized crops of all boxes on all pages for classifier training.
+ * Format is chosen by suffix of fileName: .tar gives archive of pgm files,
+ * other names atlas png sheets. See TrainingExport.
+ * Export runs as background job; result is reported to status bar.
+ */
+bool ChildWidget::exportTrainingGlyphs(const QString& fileName) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QFile file(fileName);
+    storePage();
 
-    if (!file.open(QFile::WriteOnly | QFile::Text)) {
-        QMessageBox::warning(
-                    this,
-                    SETTING_APPLICATION,
-                    tr("Cannot write file %1:\n%2.").arg(boxFile).arg(file.errorString()));
+    QHash<int, PageImagePtr> loaded = loadedPageImages();
+    TrainingExport::Options options = TrainingExport::Options::fromSettings();
+    if (QFileInfo(fileName).suffix().toLower() == "tar")
+        options.format = TrainingExport::Archive;
+
+    JobScheduler::instance()->submit(
+        new TrainingExportJob(this, boxFile, imageFile, pages, loaded,
+                              fileName, options));
+    return true;
+}
+
+/*
+ * Snap boxes of all pages to ink they contain in background (one undo
+ * step when job ends)
+ */
+bool ChildWidget::tightenAllBoxes() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    trackViewJob(JobScheduler::instance()->submit(
+        new TightenJob(this, boxFile, imageFile, pages, loadedPageImages())));
+    return true;
+}
+
+/*
+ * Replace document by result of job computed from snapshot (one undo
+ * step); result is dropped when document was edited since snapshot
+ */
+bool ChildWidget::applyJobDocument(const QVector<GlyphPage>& snapshot,
+                                   const QVector<GlyphPage>& document) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    if (pages != snapshot) {
+        emit statusBarMessage(tr("Document was edited while job ran; its "
+                                 "result was dropped."));
         return false;
     }
+    // result is shown in table of current page
+    wakeUp();
 
-    QTextStream out(&file);
-    out.setCodec("UTF-8");
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
-                       SETTING_ORGANIZATION, SETTING_APPLICATION);
-    int line_start_prev = 0;
-    int line_end_prev = 0;
-    int right_prev = -1;
-    int last_bottom = -1;
-    int wordSpace = settings.value("Text/WordSpace").toInt();
-    int paraIndent = settings.value("Text/ParagraphIndent").toInt();
+    UndoItem ui;
+    ui.m_eop = euoDocument;
+    ui.m_origrow = table->currentIndex().row();
+    ui.m_extrarow = -1;
+    ui.m_pages = pages;
+    if (!applyDocument(document))
+        return false;
+    m_undostack.push(ui);
+    documentWasModified();
+    emit boxChanged();
+    return true;
+}
 
-    for (int row = 0; row < model->rowCount(); ++row) {
-        QString letter = model->index(row, 0).data().toString();
-        int left = model->index(row, 1).data().toInt();
-        int bottom = model->index(row, 2).data().toInt();
-        int right = model->index(row, 3).data().toInt();
-        int top = model->index(row, 4).data().toInt();
+/*
+ * Sort boxes of current page into reading order (one undo step)
+ */
+bool ChildWidget::sortReadingOrder() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    GlyphPage glyphs = tableGlyphs();
+    QVector<int> order = PageStructure::readingOrder(
+                glyphs, PageStructure::isRightToLeft(glyphs));
+    int moved = 0;
+    for (int i = 0; i < order.size(); ++i)
+        if (order.at(i) != i)
+            ++moved;
+    if (moved == 0) {
+        emit statusBarMessage(tr("Page is already in reading order"));
+        return false;
+    }
 
-        if (last_bottom == -1)
-            last_bottom = top;
+    UndoItem ui;
+    ui.m_eop = euoOrder;
+    ui.m_origrow = table->currentIndex().row();
+    ui.m_extrarow = -1;
+    ui.m_order = order;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    permuteRows(order);
+    QApplication::restoreOverrideCursor();
+    m_undostack.push(ui);
+    documentWasModified();
 
-        if (eType == 1 && (right_prev != -1)) {
-            out << "\n";
-        }
+    if (ui.m_origrow >= 0 && ui.m_origrow < model->rowCount())
+        table->setCurrentIndex(model->index(ui.m_origrow, 0));
+    penSelectedBoxes();
+    updateSelectionRects();
+    emit boxChanged();
+    emit statusBarMessage(tr("%1 boxes moved").arg(moved));
+    return true;
+}
 
-        // line by line
-        if (eType == 2) {
-            if (((left - right_prev) >= wordSpace) && (right_prev != -1)) {
-                // new word
-                out << " ";
-            } else if (((left - right_prev) <= (2 * (left - right))) &&
-                       (right_prev != -1)) {
-                // new line -> if negative difference is bigger than double of letter
-                // width
-                out << "\n";
-            }
-        }
+/*
+ * Regenerate boxes of current page inside drawn rectangle in background
+ * (one undo step when job ends)
+ */
+bool ChildWidget::regenerateBoxesInRectangle() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (!drawnRectangle || !rectangle || !pageImage)
+        return false;
+    QRect region = rectangle->rect().toRect().intersected(
+                QRect(0, 0, imageWidth, imageHeight));
+    if (region.isEmpty())
+        return false;
+    // engine recognizes only rectangle; image stays set between calls
+    return generateBoxes(region, QString());
+}
 
-        if (eType == 3) {
-            if (((left - right_prev) >= wordSpace) && (right_prev != -1))
-                // new word
-                out << " ";
-
-            if (((left - right_prev) <= (2 * (left - right))) && (right_prev != -1)) {
-                // new line -> if negative difference is bigger than double of letter
-                // width
-                if (line_end_prev == 0)  // first line
-                    line_end_prev = right;
-                if ((left - line_start_prev >= paraIndent) ||  // distance from left
-                        (top - last_bottom >= paraIndent) ||   // distance between lines
-                        (abs(right - line_end_prev) >= (paraIndent / 2)))
-                    // distance from right
-                    out << "\n";
-                else
-                    out << " ";
-                line_start_prev = left;
-                line_end_prev = right_prev;
-            }
+/*
+ * Replace boxes of page inside region by generated ones (one undo step)
+ */
+void ChildWidget::applyGeneratedRegion(int page, int pageHeight,
+                                       const QRect& region,
+                                       const GlyphPage& generated) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    GlyphPage old = page < pages.size() ? pages.at(page) : GlyphPage();
+    GlyphPage kept;
+    int insertAt = -1;
+    int removed = 0;
+    for (int i = 0; i < old.size(); ++i) {
+        // box belongs to rectangle if its center is inside
+        if (region.contains(old.at(i).imageRect(pageHeight).center())) {
+            if (insertAt < 0)
+                insertAt = kept.size();
+            ++removed;
+        } else {
+            kept.append(old.at(i));
         }
+    }
+    if (insertAt < 0)
+        insertAt = kept.size();
+
+    QVector<GlyphPage> document = pages;
+    if (document.size() <= page)
+        document.resize(page + 1);
+    document[page] = kept.mid(0, insertAt) + generated + kept.mid(insertAt);
 
-        out << letter;
-        right_prev = right;
-        last_bottom = bottom;
+    // result is shown in table of current page
+    wakeUp();
+    UndoItem ui;
+    ui.m_eop = euoDocument;
+    ui.m_origrow = table->currentIndex().row();
+    ui.m_extrarow = -1;
+    ui.m_pages = pages;
+    if (!applyDocument(document)) {
+        emit statusBarMessage(tr("Boxes in rectangle are unchanged"));
+        return;
     }
+    m_undostack.push(ui);
+    documentWasModified();
 
-    out << "\n";
-    QApplication::restoreOverrideCursor();
+    if (page == currPage && !generated.isEmpty() &&
+            insertAt < model->rowCount())
+        table->setCurrentIndex(model->index(insertAt, 0));
+    penSelectedBoxes();
+    updateSelectionRects();
+    emit boxChanged();
+    emit statusBarMessage(tr("%1 boxes in rectangle replaced by %2")
+                          .arg(removed).arg(generated.size()));
+}
+
+/**
+   * Export symbols of all pages to text file. eType identify export format:
+   * 1 - one symbol per line
+   * 2 - one row per line
+   * 3 - one paragraph per line
+   * Export runs as background job on snapshot of pages; errors are
+   * reported when it ends.
+   *
+   * Export will work only on one column text correctly.
+   * Words are identified if space between boxes is bigger than WordSpace.
+   * Lines are identified if box moves left more than double of its width.
+   * Paragraph is identified based on left indentation (ParagraphIndent) of
+   * from last left margin. WordSpace and ParagraphIndent of 0 are estimated
+   * from x-height of line. See TextExport and PageStructure.
+*/
+bool ChildWidget::exportTxt(const int& eType, const QString& fileName) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+
+    JobScheduler::instance()->submit(
+        new TextExportJob(this, boxFile, pages,
+                          static_cast<TextExport::Mode>(eType),
+                          textExportOptions, fileName));
     return true;
 }
 
 bool ChildWidget::isBoxSelected() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    return selectionModel->hasSelection();
+    return !selectionTracker->isEmpty();
 }
 
 bool ChildWidget::isItalic() {
@@ -1408,88 +2355,85 @@ bool ChildWidget::isDrawRect() {
 
 void ChildWidget::setItalic(bool v) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QModelIndexList indexes = table->selectionModel()->selectedRows();
-    QModelIndex index;
+    QVector<int> rows = selectionTracker->rows();
     QFont letterFont;
 
-    foreach(index, indexes) {
+    foreach(int row, rows) {
         // IsItalic?
-        bool current = model->index(index.row(), 6).data().toBool();
+        bool current = model->index(row, 6).data().toBool();
         if (current != v) {
             UndoItem ui;
             ui.m_eop = euoChange;
-            ui.m_origrow = index.row();
+            ui.m_origrow = row;
 
-            for (int ii = 0; ii < model->columnCount(); ii++)
+            for (int ii = 0; ii < model->columnCount() - 1; ii++)
                 ui.m_vdata[ii] = model->index(ui.m_origrow, ii).data();
 
             m_undostack.push(ui);
 
-            letterFont = model->data(model->index(index.row(), 0, QModelIndex()),
+            letterFont = model->data(model->index(row, 0, QModelIndex()),
                                      Qt::FontRole).value<QFont>();
             letterFont.setItalic(v);
-            model->setData(model->index(index.row(), 0, QModelIndex()), letterFont,
+            model->setData(model->index(row, 0, QModelIndex()), letterFont,
                            Qt::FontRole);
-            model->setData(model->index(index.row(), 6, QModelIndex()), v);
+            model->setData(model->index(row, 6, QModelIndex()), v);
         }
     }
 }
 
 void ChildWidget::setBolded(bool v) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QModelIndexList indexes = table->selectionModel()->selectedRows();
-    QModelIndex index;
+    QVector<int> rows = selectionTracker->rows();
     QFont letterFont;
 
-    foreach(index, indexes) {
+    foreach(int row, rows) {
         // IsBool?
-        bool current = model->index(index.row(), 7).data().toBool();
+        bool current = model->index(row, 7).data().toBool();
         if (current != v) {
             UndoItem ui;
             ui.m_eop = euoChange;
-            ui.m_origrow = index.row();
+            ui.m_origrow = row;
 
-            for (int ii = 0; ii < model->columnCount(); ii++)
+            for (int ii = 0; ii < model->columnCount() - 1; ii++)
                 ui.m_vdata[ii] = model->index(ui.m_origrow, ii).data();
 
             m_undostack.push(ui);
 
-            letterFont = model->data(model->index(index.row(), 0, QModelIndex()),
+            letterFont = model->data(model->index(row, 0, QModelIndex()),
                                      Qt::FontRole).value<QFont>();
             letterFont.setBold(v);
 
-            model->setData(model->index(index.row(), 0, QModelIndex()), letterFont,
+            model->setData(model->index(row, 0, QModelIndex()), letterFont,
                            Qt::FontRole);
-            model->setData(model->index(index.row(), 7, QModelIndex()), v);
+            model->setData(model->index(row, 7, QModelIndex()), v);
         }
     }
 }
 
 void ChildWidget::setUnderline(bool v) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QModelIndexList indexes = table->selectionModel()->selectedRows();
-    QModelIndex index;
+    QVector<int> rows = selectionTracker->rows();
     QFont letterFont;
 
-    foreach(index, indexes) {
+    foreach(int row, rows) {
         // IsUnderLine?
-        bool current = model->index(index.row(), 8).data().toBool();
+        bool current = model->index(row, 8).data().toBool();
         if (current != v) {
             UndoItem ui;
             ui.m_eop = euoChange;
-            ui.m_origrow = index.row();
+            ui.m_origrow = row;
 
-            for (int ii = 0; ii < model->columnCount(); ii++)
+            for (int ii = 0; ii < model->columnCount() - 1; ii++)
                 ui.m_vdata[ii] = model->index(ui.m_origrow, ii).data();
 
             m_undostack.push(ui);
 
-            letterFont = model->data(model->index(index.row(), 0, QModelIndex()),
+            letterFont = model->data(model->index(row, 0, QModelIndex()),
                                      Qt::FontRole).value<QFont>();
             letterFont.setUnderline(v);
-            model->setData(model->index(index.row(), 0, QModelIndex()), letterFont,
+            model->setData(model->index(row, 0, QModelIndex()), letterFont,
                            Qt::FontRole);
-            model->setData(model->index(index.row(), 8, QModelIndex()), v);
+            model->setData(model->index(row, 8, QModelIndex()), v);
         }
     }
 }
@@ -1499,24 +2443,93 @@ void ChildWidget::setUnderline(bool v) {
  */
 void ChildWidget::binarizeImage() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    imageScene->removeItem(imageItem);
-    QImage image = gItem2qImage();
-    delete imageItem;
-    QImage bImage = TessTools::GetThresholded(image);
-    imageItem = imageScene->addPixmap(QPixmap::fromImage(bImage));
+    if (!pageImage)
+        return;
+
+    BinarizeDialog dialog(this, Binarizer::Options::fromSettings());
+    connect(&dialog, SIGNAL(optionsChanged()), this,
+            SLOT(previewBinarization()));
+    // show preview of current settings as soon as dialog is shown
+    QTimer::singleShot(0, &dialog, SLOT(emitOptionsChanged()));
+
+    int accepted = dialog.exec();
+    JobScheduler::instance()->cancel(previewJob);
+    previewJob = 0;
+    if (accepted == QDialog::Accepted) {
+        Binarizer::Options options = dialog.options();
+        options.save();
+        // Binarized version is cached with page image when job finishes;
+        // preview stays shown meanwhile
+        trackViewJob(JobScheduler::instance()->submit(
+            new BinarizeJob(this, pageImage, options, 0)));
+    } else {
+        showPageImage();
+    }
+}
+
+void ChildWidget::previewBinarization() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    BinarizeDialog* dialog = qobject_cast<BinarizeDialog*>(sender());
+    if (!dialog || !pageImage)
+        return;
+    // result of older settings is not interesting anymore
+    JobScheduler::instance()->cancel(previewJob);
+    previewJob = 0;
+    if (!dialog->isPreviewEnabled()) {
+        dialog->setPreviewInfo(QString());
+        showPageImage();
+        return;
+    }
+
+    dialog->setPreviewInfo(tr("Binarizing..."));
+    previewJob = JobScheduler::instance()->submit(
+        new BinarizeJob(this, pageImage, dialog->options(), dialog));
+    trackViewJob(previewJob);
+}
+
+void ChildWidget::trackViewJob(int id) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    JobScheduler* scheduler = JobScheduler::instance();
+    for (int i = viewJobs.size() - 1; i >= 0; --i) {
+        JobScheduler::Info info = scheduler->info(viewJobs.at(i));
+        // unknown id: ended long ago
+        if (info.id == 0 || info.state >= JobScheduler::Finished)
+            viewJobs.removeAt(i);
+    }
+    viewJobs.append(id);
+}
+
+void ChildWidget::cancelViewJobs() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    foreach (int id, viewJobs)
+        JobScheduler::instance()->cancel(id);
+    viewJobs.clear();
+    previewJob = 0;
 }
 
 /*
- * Convert QGraphicsItem to QImage
+ * Decode previous and next page in background; decoded pages are kept
+ * only while they are neighbours of current page
  */
-QImage ChildWidget::gItem2qImage(){
+void ChildWidget::prefetchPages() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QImage image(imageItem->boundingRect().size().toSize(),  QImage::Format_RGB32);
-    QPainter painter(&image);
-    QStyleOptionGraphicsItem styleOption;
-    imageItem->paint(&painter, &styleOption);
-    painter.end();
-    return image;
+    QMutableHashIterator<int, PageImagePtr> it(prefetched);
+    while (it.hasNext()) {
+        it.next();
+        if (qAbs(it.key() - currPage) != 1)
+            it.remove();
+    }
+    for (int page = currPage - 1; page <= currPage + 1; page += 2) {
+        if (page < 0 || page >= imagePageCount || prefetched.contains(page))
+            continue;
+        PageImagePtr image = pageImages.value(page).toStrongRef();
+        if (image) {
+            prefetched.insert(page, image);
+            continue;
+        }
+        trackViewJob(JobScheduler::instance()->submit(
+            new PrefetchJob(this, imageFile, page)));
+    }
 }
 
 void ChildWidget::setSelectionRect() {
@@ -1552,7 +2565,7 @@ void ChildWidget::setZoom(float scale) {
 void ChildWidget::zoomIn() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     imageView->scale(1.2, 1.2);
-    if (selectionModel->hasSelection())
+    if (!selectionTracker->isEmpty())
         imageView->ensureVisible(modelItemBox());
     setZoomStatus();
 }
@@ -1560,7 +2573,7 @@ void ChildWidget::zoomIn() {
 void ChildWidget::zoomOut() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     imageView->scale(1 / 1.2, 1 / 1.2);
-    if (selectionModel->hasSelection())
+    if (!selectionTracker->isEmpty())
         imageView->ensureVisible(modelItemBox());
     setZoomStatus();
 }
@@ -1588,7 +2601,7 @@ void ChildWidget::zoomToHeight() {
     float zoomFactor = viewHeight / imageHeight;
 
     setZoom(zoomFactor);
-    if (selectionModel->hasSelection())
+    if (!selectionTracker->isEmpty())
         imageView->ensureVisible(modelItemBox());
 }
 
@@ -1598,23 +2611,23 @@ void ChildWidget::zoomToWidth() {
     float zoomFactor = viewWidth / imageWidth;
 
     setZoom(zoomFactor);
-    if (selectionModel->hasSelection())
+    if (!selectionTracker->isEmpty())
         imageView->ensureVisible(modelItemBox());
 }
 
 void ChildWidget::zoomOriginal() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     setZoom(1);
-    if (selectionModel->hasSelection())
+    if (!selectionTracker->isEmpty())
         imageView->ensureVisible(modelItemBox());
 }
 
 void ChildWidget::zoomToSelection() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    if (selectionModel->hasSelection()) {
+    if (!selectionTracker->isEmpty()) {
         imageView->fitInView(modelItemBox(), Qt::KeepAspectRatio);
         imageView->scale(1 / 1.1, 1 / 1.1);    // make small border
-        if (selectionModel->hasSelection())
+        if (!selectionTracker->isEmpty())
             imageView->ensureVisible(modelItemBox());
         imageView->centerOn(modelItemBox());
         setZoomStatus();
@@ -1710,9 +2723,9 @@ void ChildWidget::drawRectangle(bool checked) {
 
 QGraphicsRectItem* ChildWidget::modelItemBox(int row) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    if (selectionModel->hasSelection()) {
+    if (!selectionTracker->isEmpty()) {
         if (row == -1)
-            row = table->selectionModel()->selectedRows().last().row();
+            row = selectionTracker->currentRow();
         return model->index(row, 9).data().value<QGraphicsRectItem*>();
     } else {
         return NULL;
@@ -1757,12 +2770,14 @@ void ChildWidget::drawBoxes() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     boxesVisible = !boxesVisible;
     // workaround:  modelItemBox(row) requires selection to not segfault
-    if (!selectionModel->hasSelection())
+    if (selectionTracker->isEmpty())
         table->setCurrentIndex(model->index(0, 0));
     for (int row = 0; row < model->rowCount(); ++row)
         modelItemBox(row)->setVisible(boxesVisible);
-    if (boxesVisible)
+    if (boxesVisible) {
+        penSelectedBoxes();
         updateSelectionRects();
+    }
 }
 
 void ChildWidget::mousePressEvent(QMouseEvent* event) {
@@ -1874,10 +2889,9 @@ void ChildWidget::mouseReleaseEvent(QMouseEvent* /*event*/) {
     updateSelectionRects();
 
     // Focus the last symbol in the selection
-    if (!table->selectionModel()->hasSelection() &&
-            table->selectionModel()->selection().size() > 0)
+    if (!selectionTracker->isEmpty())
         table->selectionModel()->setCurrentIndex(
-                    table->selectionModel()->selectedRows().last(),
+                    model->index(selectionTracker->currentRow(), 0),
                     QItemSelectionModel::NoUpdate);
 }
 
@@ -1940,7 +2954,7 @@ void ChildWidget::moveSymbolRow(int direction) {
 
     int currentRow = index.row();
     // check if any row is selected
-    if (currentRow < 0)
+    if (currentRow < 0 || direction == 0)
         return;
 
     // check top/bottom movements
@@ -1950,59 +2964,46 @@ void ChildWidget::moveSymbolRow(int direction) {
         emit statusBarMessage(message);
         return;
     } else {
-        if (abs(direction) == 1) {  // This works only for moveUp/moveDown!!!
-            UndoItem ui;
-            ui.m_eop = euoReplace;
-            ui.m_origrow = currentRow;
-            ui.m_extrarow = currentRow + direction;
-
-            for (int j = 0; j < model->columnCount() - 1; j++) {
-                ui.m_vdata[j] = model->index(currentRow, j).data();
-                ui.m_vextradata[j] = model->index(ui.m_extrarow, j).data();
-
-                model->setData(model->index(ui.m_extrarow, j), ui.m_vdata[j]);
-                model->setData(model->index(ui.m_origrow, j), ui.m_vextradata[j]);
-            }
-
-            m_undostack.push(ui);
-            updateModelItemBox(ui.m_extrarow);
-            updateModelItemBox(ui.m_origrow);
-            // activate new row
-            table->setCurrentIndex(model->index(ui.m_extrarow, 0));
-        } else {
-            // TODO(zdenop): implement undo, or rewrite whole function
-            UndoItem ui;
-            ui.m_eop = euoMove;
-            ui.m_origrow = currentRow;
-            ui.m_extrarow = currentRow + direction;
-
-            int newRow = ui.m_extrarow;
-            if (direction > 0)  // insertRow change row id!
-                newRow++;
-            else
-                currentRow++;
-            model->insertRow(newRow);
-
-            for (int i = 0; i < (model->columnCount() - 1); ++i) {
-                ui.m_vdata[i] = model->index(currentRow, i).data();
-                model->setData(model->index(newRow, i),
-                               model->index(currentRow, i).data());
-            }
-            m_undostack.push(ui);
-
-            QGraphicsRectItem* rectItem = createModelItemBox(newRow);
-            // activate new row
-            table->setCurrentIndex(model->index(newRow, 0));
-            if (boxesVisible)
-                rectItem->show();
-            // delete original row
-            model->removeRow(currentRow);
-        }
+        UndoItem ui;
+        ui.m_eop = euoMove;
+        ui.m_origrow = currentRow;
+        ui.m_extrarow = currentRow + direction;
+        moveRow(ui.m_origrow, ui.m_extrarow);
+        m_undostack.push(ui);
+        // activate new row
+        table->setCurrentIndex(model->index(ui.m_extrarow, 0));
         updateSelectionRects();
-        emit modifiedChanged();
+        documentWasModified();
     }
 }
 
+void ChildWidget::moveRow(int from, int to) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (from == to)
+        return;
+    // moved items carry their values, journal gets single move record
+    journal->setSuspended(true);
+    QList<QStandardItem*> items = model->takeRow(from);
+    model->insertRow(to, items);
+    journal->setSuspended(false);
+    journal->recordMove(from, to);
+}
+
+void ChildWidget::permuteRows(const QVector<int>& order) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QVector<QList<QStandardItem*> > rows(order.size());
+    table->setUpdatesEnabled(false);
+    journal->setSuspended(true);
+    // taking rows from the end does not shift remaining rows
+    for (int row = order.size() - 1; row >= 0; --row)
+        rows[row] = model->takeRow(row);
+    for (int i = 0; i < order.size(); ++i)
+        model->appendRow(rows.at(order.at(i)));
+    journal->setSuspended(false);
+    table->setUpdatesEnabled(true);
+    journal->recordPage(currPage, tableGlyphs());
+}
+
 void ChildWidget::copyFromCell() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     QClipboard* clipboard = QApplication::clipboard();
@@ -2018,7 +3019,7 @@ void ChildWidget::pasteToCell() {
     ui.m_eop = euoChange;
     ui.m_origrow = index.row();
 
-    for (int i = 0; i < model->columnCount(); i++)
+    for (int i = 0; i < model->columnCount() - 1; i++)
         ui.m_vdata[i] = model->index(ui.m_origrow, i).data();
 
     // do not paste string to int fields
@@ -2032,6 +3033,7 @@ void ChildWidget::pasteToCell() {
     if (index.column() == 0) {
         model->setData(table->currentIndex(), clipboard->text());
         m_undostack.push(ui);
+        offerSimilarLabels(index.row());
     }
 
     if (directTypingMode)
@@ -2059,12 +3061,13 @@ bool ChildWidget::directType(QKeyEvent* event) {
             // enter only text
             model->setData(model->index(index.row(), 0, QModelIndex()),
                            event->text());
+            offerSimilarLabels(index.row());
 
             UndoItem ui;
             ui.m_eop = euoChange;
             ui.m_origrow = index.row();
 
-            for (int i = 0; i < model->columnCount(); i++)
+            for (int i = 0; i < model->columnCount() - 1; i++)
                 ui.m_vdata[i] = model->index(ui.m_origrow, i).data();
 
             m_undostack.push(ui);
@@ -2120,7 +3123,7 @@ void ChildWidget::insertSymbol() {
     ui.m_origrow = newrow;
 
     // For redo
-    for (int ii = 0; ii < model->columnCount(); ii++)
+    for (int ii = 0; ii < model->columnCount() - 1; ii++)
         ui.m_vdata[ii] = model->index(ui.m_origrow, ii).data();
 
     m_undostack.push(ui);
@@ -2131,6 +3134,7 @@ void ChildWidget::insertSymbol() {
     table->setCurrentIndex(model->index(newrow, 0));
     table->setFocus();
 
+    penSelectedBoxes();
     updateSelectionRects();
     emit modifiedChanged();
 }
@@ -2146,7 +3150,7 @@ void ChildWidget::splitSymbol() {
     ui.m_origrow = index.row();
     ui.m_extrarow = ui.m_origrow + 1;
 
-    for (int i = 0; i < model->columnCount(); i++)
+    for (int i = 0; i < model->columnCount() - 1; i++)
         ui.m_vdata[i] = model->index(ui.m_origrow, i).data();
 
     m_undostack.push(ui);
@@ -2177,20 +3181,21 @@ void ChildWidget::splitSymbol() {
     QGraphicsRectItem* rectItem = createModelItemBox(index.row() + 1);
     if (boxesVisible)
         rectItem->show();
+    penSelectedBoxes();
     updateSelectionRects();
     emit modifiedChanged();
 }
 
 void ChildWidget::joinSymbol() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QModelIndexList indexes = selectionModel->selectedRows();
-    if (indexes.empty())
+    QVector<int> rows = selectionTracker->rows();
+    if (rows.empty())
         return;
     // On single selected item join with the next ...
-    if (indexes.size() == 1) {
+    if (rows.size() == 1) {
         // ... if selected is not the last
-        if (indexes.back().row() != model->rowCount() - 1) {
-            indexes.push_back(model->index(indexes.back().row() + 1, 0));
+        if (rows.back() != model->rowCount() - 1) {
+            rows.push_back(rows.back() + 1);
         } else {
             return;
         }
@@ -2206,15 +3211,15 @@ void ChildWidget::joinSymbol() {
     bool bold = false;
     bool underline = false;
 
-    int targetRow = indexes.front().row();
+    int targetRow = rows.front();
 
     QStack<UndoItem> joinstack;
     UndoItem tempJoin;
     tempJoin.m_origrow = targetRow;
     tempJoin.m_eop = euoChange;
 
-    for (int i = 0; i < indexes.size(); ++i) {
-        int row = indexes[i].row();
+    for (int i = 0; i < rows.size(); ++i) {
+        int row = rows[i];
         letter += model->data(model->index(row, 0)).toString();
         left = my_min(left, model->data(model->index(row, 1)).toInt());
         bottom = my_max(bottom, model->data(model->index(row, 2)).toInt());
@@ -2251,8 +3256,8 @@ void ChildWidget::joinSymbol() {
 
     selectionModel->clearSelection();
 
-    int rowstodelete = indexes.size();
-    int rownum = indexes.front().row();
+    int rowstodelete = rows.size();
+    int rownum = rows.front();
 
     // Keep the first row with joined data
     rownum++;
@@ -2265,6 +3270,7 @@ void ChildWidget::joinSymbol() {
 
     table->setCurrentIndex(model->index(targetRow, 0));
     table->setFocus();
+    penSelectedBoxes();
     updateSelectionRects();
     emit modifiedChanged();
 }
@@ -2274,7 +3280,7 @@ void ChildWidget::deleteSymbolByRow(int row) {
     UndoItem ui;
     ui.m_eop = euoDelete;
     ui.m_origrow = row;
-    for (int j = 0; j < model->columnCount(); ++j)
+    for (int j = 0; j < model->columnCount() - 1; ++j)
         ui.m_vdata[j] = model->index(ui.m_origrow, j).data();
     m_undostack.push(ui);
 
@@ -2284,27 +3290,26 @@ void ChildWidget::deleteSymbolByRow(int row) {
 
 void ChildWidget::deleteSymbol() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QModelIndexList indexes = selectionModel->selectedRows();
-    if (indexes.empty())
+    QVector<int> rows = selectionTracker->rows();
+    if (rows.empty())
         return;
     // This prevents deselecting dead rows in selectionChanged() on removeRow()
     selectionModel->clearSelection();
 
-    int rowstodelete = indexes.size();
-    int rownum = indexes.front().row();
-    int afterRow = my_min(indexes.back().row() - indexes.size() + 1,
+    int afterRow = my_min(rows.back() - rows.size() + 1,
                           model->rowCount() - 1);
 
-    while (!indexes.empty())
+    while (!rows.empty())
     {
-        deleteSymbolByRow(indexes.back().row());
-        indexes.pop_back();
+        deleteSymbolByRow(rows.back());
+        rows.pop_back();
     }
 
     if (model->rowCount() != 0) {
         table->setCurrentIndex(model->index(afterRow, 0));
     }
     table->setFocus();
+    penSelectedBoxes();
     updateSelectionRects();
     documentWasModified();
 }
@@ -2336,8 +3341,10 @@ void ChildWidget::moveTo() {
         else
             destRow = string.toInt() - 1;
 
-        if (destRow > model->rowCount())
+        if (destRow >= model->rowCount())
             destRow = model->rowCount() - 1;
+    } else {
+        return;
     }
 
     moveSymbolRow(destRow - sourceRow);
@@ -2398,6 +3405,257 @@ void ChildWidget::statistics()
     statisticsDialog->activateWindow();
 }
 
+/*
+ * Empty issue list dialog (created on first use) titled title
+ */
+void ChildWidget::openIssueDialog(const QString& title) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (!issueDialog) {
+        issueDialog = new IssueListDialog(this);
+        connect(issueDialog, SIGNAL(issueActivated(int, int)), this,
+                SLOT(goToBox(int, int)));
+    }
+    issueDialog->clear();
+    issueDialog->setWindowTitle(title);
+}
+
+void ChildWidget::showIssueSummary(const QString& summary) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    issueDialog->setSummary(summary);
+    issueDialog->show();
+    issueDialog->raise();
+    issueDialog->activateWindow();
+    emit statusBarMessage(summary);
+}
+
+/*
+ * Check boxes of all pages against image in background; problems are
+ * listed when job ends
+ */
+bool ChildWidget::validateBoxes() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    trackViewJob(JobScheduler::instance()->submit(
+        new ValidateJob(this, boxFile, imageFile, pages, loadedPageImages(),
+                        BoxValidator::Options::fromSettings())));
+    return true;
+}
+
+bool ChildWidget::checkLabels() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    trackViewJob(JobScheduler::instance()->submit(
+        new LabelCheckJob(this, boxFile, imageFile, pages,
+                          loadedPageImages(),
+                          LabelChecker::Options::fromSettings())));
+    return true;
+}
+
+void ChildWidget::showGallery(const QModelIndex& index) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (!index.isValid())
+        return;
+    QString letter = statisticsModelProxy->index(index.row(), 0)
+                     .data().toString();
+    if (letter.isEmpty())
+        return;
+
+    storePage();
+    QVector<GlyphGalleryModel::Item> items;
+    for (int page = 0; page < pages.size(); ++page) {
+        const GlyphPage& glyphs = pages.at(page);
+        for (int row = 0; row < glyphs.size(); ++row) {
+            if (glyphs.at(row).letter != letter)
+                continue;
+            GlyphGalleryModel::Item item;
+            item.page = page;
+            item.row = row;
+            item.glyph = glyphs.at(row);
+            items.append(item);
+        }
+    }
+
+    if (!galleryDialog) {
+        galleryDialog = new GlyphGalleryDialog(this);
+        connect(galleryDialog, SIGNAL(glyphActivated(int, int)), this,
+                SLOT(goToBox(int, int)));
+    }
+    galleryDialog->setGlyphs(letter, imageFile, loadedPageImages(), items);
+    galleryDialog->show();
+    galleryDialog->raise();
+    galleryDialog->activateWindow();
+}
+
+/*
+ * Hash boxes of whole document in background; lookups use previous index
+ * until new one is built
+ */
+void ChildWidget::buildShapeIndex() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    JobScheduler* scheduler = JobScheduler::instance();
+    // snapshot is outdated (e.g. by reload), so newer build replaces it
+    if (shapeIndexJob >= 0)
+        scheduler->cancel(shapeIndexJob);
+    shapeIndexJob = scheduler->submit(
+        new ShapeIndexJob(this, ++shapeIndexGeneration, boxFile, imageFile,
+                          pages, loadedPageImages()));
+    trackViewJob(shapeIndexJob);
+}
+
+/*
+ * Boxes of index similar to glyph; glyph which is not indexed (edited
+ * after build) has none, so GUI thread never hashes page itself
+ */
+QVector<ShapeIndex::Entry> ChildWidget::similarShapes(const Glyph& glyph) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    quint64 hash;
+    if (!shapeIndex || !shapeIndex->hashOf(currPage, glyph, &hash))
+        return QVector<ShapeIndex::Entry>();
+    return shapeIndex->similar(hash, glyph.right - glyph.left,
+                               glyph.top - glyph.bottom);
+}
+
+void ChildWidget::offerSimilarLabels(int row) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (!shapeIndex || row < 0 || row >= model->rowCount())
+        return;
+    Glyph glyph = glyphAtRow(row);
+    // box itself is one of similar shapes
+    int similar = similarShapes(glyph).size() - 1;
+    if (similar <= 0)
+        return;
+    labelSource = glyph;
+    labelSourcePage = currPage;
+    emit statusBarMessage(tr("%1 boxes have the same shape; \"Label similar "
+                             "shapes\" gives them letter '%2'.")
+                          .arg(similar).arg(glyph.letter));
+}
+
+bool ChildWidget::labelSimilarShapes() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (!shapeIndex) {
+        emit statusBarMessage(tr("Shapes of boxes are still being "
+                                 "indexed."));
+        return false;
+    }
+    int row = -1;
+    if (labelSourcePage == currPage) {
+        for (int r = 0; r < model->rowCount() && row < 0; ++r) {
+            Glyph glyph = glyphAtRow(r);
+            if (glyph.left == labelSource.left &&
+                    glyph.bottom == labelSource.bottom &&
+                    glyph.right == labelSource.right &&
+                    glyph.top == labelSource.top)
+                row = r;
+        }
+    }
+    if (row < 0)
+        row = selectionModel->currentIndex().row();
+    if (row < 0 || row >= model->rowCount())
+        return false;
+
+    storePage();
+    trackViewJob(JobScheduler::instance()->submit(
+        new LabelShapesJob(this, boxFile, imageFile, pages, shapeIndex,
+                           currPage, pageImage, glyphAtRow(row))));
+    return true;
+}
+
+void ChildWidget::goToBox(int page, int row) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (page != currPage) {
+        if (page < 0 || page >= imagePageCount)
+            return;
+        // changes page through slotChangePage()
+        currentPage->setValue(page + 1);
+        if (page != currPage)
+            return;
+    }
+    if (row < 0 || row >= model->rowCount())
+        return;
+    table->setCurrentIndex(model->index(row, 0));
+    table->scrollTo(model->index(row, 0));
+    updateSelectionRects();
+}
+
+const PageStructure& ChildWidget::currentStructure() {
+    if (pageStructure.isDirty())
+        pageStructure.update(ModelGlyphSource(model, imageHeight));
+    return pageStructure;
+}
+
+void ChildWidget::selectRows(int first, int last) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QItemSelection selection(model->index(first, 0),
+                             model->index(last, model->columnCount() - 1));
+    selectionModel->select(selection, QItemSelectionModel::ClearAndSelect |
+                           QItemSelectionModel::Rows);
+    selectionModel->setCurrentIndex(model->index(first, 0),
+                                    QItemSelectionModel::NoUpdate);
+    table->scrollTo(model->index(first, 0));
+    table->setFocus();
+    updateSelectionRects();
+}
+
+void ChildWidget::selectLine() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    const PageStructure& structure = currentStructure();
+    int line = structure.lineOf(table->currentIndex().row());
+    if (line < 0)
+        return;
+    selectRows(structure.line(line).first, structure.line(line).last);
+}
+
+void ChildWidget::selectWord() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    int first, last;
+    if (currentStructure().wordRange(table->currentIndex().row(),
+                                     &first, &last))
+        selectRows(first, last);
+}
+
+void ChildWidget::nextLine() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    const PageStructure& structure = currentStructure();
+    int line = structure.lineOf(table->currentIndex().row());
+    if (line < 0 || line + 1 >= structure.lineCount())
+        return;
+    int row = structure.line(line + 1).first;
+    table->setCurrentIndex(model->index(row, 0));
+    table->scrollTo(model->index(row, 0));
+    updateSelectionRects();
+}
+
+void ChildWidget::previousLine() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    const PageStructure& structure = currentStructure();
+    int line = structure.lineOf(table->currentIndex().row());
+    if (line <= 0)
+        return;
+    int row = structure.line(line - 1).first;
+    table->setCurrentIndex(model->index(row, 0));
+    table->scrollTo(model->index(row, 0));
+    updateSelectionRects();
+}
+
+void ChildWidget::structureRowsInserted(const QModelIndex&, int first,
+                                        int last) {
+    pageStructure.rowsInserted(first, last - first + 1);
+}
+
+void ChildWidget::structureRowsRemoved(const QModelIndex&, int first,
+                                       int last) {
+    pageStructure.rowsRemoved(first, last - first + 1);
+}
+
+void ChildWidget::structureDataChanged(const QModelIndex& topLeft,
+                                       const QModelIndex& bottomRight) {
+    // only letter and coordinates matter (not styles or bbox item)
+    if (topLeft.column() <= 4)
+        pageStructure.rowsChanged(topLeft.row(), bottomRight.row());
+}
+
 QString ChildWidget::userFriendlyCurrentFile() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     return strippedName(boxFile);
@@ -2456,26 +3714,36 @@ void ChildWidget::emitBoxChanged() {
     emit boxChanged();
 }
 
-void ChildWidget::selectionChanged(const QItemSelection& /*selected*/,
+void ChildWidget::selectionChanged(const QItemSelection& selected,
                                    const QItemSelection& deselected) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    // Set deselected bboxes' colors back to normal
-    QModelIndexList indexes = deselected.indexes();
     if (!modelItemBox()) {
         // hide rectangle of last selected item
-        if (!indexes.empty()) {
-            QGraphicsRectItem* rectItem =
-                    model->index(indexes[0].row(), 9).data().value<QGraphicsRectItem*>();
-            rectItem->hide();
-        }
+        if (!deselected.isEmpty())
+            model->index(deselected.first().top(), 9).data()
+                    .value<QGraphicsRectItem*>()->hide();
         return;
     }
-    for (int i = 0; i < indexes.size(); ++i)
-        if (indexes[i].column() == 0) {
-            modelItemBox(indexes[i].row())->setPen(QPen(boxColor));
+    // only boxes of selection delta are repainted
+    for (int i = 0; i < deselected.size(); ++i) {
+        const QItemSelectionRange& range = deselected.at(i);
+        if (range.left() != 0)
+            continue;
+        for (int row = range.top(); row <= range.bottom(); ++row) {
+            QGraphicsRectItem* rectItem =
+                    model->index(row, 9).data().value<QGraphicsRectItem*>();
+            rectItem->setPen(QPen(boxColor));
             if (!boxesVisible)
-                modelItemBox(indexes[i].row())->hide();
+                rectItem->hide();
         }
+    }
+    for (int i = 0; i < selected.size(); ++i) {
+        const QItemSelectionRange& range = selected.at(i);
+        if (range.left() != 0)
+            continue;
+        for (int row = range.top(); row <= range.bottom(); ++row)
+            penSelectedBox(row);
+    }
     updateSelectionRects();
 
     emit boxChanged();
@@ -2483,111 +3751,71 @@ void ChildWidget::selectionChanged(const QItemSelection& /*selected*/,
 
 void ChildWidget::clearBalloons() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    for (int i = 0; i < balloons.size(); ++i) {
-        imageScene->removeItem(balloons[i].symbol);
-        delete balloons[i].symbol;
-        for (int j = 0; j < BalloonSymbol::haloCompCount; ++j) {
-            imageScene->removeItem(balloons[i].halo[j]);
-            delete balloons[i].halo[j];
-        }
-    }
-    balloons.clear();
+    balloonItem->clear();
 }
 
 void ChildWidget::updateBalloons() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    int idx = table->selectionModel()->selectedRows().last().row();
+    int idx = selectionTracker->currentRow();
     int min_idx = my_max(idx - balloonCount/2, 0);
     int max_idx = my_min(idx + balloonCount/2, model->rowCount() - 1);
+    const PageStructure& structure = currentStructure();
 
-    // calculate baseline for symbols based on selected symbol
-    int baseline = 0;
-    for (int i = min_idx; i <= max_idx; ++i) {
-        if (baseline == 0) {
-            baseline = model->index(i, 4).data().toInt();
-        } else {
-            baseline = my_min(baseline, model->index(i, 4).data().toInt());
-        }
-    }
-
+    balloonItem->clear();
     for (int i = min_idx; i <= max_idx; ++i) {
-        balloons.push_back(BalloonSymbol());
-
         QString letter = model->index(i, 0).data().toString();
         int left = model->index(i, 1).data().toInt();
-        int top = model->index(i, 4).data().toInt();
-        // TODO(daemons2000): Bad when (i == 0)
-        int botPrev = model->index(i-1, 2).data().toInt();
-        if (top > botPrev) {
-            baseline = top;  // new line? => problem with '", o'
-        }
+        // symbols of one text line are placed above top of the line
+        int line = structure.lineOf(i);
+        int baseline = (line >= 0) ? imageHeight - structure.line(line).top
+                                   : model->index(i, 4).data().toInt();
 
-        balloons.back().symbol = imageScene->addText(letter, m_imageFont);
-        QGraphicsTextItem* curSymbol = balloons.back().symbol;
         // TODO(zdenop): get font metrics and calculate better placement
         // (e.g. visible in case of narrow margin)
-        curSymbol->setPos(QPoint(left, baseline - fontOffset));
-        curSymbol->setDefaultTextColor(imageFontColor);
-        curSymbol->setZValue(4);
-        curSymbol->setVisible(true);
-
-        for (int j = 0; j < BalloonSymbol::haloCompCount; ++j) {
-            balloons.back().halo[j] = imageScene->addText(letter, m_imageFont);
-            QGraphicsTextItem* curHalo = balloons.back().halo[j];
-            curHalo->setDefaultTextColor(Qt::white);
-            curHalo->setZValue(3);
-        }
-        balloons.back().halo[0]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(1, 0));
-        balloons.back().halo[1]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(1, 1));
-        balloons.back().halo[2]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(0, 1));
-        balloons.back().halo[3]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(-1, 1));
-        balloons.back().halo[4]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(-1, 0));
-        balloons.back().halo[5]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(-1, -1));
-        balloons.back().halo[6]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(0, -1));
-        balloons.back().halo[7]->setPos(curSymbol->pos() +
-                                        BalloonSymbol::haloShift*QPoint(1, -1));
-        for (int j = 0; j < BalloonSymbol::haloCompCount; ++j)
-            balloons.back().halo[j]->setVisible(true);
+        balloonItem->addSymbol(letter, QPoint(left, baseline - fontOffset));
     }   // for i (idx)
 }
 
+void ChildWidget::penSelectedBox(int row) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QGraphicsRectItem* rectItem =
+            model->index(row, 9).data().value<QGraphicsRectItem*>();
+    if (rectItem) {
+        rectItem->setPen(QPen(rectColor));
+        rectItem->show();
+    }
+}
+
+void ChildWidget::penSelectedBoxes() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QVector<int> rows = selectionTracker->rows();
+    for (int i = 0; i < rows.size(); ++i)
+        penSelectedBox(rows[i]);
+}
+
 void ChildWidget::updateSelectionRects() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    QModelIndexList indexes = table->selectionModel()->selectedRows();
-    if (!indexes.empty()) {
-        clearBalloons();
-        for (int i = 0; i < indexes.size(); ++i) {
-            QGraphicsRectItem* rectItem = modelItemBox(indexes[i].row());
-            if (rectItem) {
-                rectItem->setPen(QPen(rectColor));
-                rectItem->show();
-            }
-        }
-        if (modelItemBox())
-            imageView->ensureVisible(modelItemBox());
-        if (symbolShown == true && indexes.size() == 1) {
-            updateBalloons();
-            resizer->setFromRect(modelItemBox()->rect().toRect());
-        } else {
-            resizer->setFromRect(modelItemBox()->rect().toRect());
-        }
-    } else {
-        clearBalloons();
+    // work for current row only, so that it is cheap on every key
+    clearBalloons();
+    if (selectionTracker->isEmpty()) {
         resizer->disable();
+        return;
     }
+    QGraphicsRectItem* rectItem = modelItemBox();
+    imageView->ensureVisible(rectItem);
+    if (symbolShown == true && selectionTracker->count() == 1)
+        updateBalloons();
+    resizer->setFromRect(rectItem->rect().toRect());
 }
 
 void ChildWidget::closeEvent(QCloseEvent* event) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     if (!maybeSave()) {
         event->ignore();
+    } else {
+        // changes were saved or discarded by user
+        journal->discard();
+        cancelViewJobs();
     }
     if (fileWatcher)
         delete fileWatcher;
@@ -2595,6 +3823,10 @@ void ChildWidget::closeEvent(QCloseEvent* event) {
         delete f_dialog;
     if(statisticsDialog)
         delete statisticsDialog;
+    if (issueDialog)
+        delete issueDialog;
+    if (galleryDialog)
+        delete galleryDialog;
 }
 
 bool ChildWidget::maybeSave() {
@@ -2657,7 +3889,7 @@ void ChildWidget::letterStartEdit() {
         ui.m_eop = euoChange;
         ui.m_origrow = row;
 
-        for (int i = 0; i < model->columnCount(); i++)
+        for (int i = 0; i < model->columnCount() - 1; i++)
             ui.m_vdata[i] = model->index(ui.m_origrow, i).data();
 
         m_undostack.push(ui);
@@ -2669,6 +3901,13 @@ void ChildWidget::letterStartEdit() {
 void ChildWidget::letterEditFinished() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     bIsLineEditChanged = false;
+    // editor commits letter to model after this signal
+    QTimer::singleShot(0, this, SLOT(offerEditedLabel()));
+}
+
+void ChildWidget::offerEditedLabel() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    offerSimilarLabels(selectionModel->currentIndex().row());
 }
 
 void ChildWidget::sbValueChanged(int sbdValue) {
@@ -2704,7 +3943,7 @@ void ChildWidget::sbValueChanged(int sbdValue) {
         ui.m_eop = euoChange;
         ui.m_origrow = row;
 
-        for (int i = 0; i < model->columnCount(); i++)
+        for (int i = 0; i < model->columnCount() - 1; i++)
             ui.m_vdata[i] = model->index(ui.m_origrow, i).data();
 
         m_undostack.push(ui);
@@ -2719,9 +3958,65 @@ void ChildWidget::sbValueChanged(int sbdValue) {
 
 void ChildWidget::sbFinished() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (bIsSpinBoxChanged)
+        boxEditFinished();
     bIsSpinBoxChanged = false;
 }
 
+void ChildWidget::boxEditFinished() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    if (autoRecognize)
+        recognizeBox();
+}
+
+void ChildWidget::setAutoRecognize(bool v) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    autoRecognize = v;
+}
+
+void ChildWidget::recognizeBox() {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    int row = table->currentIndex().row();
+    if (row < 0 || !pageImage)
+        return;
+    if (!recognizer) {
+        recognizer = new BoxRecognizer(this);
+        connect(recognizer, SIGNAL(recognized(BoxRecognizer::Result)),
+                this, SLOT(boxRecognized(BoxRecognizer::Result)));
+        recognizer->start(QThread::LowPriority);
+    }
+    recognizer->setPage(pageImage);
+
+    int left = model->index(row, 1).data().toInt();
+    int bottom = model->index(row, 2).data().toInt();
+    int right = model->index(row, 3).data().toInt();
+    int top = model->index(row, 4).data().toInt();
+    recognizer->recognize(row, QRect(left, top, right - left, bottom - top));
+}
+
+void ChildWidget::boxRecognized(const BoxRecognizer::Result& result) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    // box was edited again or page changed meanwhile
+    if (!recognizer || sender() != recognizer ||
+            !recognizer->isCurrent(result))
+        return;
+    if (!result.error.isEmpty()) {
+        emit statusBarMessage(result.error);
+        return;
+    }
+    if (result.choices.isEmpty()) {
+        emit statusBarMessage(tr("Box %1: nothing recognized")
+                              .arg(result.row + 1));
+        return;
+    }
+    QStringList choices;
+    for (int i = 0; i < result.choices.size(); ++i)
+        choices << QString("'%1' %2%").arg(result.choices.at(i).text)
+                   .arg(qRound(result.choices.at(i).confidence));
+    emit statusBarMessage(tr("Box %1: %2 (%3 ms)").arg(result.row + 1)
+                          .arg(choices.join(", ")).arg(result.elapsed));
+}
+
 void ChildWidget::boxDragChanged() {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
     QModelIndex index = selectionModel->currentIndex();
@@ -2856,6 +4151,14 @@ void ChildWidget::undo() {
         // Two item changed places. Change places back.
         undoMoveBack2(ui);
         break;
+    case euoDocument:
+        // Document was replaced. Swap it with stored version.
+        undoDocument(ui);
+        break;
+    case euoOrder:
+        // Rows were reordered. Put them back.
+        undoOrder(ui);
+        break;
     default:
         // Nothing to do for other cases. Report error.
 
@@ -2885,6 +4188,7 @@ void ChildWidget::undoDelete(UndoItem& ui, bool bIsRedo) {
 
     table->setCurrentIndex(model->index(newfocusrow, 0));
     table->setFocus();
+    penSelectedBoxes();
     updateSelectionRects();
 
     if (bIsRedo)
@@ -2927,6 +4231,7 @@ void ChildWidget::undoEdit(UndoItem& ui, bool bIsRedo) {
 
     table->setCurrentIndex(model->index(ui.m_origrow, 0));
     table->setFocus();
+    penSelectedBoxes();
     updateSelectionRects();
 
     if (bIsRedo)
@@ -2944,7 +4249,7 @@ void ChildWidget::undoJoin(UndoItem& ui, bool bIsRedo) {
     rui.m_origrow = ui.m_origrow;
     rui.m_extrarow = ui.m_extrarow;
 
-    for (int i = 0; i < model->columnCount(); i++) {
+    for (int i = 0; i < model->columnCount() - 1; i++) {
         rui.m_vdata[i] = model->index(rui.m_origrow, i).data();
         rui.m_vextradata[i] = model->index(rui.m_extrarow, i).data();
     }
@@ -2952,12 +4257,13 @@ void ChildWidget::undoJoin(UndoItem& ui, bool bIsRedo) {
     deleteModelItemBox(ui.m_extrarow);
     model->removeRow(ui.m_extrarow);
 
-    for (int i = 0; i < model->columnCount(); i++)
+    for (int i = 0; i < model->columnCount() - 1; i++)
         model->setData(model->index(ui.m_origrow, i), ui.m_vdata[i]);
     updateModelItemBox(ui.m_origrow);
 
     table->setCurrentIndex(model->index(ui.m_origrow, 0));
     table->setFocus();
+    penSelectedBoxes();
     updateSelectionRects();
 
     if (bIsRedo)
@@ -2975,12 +4281,12 @@ void ChildWidget::undoSplit(UndoItem& ui, bool bIsRedo) {
     rui.m_origrow = ui.m_origrow;
     rui.m_extrarow = ui.m_origrow + 1;
 
-    for (int i = 0; i < model->columnCount(); i++) {
+    for (int i = 0; i < model->columnCount() - 1; i++) {
         rui.m_vdata[i] = model->index(rui.m_origrow, i).data();
     }
 
     model->insertRow(ui.m_extrarow);
-    for (int i = 0; i < model->columnCount(); i++) {
+    for (int i = 0; i < model->columnCount() - 1; i++) {
         model->setData(model->index(ui.m_extrarow, i), ui.m_vextradata[i]);
         model->setData(model->index(ui.m_origrow, i), ui.m_vdata[i]);
     }
@@ -2989,6 +4295,7 @@ void ChildWidget::undoSplit(UndoItem& ui, bool bIsRedo) {
 
     table->setCurrentIndex(model->index(ui.m_origrow, 0));
     table->setFocus();
+    penSelectedBoxes();
     updateSelectionRects();
 
     if (bIsRedo)
@@ -3018,6 +4325,7 @@ void ChildWidget::undoMoveBack(UndoItem& ui, bool bIsRedo) {
     table->setCurrentIndex(model->index(firstrow, 0));
     table->setFocus();
 
+    penSelectedBoxes();
     updateSelectionRects();
 
     if (bIsRedo)
@@ -3029,33 +4337,67 @@ void ChildWidget::undoMoveBack(UndoItem& ui, bool bIsRedo) {
 // Put moved row back to original location
 void ChildWidget::undoMoveBack2(UndoItem& ui, bool bIsRedo) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    int firstrow = ui.m_origrow;
-    int secondrow = ui.m_extrarow;
+    int from = ui.m_extrarow;
+    int to = ui.m_origrow;
 
     if (bIsRedo) {
-        firstrow = ui.m_extrarow;
-        secondrow = ui.m_origrow;
+        from = ui.m_origrow;
+        to = ui.m_extrarow;
     }
 
-    if (firstrow < secondrow)
-        secondrow++;
-    else
-        firstrow++;
+    moveRow(from, to);
+    table->setCurrentIndex(model->index(to, 0));
+    table->setFocus();
 
-    model->insertRow(firstrow);
+    penSelectedBoxes();
+    updateSelectionRects();
 
-    for (int i = 0; i < model->columnCount() - 1; i++) {
-        model->setData(model->index(firstrow, i), ui.m_vdata[i]);
-    }
-    createModelItemBox(firstrow);
+    if (bIsRedo)
+        m_undostack.push(ui, false);
+    else
+        m_redostack.push(ui);
+}
 
-    model->removeRow(secondrow);
+// Apply inverse row order (undo) or row order again (redo)
+void ChildWidget::undoOrder(UndoItem& ui, bool bIsRedo) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    QVector<int> order = ui.m_order;
+    if (!bIsRedo) {
+        for (int i = 0; i < ui.m_order.size(); ++i)
+            order[ui.m_order.at(i)] = i;
+    }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    permuteRows(order);
+    QApplication::restoreOverrideCursor();
 
-    if (firstrow > secondrow) firstrow--;
-    table->setCurrentIndex(model->index(firstrow, 0));
+    if (ui.m_origrow >= 0 && ui.m_origrow < model->rowCount())
+        table->setCurrentIndex(model->index(ui.m_origrow, 0));
     table->setFocus();
+    penSelectedBoxes();
+    updateSelectionRects();
+
+    if (bIsRedo)
+        m_undostack.push(ui, false);
+    else
+        m_redostack.push(ui);
+}
+
+// Swap document with stored version (undo and redo are the same)
+void ChildWidget::undoDocument(UndoItem& ui, bool bIsRedo) {
+    if (DMESS > 10) qDebug() << Q_FUNC_INFO;
+    storePage();
+    QVector<GlyphPage> current = pages;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    applyDocument(ui.m_pages);
+    QApplication::restoreOverrideCursor();
+    ui.m_pages = current;
 
+    if (ui.m_origrow >= 0 && ui.m_origrow < model->rowCount())
+        table->setCurrentIndex(model->index(ui.m_origrow, 0));
+    table->setFocus();
+    penSelectedBoxes();
     updateSelectionRects();
+    documentWasModified();
 
     if (bIsRedo)
         m_undostack.push(ui, false);
@@ -3161,6 +4503,14 @@ void ChildWidget::redo() {
         // Two item changed places. Change places back.
         undoMoveBack2(ui, true);
         break;
+    case euoDocument:
+        // Document was replaced. Swap it with stored version again.
+        undoDocument(ui, true);
+        break;
+    case euoOrder:
+        // Rows were reordered. Reorder them again.
+        undoOrder(ui, true);
+        break;
     default:
         // Nothing to do for other cases. Report error.
 
@@ -3176,24 +4526,25 @@ void ChildWidget::redo() {
 
 bool ChildWidget::slotChangePage(int sbdPage) {
     if (DMESS > 10) qDebug() << Q_FUNC_INFO;
-    PIX * pix;
-    QImage image;
     storePage();
+    if (recognizer)
+        recognizer->cancel();
+    labelSourcePage = -1;
     currPage = sbdPage - 1;
 
-    pix = pixReadTiff(imageFile.toLocal8Bit().data(), currPage);
-    image = TessTools::PIX2qImage(pix);
-    pixDestroy(&pix);
-    if (image.isNull()) {
+    PageImagePtr page = pageImageFor(currPage);
+    if (!page) {
         QMessageBox::information(this, tr("Problem"),
                                  tr("Cannot load page %1 from file %1.")
                                  .arg(currPage).arg(imageFile));
         return false;
     }
-    imageHeight = image.height();
-    imageWidth = image.width();
-    imageScene->removeItem(imageItem);
-    imageItem = imageScene->addPixmap(QPixmap::fromImage(image));
+    pageImage = page;
+    imageBinarized = false;
+    imageHeight = pageImage->height();
+    imageWidth = pageImage->width();
+    showPageImage();
+    prefetchPages();
 
     bool showFontColumns = isFontColumnsShown();
     cleanTable();
@@ -3208,47 +4559,73 @@ bool ChildWidget::slotChangePage(int sbdPage) {
     return true;
 }
 
+void ChildWidget::setRowGlyph(int row, const Glyph& glyph) {
+    QFont letterFont;
+    letterFont.setBold(glyph.bold);
+    letterFont.setItalic(glyph.italic);
+    letterFont.setUnderline(glyph.underline);
+
+    model->setData(model->index(row, 0, QModelIndex()), letterFont,
+                   Qt::FontRole);
+    model->setData(model->index(row, 0, QModelIndex()), glyph.letter);
+    if (glyph.confidence >= 0) {
+        model->setData(model->index(row, 0, QModelIndex()), glyph.confidence,
+                       kConfidenceRole);
+        model->setData(model->index(row, 0, QModelIndex()),
+                       tr("Confidence: %1%").arg(qRound(glyph.confidence)),
+                       Qt::ToolTipRole);
+    } else {
+        model->setData(model->index(row, 0, QModelIndex()), QVariant(),
+                       kConfidenceRole);
+        model->setData(model->index(row, 0, QModelIndex()), QVariant(),
+                       Qt::ToolTipRole);
+    }
+    model->setData(model->index(row, 1, QModelIndex()), glyph.left);
+    model->setData(model->index(row, 2, QModelIndex()),
+                   imageHeight - glyph.bottom);
+    model->setData(model->index(row, 3, QModelIndex()), glyph.right);
+    model->setData(model->index(row, 4, QModelIndex()),
+                   imageHeight - glyph.top);
+    model->setData(model->index(row, 5, QModelIndex()), glyph.page);
+    model->setData(model->index(row, 6, QModelIndex()), glyph.italic);
+    model->setData(model->index(row, 7, QModelIndex()), glyph.bold);
+    model->setData(model->index(row, 8, QModelIndex()), glyph.underline);
+}
+
+Glyph ChildWidget::glyphAtRow(int row) {
+    return glyphFromModel(model, row, imageHeight);
+}
+
+GlyphPage ChildWidget::tableGlyphs() {
+    GlyphPage page;
+    page.reserve(model->rowCount());
+    for (int row = 0; row < model->rowCount(); ++row)
+        page.append(glyphAtRow(row));
+    return page;
+}
+
 /*
  * Store current page (in table view) to pages vector
  *
  */
 void ChildWidget::storePage() {
+    // table of hibernated document is empty, pages are up to date
+    if (hibernated)
+        return;
     QModelIndex index = selectionModel->currentIndex();
     if (!index.isValid())
         return;
 
-    QVector<QStringList> page;
-    for (int row = 0; row < model->rowCount(); ++row) {
-        QString letter = model->index(row, 0).data().toString();
-        QString left = model->index(row, 1).data().toString();
-        int bottom = model->index(row, 2).data().toInt();
-        QString right = model->index(row, 3).data().toString();
-        int top = model->index(row, 4).data().toInt();
-        QString pageNum = model->index(row, 5).data().toString();
-        bool italic = model->index(row, 6).data().toBool();
-        bool bold = model->index(row, 7).data().toBool();
-        bool underline = model->index(row, 8).data().toBool();
-        if (underline)
-            letter.prepend("\'");
-        if (italic)
-            letter.prepend("$");
-        if (bold)
-            letter.prepend("@");
-        QStringList box;
-        box << letter << left << QString::number(imageHeight - bottom)
-            << right  << QString::number(imageHeight - top) << pageNum;
-        page.append(box);
-    }
-    pages[currPage] = page;
+    pages[currPage] = tableGlyphs();
 }
 
 void ChildWidget::cleanTable() {
     // Hide current selection - it is not valid on other page
-    QModelIndexList indexes = table->selectionModel()->selectedRows();
-    if (!indexes.empty()) {
+    QVector<int> rows = selectionTracker->rows();
+    if (!rows.empty()) {
         clearBalloons();
-        for (int i = 0; i < indexes.size(); ++i) {
-            QGraphicsRectItem* rectItem = modelItemBox(indexes[i].row());
+        for (int i = 0; i < rows.size(); ++i) {
+            QGraphicsRectItem* rectItem = modelItemBox(rows[i]);
             if (rectItem) {
                 rectItem->hide();
             }
@@ -3256,6 +4633,15 @@ void ChildWidget::cleanTable() {
     }
 
     selectionModel->clearSelection();
+    // bboxes are owned by scene, not by model
+    for (int row = 0; row < model->rowCount(); ++row) {
+        QGraphicsRectItem* rectItem =
+                model->index(row, 9).data().value<QGraphicsRectItem*>();
+        if (rectItem) {
+            imageScene->removeItem(rectItem);
+            delete rectItem;
+        }
+    }
     model->clear();
     delete selectionModel;
     delete model;
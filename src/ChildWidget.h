@@ -28,10 +28,14 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QFileSystemWatcher>
+#include <QHash>
 #include <QSettings>
+#include <QSharedPointer>
 #include <QTextStream>
+#include <QTimer>
 #include <qmath.h>
 #include <QScrollBar>
 #include <QStack>
@@ -39,6 +43,7 @@
 #include <QApplication>
 #include <QClipboard>
 #include <QCloseEvent>
+#include <QGraphicsPixmapItem>
 #include <QGraphicsRectItem>
 #include <QGraphicsScene>
 #include <QGraphicsSceneWheelEvent>
@@ -61,6 +66,16 @@
 #include <QGuiApplication>
 #endif
 
+#include "BalloonItem.h"
+#include "BoxRecognizer.h"
+#include "Glyph.h"
+#include "GlyphDiff.h"
+#include "PageImage.h"
+#include "PageStructure.h"
+#include "ShapeIndex.h"
+#include "TessTools.h"
+#include "TextExport.h"
+
 class QGraphicsScene;
 class QGraphicsView;
 class QAbstractItemModel;
@@ -69,8 +84,12 @@ class QTableView;
 class QGraphicsItem;
 class QGraphicsRectItem;
 class FindDialog;
+class SelectionTracker;
 class DrawRectangle;
+class EditJournal;
 class StatisticsDialog;
+class IssueListDialog;
+class GlyphGalleryDialog;
 
 enum undoOperation {
     euoAdd = 1,
@@ -79,7 +98,9 @@ enum undoOperation {
     euoJoin = 8,
     euoSplit = 16,
     euoReplace = 32,
-    euoMove = 64
+    euoMove = 64,
+    euoDocument = 128,  /**< whole document replaced (m_pages) */
+    euoOrder = 256      /**< rows of page reordered (m_order) */
 };
 
 struct UndoItem {
@@ -88,18 +109,8 @@ struct UndoItem {
     int m_extrarow;
     QVariant m_vdata[9];
     QVariant m_vextradata[9];
-};
-
-// Overhead symbol displayed in Show symbol mode
-struct BalloonSymbol {
-    // Symbol itself
-    QGraphicsTextItem* symbol;
-
-    // Halo components
-    static const int haloCompCount = 8;
-    // TODO(all): Temp const, to be replaced by user-adjusted setting
-    static const int haloShift = 2;
-    QGraphicsTextItem* halo[haloCompCount];
+    QVector<GlyphPage> m_pages;  /**< euoDocument: other version of pages */
+    QVector<int> m_order;        /**< euoOrder: row shown at position i */
 };
 
 // Eight geometric directions
@@ -140,6 +151,8 @@ class DragResizer : public QObject, QGraphicsItemGroup {
 
   signals:
     void changed();
+    // Mouse was released after dragging
+    void dragFinished();
 };
 
 class ChildWidget : public QSplitter {
@@ -151,6 +164,15 @@ class ChildWidget : public QSplitter {
     bool isModified() {
         return modified;
     }
+    bool isHibernated() {
+        return hibernated;
+    }
+    /** Approximate memory used by document (bytes). */
+    qint64 memoryUsage();
+    /** Drop pixmap, scene items and table; keep only glyph data. */
+    void hibernate();
+    /** Restore hibernated document. */
+    void wakeUp();
     bool isBoxSelected();
     bool isUndoAvailable();
     bool isRedoAvailable();
@@ -176,15 +198,41 @@ class ChildWidget : public QSplitter {
     bool save(const QString& fileName);
     bool splitToFeatureBF(const QString& fileName);
     bool saveString(const QString& fileName, const QString& qData);
-    bool createStringImage(const QString& fileName, const QString& qData);
     bool importSPLToChild(const QString& fileName);
     bool importTextToChild(const QString& fileName);
     bool exportTxt(const int& eType, const QString& fileName);
+    bool exportTrainingGlyphs(const QString& fileName);
+    /** Snap boxes of all pages to their ink in background job (one undo
+     *  step).
+     */
+    bool tightenAllBoxes();
+    bool sortReadingOrder();
+    /** Replace boxes inside drawn rectangle by boxes generated by tesseract
+     *  for that rectangle only (background job, one undo step).
+     */
+    bool regenerateBoxesInRectangle();
+    /** List problems of boxes of all pages (background job). */
+    bool validateBoxes();
+    /** List glyphs whose letter differs from similar looking glyphs
+     *  (background job).
+     */
+    bool checkLabels();
+    /** Give letter of last relabeled (or current) box to all boxes of
+     *  document with near identical shape (background job, one undo step).
+     */
+    bool labelSimilarShapes();
     bool loadImage(const QString& fileName);
     bool loadBoxes(const QString& fileName);
+    /** Regenerate current page in background and write it to
+     *  boxFileName when done.
+     */
     bool qCreateBoxes(const QString &boxFileName);
+    /** Generate boxes of current page without data in background. */
     bool makeBoxPage();
     void binarizeImage();
+    /** Ask tesseract for letter of current box (result in status bar). */
+    void recognizeBox();
+    void setAutoRecognize(bool v);
     void setSelectionRect();
     void setBolded(bool v);
     void setItalic(bool v);
@@ -226,6 +274,13 @@ class ChildWidget : public QSplitter {
     void moveDown();
     void moveTo();
     void goToRow();
+    // Show box of page (0-based indices; e.g. from issue list)
+    void goToBox(int page, int row);
+    // Text line/word of current box (see PageStructure)
+    void selectLine();
+    void selectWord();
+    void nextLine();
+    void previousLine();
     void find();
     void statistics();
     void findNext(const QString &symbol, Qt::CaseSensitivity mc);
@@ -246,6 +301,8 @@ class ChildWidget : public QSplitter {
     void undoSplit(UndoItem& ui, bool bIsRedo = false);
     void undoMoveBack(UndoItem& ui, bool bIsRedo = false);
     void undoMoveBack2(UndoItem& ui, bool bIsRedo = false);
+    void undoDocument(UndoItem& ui, bool bIsRedo = false);
+    void undoOrder(UndoItem& ui, bool bIsRedo = false);
     void updateSTD();
     void insertOrUpdateCharStat(const QString&);
     void removeCharStat(const QString&);
@@ -264,9 +321,17 @@ class ChildWidget : public QSplitter {
     QColor boxColor;
     QColor backgroundColor;
     QColor imageFontColor;
+    TextExport::Options textExportOptions;  /**< read with other settings */
+    PageStructure pageStructure;  /**< lines/words of current page */
+    /** Lines and words of current page, updated after edits. */
+    const PageStructure& currentStructure();
+    /** Select rows first..last and make first current. */
+    void selectRows(int first, int last);
     QGraphicsItem* m_message;
     FindDialog *f_dialog;
     StatisticsDialog *statisticsDialog;
+    IssueListDialog* issueDialog;
+    GlyphGalleryDialog* galleryDialog;
 
     DrawRectangle *m_DrawRectangle;
     QFileSystemWatcher *fileWatcher;
@@ -274,11 +339,15 @@ class ChildWidget : public QSplitter {
     void setFileWatcher(const QString & fileName);
 
     void moveSymbolRow(int direction);
+    /** Move row as whole (its items are moved, not copied). */
+    void moveRow(int from, int to);
+    /** Reorder rows of page; row order[i] goes to position i. */
+    void permuteRows(const QVector<int>& order);
     QList<QTableWidgetItem*> takeRow(int row);
     void calculateLettersTableWidth();
 
     int currPage;                         /**< current page */
-    QVector<QVector<QStringList> > pages; /**< vector with all data/boxes */
+    QVector<GlyphPage> pages; /**< vector with all data/boxes */
     /** Read data from vector and show them in table.
      *  It takes data for current page from vector and puts it to table view.
      */
@@ -288,6 +357,19 @@ class ChildWidget : public QSplitter {
      *  and box.
      */
     bool readToVector(QTextStream &boxdata);
+    /** Parse box file from textstream to pages of document. */
+    bool parseBoxes(QTextStream &boxdata, QVector<GlyphPage>* document);
+    /** Make document equal to given pages by applying only differences.
+     *  Returns false if nothing changed. Caller stores undo information.
+     */
+    bool applyDocument(const QVector<GlyphPage>& document);
+    void applyPageHunk(const GlyphDiff::Hunk& hunk);
+    /** Put glyph (tesseract coordinates) to existing table row. */
+    void setRowGlyph(int row, const Glyph& glyph);
+    /** Glyph of table row in tesseract coordinates. */
+    Glyph glyphAtRow(int row);
+    /** Glyphs of all table rows. */
+    GlyphPage tableGlyphs();
     /** Store current page to pages.
      *  It takes data from table view and put it to vector that keeps data
      *  of all pages.
@@ -298,6 +380,16 @@ class ChildWidget : public QSplitter {
      */
     void cleanTable();
     void loadTable();
+    /** Hash shapes of all boxes in background; running build of older
+     *  snapshot is cancelled.
+     */
+    void buildShapeIndex();
+    QVector<ShapeIndex::Entry> similarShapes(const Glyph& glyph);
+    /** Tell user how many boxes share shape of relabeled row. */
+    void offerSimilarLabels(int row);
+    /** Repaint all selected boxes (after their items were recreated). */
+    void penSelectedBoxes();
+    void penSelectedBox(int row);
 
   private slots:
     void documentWasModified();
@@ -307,6 +399,16 @@ class ChildWidget : public QSplitter {
                           const QItemSelection& deselected);
     void updateSelectionRects();
     void slotfileChanged(const QString& fileName);
+    void previewBinarization();
+    void boxEditFinished();
+    void boxRecognized(const BoxRecognizer::Result& result);
+    void structureRowsInserted(const QModelIndex&, int first, int last);
+    void structureRowsRemoved(const QModelIndex&, int first, int last);
+    void structureDataChanged(const QModelIndex& topLeft,
+                              const QModelIndex& bottomRight);
+    void offerEditedLabel();
+    // Thumbnails of all boxes with letter of statistics row
+    void showGallery(const QModelIndex& index);
 
   signals:
     void boxChanged();
@@ -328,7 +430,63 @@ class ChildWidget : public QSplitter {
     void setCurrentBoxFile(const QString& fileName);
 
     QString strippedName(const QString& fullFileName);
-    QImage gItem2qImage();
+
+    // Returns shared decoded image of page (0-based). Pages borrowed by
+    // other consumers stay cached until last borrower releases them.
+    PageImagePtr pageImageFor(int page);
+    // Pages of image file that are decoded at the moment
+    QHash<int, PageImagePtr> loadedPageImages();
+    // Image currently shown in scene (original or binarized)
+    QImage currentImage();
+    // (Re)creates scene pixmap item from current page image
+    void showPageImage();
+    // Offers replay of edit journal left by crashed session
+    bool recoverJournal(const QString& boxFileName);
+    // Writes parsed pages to binary document cache (see DocumentCache)
+    void storeDocumentCache(const QString& boxFileName);
+    // Replaces scene pixmap item with image (e.g. binarization preview)
+    void setSceneImage(const QImage& image);
+    // Issue list shared by validation and label check: clear it, show it
+    void openIssueDialog(const QString& title);
+    void showIssueSummary(const QString& summary);
+    // Replaces document by job result computed from snapshot (one undo
+    // step); false when document was edited meanwhile or nothing changed
+    bool applyJobDocument(const QVector<GlyphPage>& snapshot,
+                          const QVector<GlyphPage>& document);
+
+    // Background jobs of document (see JobScheduler)
+    class BinarizeJob;
+    class PrefetchJob;
+    class TextExportJob;
+    class SplitExportJob;
+    class TrainingExportJob;
+    class ShapeIndexJob;
+    class TightenJob;
+    class ValidateJob;
+    class LabelCheckJob;
+    class LabelShapesJob;
+    class GenerateBoxesJob;
+    // Submit tesseract box generation of current page (null region means
+    // whole page); page is written to saveTo when it is not empty
+    bool generateBoxes(const QRect& region, const QString& saveTo);
+    void applyGeneratedPage(int page, const GlyphPage& glyphs,
+                            const QString& saveTo);
+    void applyGeneratedRegion(int page, int pageHeight, const QRect& region,
+                              const GlyphPage& generated);
+    // Decode neighbours of current page while user works on it
+    void prefetchPages();
+    // Remember job whose result is only shown in this document
+    void trackViewJob(int id);
+    // Cancel such jobs (document is closed)
+    void cancelViewJobs();
+
+    PageImagePtr pageImage;  /**< image of current page */
+    QHash<int, QWeakPointer<PageImage> > pageImages;
+    QHash<int, PageImagePtr> prefetched;  /**< decoded neighbour pages */
+    QList<int> viewJobs;  /**< jobs cancelled when document is closed */
+    int previewJob;       /**< running binarization preview or 0 */
+    bool imageBinarized;
+    int imagePageCount;  /**< pages in image file */
 
     QGraphicsScene* imageScene;
     QGraphicsView* imageView;
@@ -355,6 +513,8 @@ class ChildWidget : public QSplitter {
 
     QStandardItemModel* model;
     QItemSelectionModel* selectionModel;
+    SelectionTracker* selectionTracker;  /**< selected rows of table */
+    EditJournal* journal;  /**< unsaved edits for crash recovery */
 
     QStandardItemModel* statisticsModel;
     QSortFilterProxyModel* statisticsModelProxy;
@@ -363,6 +523,8 @@ class ChildWidget : public QSplitter {
     QString boxFile;
 
     bool modified;
+    bool hibernated;    /**< see DocumentMemoryManager */
+    int hibernatedRow;  /**< current row when document was hibernated */
     int imageHeight;
     int imageWidth;
     int widgetWidth;
@@ -371,13 +533,24 @@ class ChildWidget : public QSplitter {
 
     // Overhead symbols
     int balloonCount;
-    QVector<BalloonSymbol> balloons;
+    BalloonItem* balloonItem;  /**< symbols in Show symbol mode */
 
     QRubberBand* rubberBand;
     QPoint rbOrigin;
 
     DragResizer* resizer;
 
+    BoxRecognizer* recognizer;  /**< created on first use */
+    /** Engine kept for box generation; shared with running job. */
+    QSharedPointer<TessTools> tessTools;
+
+    ShapeIndexPtr shapeIndex;   /**< null until background build ends */
+    int shapeIndexJob;          /**< newest index build or -1 */
+    int shapeIndexGeneration;   /**< snapshot number of newest build */
+    Glyph labelSource;          /**< last relabeled box */
+    int labelSourcePage;        /**< page of labelSource or -1 */
+    bool autoRecognize;         /**< recognize box after each edit */
+
     template<class T>
     class UndoStack : public QStack<T> {
       public:
@@ -0,0 +1,235 @@
+/**********************************************************************
+* File:        ComponentIndex.cpp
+* Description: Connected components of bilevel page image
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "ComponentIndex.h"
+#include "PageImage.h"
+
+#include <QColor>
+
+namespace {
+
+// Side of spatial index cell (pixels)
+const int kGridCell = 64;
+
+struct Run {
+    int x0;
+    int x1;
+    int label;
+};
+
+/*
+ * Append runs of black pixels of packed 1 bpp scanline (MSB first).
+ * If invert is set, black pixels are zero bits.
+ */
+void rowRuns(const uchar* line, int width, bool invert, QVector<Run>* runs) {
+    runs->resize(0);
+    int bytes = (width + 7) / 8;
+    uchar lastMask = (width & 7) ? static_cast<uchar>(0xff << (8 - (width & 7)))
+                                 : 0xff;
+    int start = -1;
+    for (int i = 0; i < bytes; ++i) {
+        uchar v = invert ? static_cast<uchar>(~line[i]) : line[i];
+        if (i == bytes - 1)
+            v &= lastMask;
+        // whole byte continues current state
+        if ((v == 0 && start < 0) || (v == 0xff && start >= 0))
+            continue;
+        for (int bit = 0; bit < 8; ++bit) {
+            bool black = v & (0x80 >> bit);
+            if (black && start < 0) {
+                start = i * 8 + bit;
+            } else if (!black && start >= 0) {
+                Run run = {start, i * 8 + bit - 1, 0};
+                runs->append(run);
+                start = -1;
+            }
+        }
+    }
+    if (start >= 0) {
+        Run run = {start, width - 1, 0};
+        runs->append(run);
+    }
+}
+
+int findRoot(QVector<int>* parent, int label) {
+    int* p = parent->data();
+    while (p[label] != label) {
+        p[label] = p[p[label]];  // path halving
+        label = p[label];
+    }
+    return label;
+}
+
+void unite(QVector<int>* parent, int a, int b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b)
+        (*parent)[b] = a;
+    else if (b < a)
+        (*parent)[a] = b;
+}
+
+struct LabelStats {
+    int left;
+    int top;
+    int right;
+    int bottom;
+    int pixels;
+};
+
+}  // namespace
+
+ComponentIndex::ComponentIndex(const QImage& bilevel)
+    : m_width(bilevel.width()), m_height(bilevel.height()),
+      m_gridColumns(0), m_gridRows(0) {
+    if (bilevel.isNull())
+        return;
+    QImage mono = PageImage::toMono(bilevel);
+    bool invert = PageImage::blackIndex(mono) == 0;
+
+    QVector<int> parent;
+    QVector<LabelStats> stats;
+    QVector<Run> previous, current;
+    for (int y = 0; y < m_height; ++y) {
+        rowRuns(mono.constScanLine(y), m_width, invert, &current);
+        int p = 0;
+        for (int i = 0; i < current.size(); ++i) {
+            Run& run = current[i];
+            run.label = -1;
+            // skip runs of previous row left of this one (8-connectivity)
+            while (p < previous.size() && previous.at(p).x1 < run.x0 - 1)
+                ++p;
+            for (int q = p; q < previous.size() &&
+                 previous.at(q).x0 <= run.x1 + 1; ++q) {
+                if (run.label < 0)
+                    run.label = previous.at(q).label;
+                else
+                    unite(&parent, run.label, previous.at(q).label);
+            }
+            if (run.label < 0) {
+                run.label = parent.size();
+                parent.append(run.label);
+                LabelStats s = {run.x0, y, run.x1, y, 0};
+                stats.append(s);
+            }
+            LabelStats& s = stats[run.label];
+            s.left = qMin(s.left, run.x0);
+            s.right = qMax(s.right, run.x1);
+            s.bottom = y;
+            s.pixels += run.x1 - run.x0 + 1;
+        }
+        previous.swap(current);
+    }
+
+    // merge statistics of joined labels into their roots
+    QVector<int> componentOf(parent.size(), -1);
+    for (int label = 0; label < parent.size(); ++label) {
+        int root = findRoot(&parent, label);
+        if (root == label)
+            continue;
+        LabelStats& r = stats[root];
+        const LabelStats& s = stats.at(label);
+        r.left = qMin(r.left, s.left);
+        r.top = qMin(r.top, s.top);
+        r.right = qMax(r.right, s.right);
+        r.bottom = qMax(r.bottom, s.bottom);
+        r.pixels += s.pixels;
+    }
+    for (int label = 0; label < parent.size(); ++label) {
+        if (parent.at(label) != label)
+            continue;
+        const LabelStats& s = stats.at(label);
+        Component component;
+        component.rect = QRect(QPoint(s.left, s.top),
+                               QPoint(s.right, s.bottom));
+        component.pixels = s.pixels;
+        m_components.append(component);
+    }
+    buildGrid();
+}
+
+void ComponentIndex::buildGrid() {
+    m_gridColumns = (m_width + kGridCell - 1) / kGridCell;
+    m_gridRows = (m_height + kGridCell - 1) / kGridCell;
+    m_grid.resize(m_gridColumns * m_gridRows);
+    for (int i = 0; i < m_components.size(); ++i) {
+        const QRect& r = m_components.at(i).rect;
+        for (int gy = r.top() / kGridCell; gy <= r.bottom() / kGridCell; ++gy)
+            for (int gx = r.left() / kGridCell; gx <= r.right() / kGridCell;
+                 ++gx)
+                m_grid[gy * m_gridColumns + gx].append(i);
+    }
+}
+
+QVector<int> ComponentIndex::intersecting(const QRect& rect) const {
+    QVector<int> result;
+    QRect area = rect.intersected(QRect(0, 0, m_width, m_height));
+    if (area.isEmpty())
+        return result;
+    int gx0 = area.left() / kGridCell;
+    int gx1 = area.right() / kGridCell;
+    int gy0 = area.top() / kGridCell;
+    int gy1 = area.bottom() / kGridCell;
+    for (int gy = gy0; gy <= gy1; ++gy) {
+        for (int gx = gx0; gx <= gx1; ++gx) {
+            const QVector<int>& cell = m_grid.at(gy * m_gridColumns + gx);
+            for (int k = 0; k < cell.size(); ++k) {
+                int i = cell.at(k);
+                const QRect& r = m_components.at(i).rect;
+                if (!r.intersects(area))
+                    continue;
+                // report component only from first cell it shares with area
+                int firstX = qMax(gx0, r.left() / kGridCell);
+                int firstY = qMax(gy0, r.top() / kGridCell);
+                if (gx == firstX && gy == firstY)
+                    result.append(i);
+            }
+        }
+    }
+    return result;
+}
+
+QRect ComponentIndex::inkRect(const QRect& rect, int minPixels) const {
+    QRect ink;
+    QVector<int> found = intersecting(rect);
+    for (int k = 0; k < found.size(); ++k) {
+        const Component& component = m_components.at(found.at(k));
+        if (component.pixels < minPixels)
+            continue;
+        QRect part = component.rect.intersected(rect);
+        qint64 partArea = qint64(part.width()) * part.height();
+        qint64 area = qint64(component.rect.width()) *
+                component.rect.height();
+        // component belongs to neighbour symbol
+        if (2 * partArea < area)
+            continue;
+        ink |= part;
+    }
+    return ink;
+}
+
+qint64 ComponentIndex::memoryUsage() const {
+    qint64 bytes = m_components.size() * sizeof(Component);
+    for (int i = 0; i < m_grid.size(); ++i)
+        bytes += sizeof(QVector<int>) + m_grid.at(i).size() * sizeof(int);
+    return bytes;
+}
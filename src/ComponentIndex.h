@@ -0,0 +1,87 @@
+/**********************************************************************
+* File:        ComponentIndex.h
+* Description: Connected components of bilevel page image
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_COMPONENTINDEX_H_
+#define SRC_COMPONENTINDEX_H_
+
+#include <QImage>
+#include <QRect>
+#include <QSharedPointer>
+#include <QVector>
+
+class ComponentIndex;
+typedef QSharedPointer<const ComponentIndex> ComponentIndexPtr;
+
+/**
+ * 8-connected components of black pixels of bilevel image with spatial
+ * index for rectangle queries.
+ * Labeling works on runs of black pixels: runs of each row are read
+ * directly from packed 1 bpp scanlines (white bytes are skipped) and
+ * joined with overlapping runs of previous row by union-find. Only
+ * bounding box and pixel count of every component are kept, no label
+ * image is allocated.
+ */
+class ComponentIndex {
+  public:
+    struct Component {
+        QRect rect;  /**< bounding box in image coordinates */
+        int pixels;  /**< number of black pixels */
+    };
+
+    /** Label components of image (converted to 1 bpp if needed). */
+    explicit ComponentIndex(const QImage& bilevel);
+
+    int width() const {
+        return m_width;
+    }
+    int height() const {
+        return m_height;
+    }
+    int count() const {
+        return m_components.size();
+    }
+    const Component& component(int i) const {
+        return m_components.at(i);
+    }
+
+    /** Indices of components with bounding box intersecting rect. */
+    QVector<int> intersecting(const QRect& rect) const;
+    /** Bounding box of ink inside rect. Components lying mostly outside
+     *  rect (e.g. touching neighbour symbols) and components smaller than
+     *  minPixels are ignored. Returns null rect if there is no ink.
+     */
+    QRect inkRect(const QRect& rect, int minPixels = 1) const;
+    /** Approximate memory used by index (bytes). */
+    qint64 memoryUsage() const;
+
+  private:
+    void buildGrid();
+
+    int m_width;
+    int m_height;
+    QVector<Component> m_components;
+    int m_gridColumns;
+    int m_gridRows;
+    QVector<QVector<int> > m_grid;  /**< component indices per grid cell */
+};
+
+#endif  // SRC_COMPONENTINDEX_H_
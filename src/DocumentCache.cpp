@@ -0,0 +1,335 @@
+/**********************************************************************
+* File:        DocumentCache.cpp
+* Description: Binary on-disk cache of parsed documents
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "DocumentCache.h"
+#include "Settings.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSettings>
+
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'Q', 'B', 'E', 'C'};
+const quint32 kVersion = 1;
+const quint32 kByteOrder = 0x01020304;
+
+// Bytes of image file head and tail used for its hash
+const qint64 kImageHashBlock = 64 * 1024;
+
+enum GlyphFlags {
+    gfBold = 1,
+    gfItalic = 2,
+    gfUnderline = 4
+};
+
+struct FileKey {
+    qint64 size;
+    qint64 mtime;
+    char hash[16];
+};
+
+struct CacheHeader {
+    char magic[4];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 pageCount;
+    FileKey box;
+    FileKey image;
+    quint32 sizeCount;
+    quint32 glyphPageCount;
+    quint32 glyphCount;
+    quint32 stringPoolSize;  // in UTF-16 units
+    quint64 sizesOffset;
+    quint64 directoryOffset;
+    quint64 glyphOffset;
+    quint64 stringOffset;
+    quint64 fileSize;
+};
+
+struct PageSizeRecord {
+    qint32 width;
+    qint32 height;
+};
+
+struct PageRecord {
+    quint32 firstGlyph;
+    quint32 glyphCount;
+};
+
+struct GlyphRecord {
+    qint32 left;
+    qint32 bottom;
+    qint32 right;
+    qint32 top;
+    qint32 page;
+    quint32 flags;
+    quint32 letterOffset;  // in UTF-16 units
+    quint32 letterLength;
+};
+
+quint64 align8(quint64 offset) {
+    return (offset + 7) & ~quint64(7);
+}
+
+/*
+ * Size and modification time only; hash is computed on demand
+ */
+bool fileStat(const QString& fileName, FileKey* key) {
+    QFileInfo info(fileName);
+    if (!info.exists())
+        return false;
+    memset(key, 0, sizeof(FileKey));
+    key->size = info.size();
+    key->mtime = info.lastModified().toMSecsSinceEpoch();
+    return true;
+}
+
+bool fileHash(const QString& fileName, bool sampled, FileKey* key) {
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    if (sampled && file.size() > 2 * kImageHashBlock) {
+        hash.addData(file.read(kImageHashBlock));
+        file.seek(file.size() - kImageHashBlock);
+        hash.addData(file.read(kImageHashBlock));
+    } else {
+        while (!file.atEnd())
+            hash.addData(file.read(1 << 20));
+    }
+    QByteArray result = hash.result();
+    memcpy(key->hash, result.constData(), sizeof(key->hash));
+    return true;
+}
+
+bool fileKey(const QString& fileName, bool sampled, FileKey* key) {
+    return fileStat(fileName, key) && fileHash(fileName, sampled, key);
+}
+
+bool sameStat(const FileKey& a, const FileKey& b) {
+    return a.size == b.size && a.mtime == b.mtime;
+}
+
+}  // namespace
+
+QString DocumentCache::cacheDir() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    return QFileInfo(settings.fileName()).absolutePath() + "/cache";
+}
+
+QString DocumentCache::cacheFileName(const QString& imageFile,
+                                     const QString& boxFile) {
+    QByteArray id = QFileInfo(imageFile).absoluteFilePath().toUtf8() + '\0' +
+            QFileInfo(boxFile).absoluteFilePath().toUtf8();
+    QByteArray name = QCryptographicHash::hash(id, QCryptographicHash::Md5)
+            .toHex();
+    return cacheDir() + "/" + QString::fromLatin1(name) + ".qbec";
+}
+
+bool DocumentCache::load(const QString& imageFile, const QString& boxFile,
+                         Document* document) {
+    QFile file(cacheFileName(imageFile, boxFile));
+    if (!file.open(QFile::ReadOnly) ||
+            file.size() < static_cast<qint64>(sizeof(CacheHeader)))
+        return false;
+    const uchar* base = file.map(0, file.size());
+    if (!base)
+        return false;
+
+    CacheHeader header;
+    memcpy(&header, base, sizeof(header));
+    quint64 size = file.size();
+    bool valid = memcmp(header.magic, kMagic, 4) == 0 &&
+            header.version == kVersion && header.byteOrder == kByteOrder &&
+            header.fileSize == size &&
+            header.sizesOffset + header.sizeCount * sizeof(PageSizeRecord)
+                <= size &&
+            header.directoryOffset + header.glyphPageCount *
+                sizeof(PageRecord) <= size &&
+            header.glyphOffset + header.glyphCount * sizeof(GlyphRecord)
+                <= size &&
+            header.stringOffset + header.stringPoolSize * sizeof(QChar)
+                <= size;
+
+    // cheap checks first, hashes only if size and time match
+    FileKey boxKey, imageKey;
+    valid = valid && fileStat(boxFile, &boxKey) &&
+            fileStat(imageFile, &imageKey) &&
+            sameStat(boxKey, header.box) && sameStat(imageKey, header.image) &&
+            fileHash(boxFile, false, &boxKey) &&
+            memcmp(boxKey.hash, header.box.hash, 16) == 0 &&
+            fileHash(imageFile, true, &imageKey) &&
+            memcmp(imageKey.hash, header.image.hash, 16) == 0;
+    if (!valid) {
+        file.unmap(const_cast<uchar*>(base));
+        return false;
+    }
+
+    const PageSizeRecord* sizes = reinterpret_cast<const PageSizeRecord*>(
+                base + header.sizesOffset);
+    const PageRecord* directory = reinterpret_cast<const PageRecord*>(
+                base + header.directoryOffset);
+    const GlyphRecord* glyphs = reinterpret_cast<const GlyphRecord*>(
+                base + header.glyphOffset);
+    const QChar* strings = reinterpret_cast<const QChar*>(
+                base + header.stringOffset);
+
+    document->pageCount = header.pageCount;
+    document->pageSizes.resize(header.sizeCount);
+    for (quint32 i = 0; i < header.sizeCount; ++i)
+        document->pageSizes[i] = QSize(sizes[i].width, sizes[i].height);
+
+    document->pages.clear();
+    document->pages.resize(header.glyphPageCount);
+    for (quint32 p = 0; p < header.glyphPageCount && valid; ++p) {
+        const PageRecord& record = directory[p];
+        if (quint64(record.firstGlyph) + record.glyphCount > header.glyphCount) {
+            valid = false;
+            break;
+        }
+        GlyphPage& page = document->pages[p];
+        page.resize(record.glyphCount);
+        for (quint32 g = 0; g < record.glyphCount; ++g) {
+            const GlyphRecord& r = glyphs[record.firstGlyph + g];
+            if (quint64(r.letterOffset) + r.letterLength >
+                    header.stringPoolSize) {
+                valid = false;
+                break;
+            }
+            Glyph& glyph = page[g];
+            glyph.letter = QString(strings + r.letterOffset, r.letterLength);
+            glyph.left = r.left;
+            glyph.bottom = r.bottom;
+            glyph.right = r.right;
+            glyph.top = r.top;
+            glyph.page = r.page;
+            glyph.bold = r.flags & gfBold;
+            glyph.italic = r.flags & gfItalic;
+            glyph.underline = r.flags & gfUnderline;
+        }
+    }
+    file.unmap(const_cast<uchar*>(base));
+    if (!valid)
+        document->pages.clear();
+    return valid;
+}
+
+bool DocumentCache::store(const QString& imageFile, const QString& boxFile,
+                          const Document& document) {
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.byteOrder = kByteOrder;
+    header.pageCount = document.pageCount;
+    if (!fileKey(boxFile, false, &header.box) ||
+            !fileKey(imageFile, true, &header.image))
+        return false;
+
+    // letters repeat a lot - store each one once
+    QVector<GlyphRecord> records;
+    QVector<PageRecord> directory(document.pages.size());
+    QString pool;
+    QHash<QString, quint32> poolIndex;
+    for (int p = 0; p < document.pages.size(); ++p) {
+        const GlyphPage& page = document.pages.at(p);
+        directory[p].firstGlyph = records.size();
+        directory[p].glyphCount = page.size();
+        for (int g = 0; g < page.size(); ++g) {
+            const Glyph& glyph = page.at(g);
+            QHash<QString, quint32>::const_iterator it =
+                    poolIndex.constFind(glyph.letter);
+            if (it == poolIndex.constEnd()) {
+                it = poolIndex.insert(glyph.letter, pool.size());
+                pool += glyph.letter;
+            }
+            GlyphRecord r;
+            r.left = glyph.left;
+            r.bottom = glyph.bottom;
+            r.right = glyph.right;
+            r.top = glyph.top;
+            r.page = glyph.page;
+            r.flags = (glyph.bold ? gfBold : 0) |
+                    (glyph.italic ? gfItalic : 0) |
+                    (glyph.underline ? gfUnderline : 0);
+            r.letterOffset = it.value();
+            r.letterLength = glyph.letter.size();
+            records.append(r);
+        }
+    }
+
+    header.sizeCount = document.pageSizes.size();
+    header.glyphPageCount = directory.size();
+    header.glyphCount = records.size();
+    header.stringPoolSize = pool.size();
+    header.sizesOffset = align8(sizeof(CacheHeader));
+    header.directoryOffset = align8(header.sizesOffset +
+                                    header.sizeCount * sizeof(PageSizeRecord));
+    header.glyphOffset = align8(header.directoryOffset +
+                                header.glyphPageCount * sizeof(PageRecord));
+    header.stringOffset = align8(header.glyphOffset +
+                                 header.glyphCount * sizeof(GlyphRecord));
+    header.fileSize = header.stringOffset + pool.size() * sizeof(QChar);
+
+    QByteArray data(header.fileSize, '\0');
+    char* out = data.data();
+    memcpy(out, &header, sizeof(header));
+    for (int i = 0; i < document.pageSizes.size(); ++i) {
+        PageSizeRecord r;
+        r.width = document.pageSizes.at(i).width();
+        r.height = document.pageSizes.at(i).height();
+        memcpy(out + header.sizesOffset + i * sizeof(r), &r, sizeof(r));
+    }
+    if (!directory.isEmpty())
+        memcpy(out + header.directoryOffset, directory.constData(),
+               directory.size() * sizeof(PageRecord));
+    if (!records.isEmpty())
+        memcpy(out + header.glyphOffset, records.constData(),
+               records.size() * sizeof(GlyphRecord));
+    if (!pool.isEmpty())
+        memcpy(out + header.stringOffset, pool.constData(),
+               pool.size() * sizeof(QChar));
+
+    // write to temporary file and replace old cache at once
+    QDir().mkpath(cacheDir());
+    QString fileName = cacheFileName(imageFile, boxFile);
+    QFile file(fileName + ".tmp");
+    if (!file.open(QFile::WriteOnly) || file.write(data) != data.size()) {
+        file.remove();
+        return false;
+    }
+    file.close();
+    QFile::remove(fileName);
+    return QFile::rename(file.fileName(), fileName);
+}
+
+void DocumentCache::remove(const QString& imageFile, const QString& boxFile) {
+    QFile::remove(cacheFileName(imageFile, boxFile));
+}
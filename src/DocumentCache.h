@@ -0,0 +1,71 @@
+/**********************************************************************
+* File:        DocumentCache.h
+* Description: Binary on-disk cache of parsed documents
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_DOCUMENTCACHE_H_
+#define SRC_DOCUMENTCACHE_H_
+
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+#include "Glyph.h"
+
+/**
+ * Binary cache of parsed box file and image metadata.
+ * One cache file per document is kept in "cache" directory next to
+ * settings file. It is keyed by size, modification time and content hash
+ * of box file and image file (image hash is computed from its head and
+ * tail only, so large images are not read). Layout is designed to be
+ * used directly from memory mapped file:
+ *
+ *   Header | page sizes | page directory | glyph records | string pool
+ *
+ * All sections are fixed size records (aligned to 8 bytes) except the
+ * UTF-16 string pool with letters.
+ */
+class DocumentCache {
+  public:
+    struct Document {
+        int pageCount;             /**< pages in image file */
+        QVector<QSize> pageSizes;  /**< size of image pages (null if unknown) */
+        QVector<GlyphPage> pages;  /**< parsed box file */
+    };
+
+    /** Read cache of document. Returns false if cache is missing, stale
+     *  or corrupted; caller should use normal loaders then.
+     */
+    static bool load(const QString& imageFile, const QString& boxFile,
+                     Document* document);
+    /** Write cache of document (replaces old one). */
+    static bool store(const QString& imageFile, const QString& boxFile,
+                      const Document& document);
+    /** Remove cache of document. */
+    static void remove(const QString& imageFile, const QString& boxFile);
+
+    /** Directory with cache files. */
+    static QString cacheDir();
+    /** Cache file used for document. */
+    static QString cacheFileName(const QString& imageFile,
+                                 const QString& boxFile);
+};
+
+#endif  // SRC_DOCUMENTCACHE_H_
@@ -0,0 +1,109 @@
+/**********************************************************************
+* File:        DocumentMemoryManager.cpp
+* Description: Global memory budget of open documents
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "DocumentMemoryManager.h"
+#include "ChildWidget.h"
+#include "Settings.h"
+
+#include <QSettings>
+
+namespace {
+
+// Default budget (MB) if not set
+const int kDefaultBudget = 1024;
+
+}  // namespace
+
+DocumentMemoryManager::DocumentMemoryManager(QObject* parent)
+    : QObject(parent), m_budget(budgetFromSettings()) {
+}
+
+qint64 DocumentMemoryManager::budgetFromSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    qint64 megabytes = settings.value("GUI/MemoryBudget",
+                                      kDefaultBudget).toLongLong();
+    return qMax(Q_INT64_C(0), megabytes) * 1024 * 1024;
+}
+
+void DocumentMemoryManager::setBudget(qint64 bytes) {
+    m_budget = bytes;
+    enforce();
+}
+
+void DocumentMemoryManager::prune() {
+    for (int i = m_documents.size() - 1; i >= 0; --i)
+        if (m_documents.at(i).isNull())
+            m_documents.removeAt(i);
+}
+
+void DocumentMemoryManager::activate(ChildWidget* document) {
+    prune();
+    for (int i = 0; i < m_documents.size(); ++i) {
+        if (m_documents.at(i) == document) {
+            m_documents.removeAt(i);
+            break;
+        }
+    }
+    m_documents.prepend(document);
+    if (document->isHibernated())
+        document->wakeUp();
+    enforce();
+}
+
+void DocumentMemoryManager::enforce() {
+    prune();
+    if (m_budget <= 0)
+        return;
+    qint64 total = totalUsage();
+    for (int i = m_documents.size() - 1; i > 0 && total > m_budget; --i) {
+        ChildWidget* document = m_documents.at(i);
+        if (document->isHibernated())
+            continue;
+        qint64 before = document->memoryUsage();
+        document->hibernate();
+        total -= before - document->memoryUsage();
+    }
+}
+
+QList<DocumentMemoryManager::Usage> DocumentMemoryManager::usage() {
+    prune();
+    QList<Usage> result;
+    for (int i = 0; i < m_documents.size(); ++i) {
+        ChildWidget* document = m_documents.at(i);
+        Usage item;
+        item.name = document->userFriendlyCurrentFile();
+        item.bytes = document->memoryUsage();
+        item.hibernated = document->isHibernated();
+        item.active = (i == 0);
+        result.append(item);
+    }
+    return result;
+}
+
+qint64 DocumentMemoryManager::totalUsage() {
+    prune();
+    qint64 total = 0;
+    for (int i = 0; i < m_documents.size(); ++i)
+        total += m_documents.at(i)->memoryUsage();
+    return total;
+}
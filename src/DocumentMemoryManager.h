@@ -0,0 +1,83 @@
+/**********************************************************************
+* File:        DocumentMemoryManager.h
+* Description: Global memory budget of open documents
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_DOCUMENTMEMORYMANAGER_H_
+#define SRC_DOCUMENTMEMORYMANAGER_H_
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+class ChildWidget;
+
+/**
+ * Keeps memory of all open documents (tabs) under one budget.
+ * Documents are ordered by last activation. When total memory exceeds
+ * the budget, least recently used documents are hibernated: their
+ * pixmap, scene items and table are dropped and only glyph data is kept.
+ * Hibernated document is restored when it is activated again.
+ * Budget is read from setting GUI/MemoryBudget (MB, 0 = unlimited).
+ */
+class DocumentMemoryManager : public QObject {
+    Q_OBJECT
+
+  public:
+    /** Memory report of one document. */
+    struct Usage {
+        QString name;
+        qint64 bytes;
+        bool hibernated;
+        bool active;
+    };
+
+    explicit DocumentMemoryManager(QObject* parent = 0);
+
+    /** Budget in bytes from settings (0 = unlimited). */
+    static qint64 budgetFromSettings();
+    void setBudget(qint64 bytes);
+    qint64 budget() const {
+        return m_budget;
+    }
+
+    /** Make document most recently used, restore it if it is hibernated
+     *  and hibernate others if budget is exceeded.
+     */
+    void activate(ChildWidget* document);
+    /** Usage of documents, most recently used first. */
+    QList<Usage> usage();
+    qint64 totalUsage();
+
+  public slots:
+    /** Hibernate least recently used documents until total memory fits
+     *  into budget. Active document is never hibernated.
+     */
+    void enforce();
+
+  private:
+    void prune();
+
+    QList<QPointer<ChildWidget> > m_documents;  /**< most recent first */
+    qint64 m_budget;
+};
+
+#endif  // SRC_DOCUMENTMEMORYMANAGER_H_
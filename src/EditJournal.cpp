@@ -0,0 +1,401 @@
+/**********************************************************************
+* File:        EditJournal.cpp
+* Description: Append-only journal of box edits for crash recovery
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "EditJournal.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QStandardItem>
+#include <QStandardItemModel>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'Q', 'B', 'E', 'J'};
+const quint32 kVersion = 1;
+const int kStreamVersion = QDataStream::Qt_4_6;
+// Records are synced to disk at most this often (ms)
+const int kFlushInterval = 500;
+
+enum RecordType {
+    rtInsertRow = 1,
+    rtRemoveRow,
+    rtSetField,
+    rtSetPage,
+    rtMoveRow
+};
+
+/*
+ * Identity of box file the journal applies to
+ */
+void boxFileKey(const QString& boxFile, qint64* size, qint64* modified) {
+    QFileInfo info(boxFile);
+    *size = info.exists() ? info.size() : -1;
+    *modified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+bool syncFile(QFile* file) {
+#ifdef Q_OS_WIN
+    return _commit(file->handle()) == 0;
+#else
+    return fsync(file->handle()) == 0;
+#endif
+}
+
+/*
+ * Reads header and checks it matches current box file
+ */
+bool readHeader(QDataStream* in, const QString& boxFile) {
+    char magic[4];
+    if (in->readRawData(magic, 4) != 4 || memcmp(magic, kMagic, 4) != 0)
+        return false;
+    quint32 version;
+    qint64 size, modified, boxSize, boxModified;
+    *in >> version >> size >> modified;
+    boxFileKey(boxFile, &boxSize, &boxModified);
+    return in->status() == QDataStream::Ok && version == kVersion &&
+            size == boxSize && modified == boxModified;
+}
+
+/*
+ * Set field of glyph; column is column of table model
+ */
+void setField(Glyph* glyph, int column, const QVariant& value) {
+    switch (column) {
+    case 0:
+        glyph->letter = value.toString();
+        break;
+    case 1:
+        glyph->left = value.toInt();
+        break;
+    case 2:
+        glyph->bottom = value.toInt();
+        break;
+    case 3:
+        glyph->right = value.toInt();
+        break;
+    case 4:
+        glyph->top = value.toInt();
+        break;
+    case 5:
+        glyph->page = value.toInt();
+        break;
+    case 6:
+        glyph->italic = value.toBool();
+        break;
+    case 7:
+        glyph->bold = value.toBool();
+        break;
+    case 8:
+        glyph->underline = value.toBool();
+        break;
+    default:
+        break;
+    }
+}
+
+bool applyRecord(const QByteArray& payload, QVector<GlyphPage>* pages) {
+    QDataStream in(payload);
+    in.setVersion(kStreamVersion);
+    quint8 type;
+    qint32 page, row;
+    in >> type >> page;
+    if (in.status() != QDataStream::Ok || page < 0)
+        return false;
+    if (page >= pages->size())
+        pages->resize(page + 1);
+    GlyphPage& glyphs = (*pages)[page];
+
+    switch (type) {
+    case rtInsertRow: {
+        in >> row;
+        if (row < 0 || row > glyphs.size())
+            return false;
+        Glyph glyph;
+        glyph.page = page;
+        glyphs.insert(row, glyph);
+        break;
+    }
+    case rtRemoveRow:
+        in >> row;
+        if (row < 0 || row >= glyphs.size())
+            return false;
+        glyphs.remove(row);
+        break;
+    case rtSetField: {
+        qint32 column;
+        QVariant value;
+        in >> row >> column >> value;
+        if (row < 0 || row >= glyphs.size())
+            return false;
+        setField(&glyphs[row], column, value);
+        break;
+    }
+    case rtSetPage: {
+        quint32 count;
+        in >> count;
+        GlyphPage replacement;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok;
+             ++i) {
+            Glyph glyph;
+            qint32 left, bottom, right, top, glyphPage;
+            bool bold, italic, underline;
+            in >> glyph.letter >> left >> bottom >> right >> top >> glyphPage
+               >> bold >> italic >> underline;
+            glyph.left = left;
+            glyph.bottom = bottom;
+            glyph.right = right;
+            glyph.top = top;
+            glyph.page = glyphPage;
+            glyph.bold = bold;
+            glyph.italic = italic;
+            glyph.underline = underline;
+            replacement.append(glyph);
+        }
+        glyphs = replacement;
+        break;
+    }
+    case rtMoveRow: {
+        qint32 to;
+        in >> row >> to;
+        if (row < 0 || row >= glyphs.size() || to < 0 || to >= glyphs.size())
+            return false;
+        Glyph glyph = glyphs.at(row);
+        glyphs.remove(row);
+        glyphs.insert(to, glyph);
+        break;
+    }
+    default:
+        return false;
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+}  // namespace
+
+EditJournal::EditJournal(QObject* parent)
+    : QObject(parent), m_page(0), m_imageHeight(0), m_suspended(false),
+      m_baseSize(-1), m_baseModified(-1) {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(kFlushInterval);
+    connect(&m_flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+EditJournal::~EditJournal() {
+    flush();
+}
+
+QString EditJournal::journalFileName(const QString& boxFile) {
+    return boxFile + ".qbej";
+}
+
+bool EditJournal::hasRecovery(const QString& boxFile) {
+    QFile file(journalFileName(boxFile));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    return readHeader(&in, boxFile) && !in.atEnd();
+}
+
+bool EditJournal::replay(const QString& boxFile, QVector<GlyphPage>* pages,
+                         int* applied) {
+    *applied = 0;
+    QFile file(journalFileName(boxFile));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    if (!readHeader(&in, boxFile))
+        return false;
+
+    QVector<GlyphPage> result = *pages;
+    while (!in.atEnd()) {
+        QByteArray payload;
+        quint16 checksum;
+        in >> payload >> checksum;
+        // torn tail of interrupted write - everything before it is valid
+        if (in.status() != QDataStream::Ok ||
+                checksum != qChecksum(payload.constData(), payload.size()))
+            break;
+        if (!applyRecord(payload, &result))
+            return false;
+        ++(*applied);
+    }
+    *pages = result;
+    return true;
+}
+
+void EditJournal::open(const QString& boxFile, bool keepExisting) {
+    flush();
+    m_file.close();
+    m_boxFile = boxFile;
+    if (!keepExisting)
+        QFile::remove(journalFileName(boxFile));
+    boxFileKey(boxFile, &m_baseSize, &m_baseModified);
+}
+
+void EditJournal::attach(QStandardItemModel* model, int page,
+                         int imageHeight) {
+    if (m_model)
+        disconnect(m_model, 0, this, 0);
+    m_model = model;
+    m_page = page;
+    m_imageHeight = imageHeight;
+    if (!model)
+        return;
+    connect(model, SIGNAL(rowsInserted(const QModelIndex&, int, int)),
+            this, SLOT(rowsInserted(const QModelIndex&, int, int)));
+    connect(model, SIGNAL(rowsRemoved(const QModelIndex&, int, int)),
+            this, SLOT(rowsRemoved(const QModelIndex&, int, int)));
+    connect(model, SIGNAL(itemChanged(QStandardItem*)),
+            this, SLOT(itemChanged(QStandardItem*)));
+}
+
+void EditJournal::recordPage(int page, const GlyphPage& glyphs) {
+    if (m_boxFile.isEmpty())
+        return;
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << quint8(rtSetPage) << qint32(page) << quint32(glyphs.size());
+    for (int i = 0; i < glyphs.size(); ++i) {
+        const Glyph& glyph = glyphs.at(i);
+        out << glyph.letter << qint32(glyph.left) << qint32(glyph.bottom)
+            << qint32(glyph.right) << qint32(glyph.top) << qint32(glyph.page)
+            << glyph.bold << glyph.italic << glyph.underline;
+    }
+    append(payload);
+}
+
+void EditJournal::recordMove(int from, int to) {
+    if (m_suspended || m_boxFile.isEmpty())
+        return;
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << quint8(rtMoveRow) << qint32(m_page) << qint32(from) << qint32(to);
+    append(payload);
+}
+
+void EditJournal::rowsInserted(const QModelIndex& parent, int first,
+                               int last) {
+    if (m_suspended || m_boxFile.isEmpty() || parent.isValid())
+        return;
+    for (int row = first; row <= last; ++row) {
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(kStreamVersion);
+        out << quint8(rtInsertRow) << qint32(m_page) << qint32(row);
+        append(payload);
+    }
+}
+
+void EditJournal::rowsRemoved(const QModelIndex& parent, int first,
+                              int last) {
+    if (m_suspended || m_boxFile.isEmpty() || parent.isValid())
+        return;
+    // removing the same index repeatedly removes the whole range on replay
+    for (int row = first; row <= last; ++row) {
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(kStreamVersion);
+        out << quint8(rtRemoveRow) << qint32(m_page) << qint32(first);
+        append(payload);
+    }
+}
+
+void EditJournal::itemChanged(QStandardItem* item) {
+    if (m_suspended || m_boxFile.isEmpty() || item->parent())
+        return;
+    // column 9 holds pointer to scene item
+    int column = item->column();
+    if (column < 0 || column > 8)
+        return;
+    QVariant value = item->data(Qt::EditRole);
+    if (column == 2 || column == 4)  // table shows image coordinates
+        value = m_imageHeight - value.toInt();
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << quint8(rtSetField) << qint32(m_page) << qint32(item->row())
+        << qint32(column) << value;
+    append(payload);
+}
+
+void EditJournal::append(const QByteArray& payload) {
+    QDataStream out(&m_buffer, QIODevice::WriteOnly | QIODevice::Append);
+    out.setVersion(kStreamVersion);
+    out << payload << qChecksum(payload.constData(), payload.size());
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+bool EditJournal::openFile() {
+    m_file.setFileName(journalFileName(m_boxFile));
+    if (!m_file.open(QFile::WriteOnly | QFile::Append))
+        return false;
+    if (m_file.size() == 0) {
+        QDataStream out(&m_file);
+        out.setVersion(kStreamVersion);
+        out.writeRawData(kMagic, 4);
+        out << kVersion << m_baseSize << m_baseModified;
+    }
+    return true;
+}
+
+void EditJournal::flush() {
+    m_flushTimer.stop();
+    if (m_buffer.isEmpty() || m_boxFile.isEmpty())
+        return;
+    if (!m_file.isOpen() && !openFile()) {
+        qDebug() << "Cannot write journal" << m_file.fileName()
+                 << m_file.errorString();
+        return;
+    }
+    m_file.write(m_buffer);
+    m_file.flush();
+    if (!syncFile(&m_file))
+        qDebug() << "Cannot sync journal" << m_file.fileName();
+    m_buffer.clear();
+}
+
+void EditJournal::discard() {
+    m_flushTimer.stop();
+    m_buffer.clear();
+    m_file.close();
+    if (m_boxFile.isEmpty())
+        return;
+    QFile::remove(journalFileName(m_boxFile));
+    // box file was (probably) rewritten - following edits apply to it
+    boxFileKey(m_boxFile, &m_baseSize, &m_baseModified);
+}
@@ -0,0 +1,119 @@
+/**********************************************************************
+* File:        EditJournal.h
+* Description: Append-only journal of box edits for crash recovery
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_EDITJOURNAL_H_
+#define SRC_EDITJOURNAL_H_
+
+#include <QByteArray>
+#include <QFile>
+#include <QModelIndex>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include "Glyph.h"
+
+class QStandardItem;
+class QStandardItemModel;
+
+/**
+ * Append-only journal of edits of one box file ("<box file>.qbej").
+ * Journal listens to table model of current page and records inserted and
+ * removed rows and changed fields (in tesseract coordinates), so every
+ * editing command (insert, split, join, delete, move, undo...) is covered.
+ * Records are collected in memory and written with one fsync per batch,
+ * so an edit costs only serialization of a few bytes.
+ *
+ * Header of journal identifies box file (size and modification time) the
+ * edits apply to. After crash the journal is replayed over parsed box
+ * file; normal save writes complete box file and removes the journal.
+ */
+class EditJournal : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit EditJournal(QObject* parent = 0);
+    ~EditJournal();
+
+    /** Journal file used for box file. */
+    static QString journalFileName(const QString& boxFile);
+    /** Returns true if box file has a journal with edits made on its
+     *  current version (i.e. there are unsaved edits from crashed session).
+     */
+    static bool hasRecovery(const QString& boxFile);
+    /** Apply journal of box file to pages. Stops at first torn record
+     *  (interrupted write). Returns false if journal is missing, stale
+     *  or does not match pages.
+     */
+    static bool replay(const QString& boxFile, QVector<GlyphPage>* pages,
+                       int* applied);
+
+    /** Start journal for box file. Existing journal is kept (and extended)
+     *  if keepExisting is true, otherwise it is removed.
+     */
+    void open(const QString& boxFile, bool keepExisting = false);
+    /** Record edits of model; model shows page with given image height. */
+    void attach(QStandardItemModel* model, int page, int imageHeight);
+    /** Ignore model changes (bulk loads of table). */
+    void setSuspended(bool suspended) {
+        m_suspended = suspended;
+    }
+    bool isSuspended() const {
+        return m_suspended;
+    }
+    /** Record complete content of page (e.g. page generated by tesseract). */
+    void recordPage(int page, const GlyphPage& glyphs);
+    /** Record move of row of attached page (rows are moved as whole, so
+     *  model signals do not carry their content).
+     */
+    void recordMove(int from, int to);
+    /** Remove journal (box file was saved or changes were discarded). */
+    void discard();
+
+  public slots:
+    /** Write pending records and sync them to disk. */
+    void flush();
+
+  private slots:
+    void rowsInserted(const QModelIndex& parent, int first, int last);
+    void rowsRemoved(const QModelIndex& parent, int first, int last);
+    void itemChanged(QStandardItem* item);
+
+  private:
+    void append(const QByteArray& payload);
+    bool openFile();
+
+    QString m_boxFile;
+    QFile m_file;
+    QByteArray m_buffer;  /**< records not written yet */
+    QTimer m_flushTimer;
+    QPointer<QStandardItemModel> m_model;
+    int m_page;
+    int m_imageHeight;
+    bool m_suspended;
+    qint64 m_baseSize;      /**< box file the edits apply to */
+    qint64 m_baseModified;
+};
+
+#endif  // SRC_EDITJOURNAL_H_
@@ -0,0 +1,235 @@
+/**********************************************************************
+* File:        FontSplitter.cpp
+* Description: Split box file and image by font attributes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "FontSplitter.h"
+#include "PageImage.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QtConcurrentMap>
+
+#include <cstring>
+
+namespace {
+
+struct StyleJob {
+    StyleJob() : written(false) {}
+
+    Glyph::FontStyle style;
+    QVector<Glyph> glyphs;
+    QString boxFile;
+    QString imageFile;
+    QString error;
+    bool written;  /**< output files were (partly) created */
+};
+
+/*
+ * Copy pixels <x0, x1) of one Format_Mono row (first pixel in MSB)
+ */
+void copyMonoSpan(const uchar* src, uchar* dst, int x0, int x1) {
+    int b0 = x0 >> 3;
+    int b1 = (x1 - 1) >> 3;
+    uchar m0 = 0xff >> (x0 & 7);
+    uchar m1 = static_cast<uchar>(0xff << (7 - ((x1 - 1) & 7)));
+    if (b0 == b1) {
+        uchar m = m0 & m1;
+        dst[b0] = (dst[b0] & ~m) | (src[b0] & m);
+        return;
+    }
+    dst[b0] = (dst[b0] & ~m0) | (src[b0] & m0);
+    if (b1 - b0 > 1)
+        memcpy(dst + b0 + 1, src + b0 + 1, b1 - b0 - 1);
+    dst[b1] = (dst[b1] & ~m1) | (src[b1] & m1);
+}
+
+bool isBilevel(const QImage& image) {
+    return image.format() == QImage::Format_Mono ||
+            image.format() == QImage::Format_MonoLSB;
+}
+
+class StyleWriter {
+  public:
+    typedef void result_type;
+
+    StyleWriter(const QImage& source, const CancelToken& cancel)
+        : m_source(source), m_cancel(cancel) {
+    }
+
+    void operator()(StyleJob& job) const {
+        if (m_cancel.isCancelled())
+            return;
+        QByteArray boxes;
+        boxes.reserve(job.glyphs.size() * 24);
+        for (int i = 0; i < job.glyphs.size(); ++i) {
+            boxes += job.glyphs.at(i).toBoxLine(false).toUtf8();
+            boxes += '\n';
+        }
+
+        QFile file(job.boxFile);
+        job.written = true;
+        if (!file.open(QFile::WriteOnly | QFile::Text) ||
+                file.write(boxes) != boxes.size()) {
+            job.error = QObject::tr("Cannot write file %1:\n%2.")
+                    .arg(job.boxFile).arg(file.errorString());
+            return;
+        }
+        file.close();
+        if (m_cancel.isCancelled())
+            return;
+
+        QImage image = FontSplitter::composeImage(m_source, job.glyphs);
+        if (!image.save(job.imageFile, "PNG"))
+            job.error = QObject::tr("Cannot write file %1.")
+                    .arg(job.imageFile);
+    }
+
+  private:
+    QImage m_source;
+    CancelToken m_cancel;
+};
+
+}  // namespace
+
+QString FontSplitter::outputFileName(const QString& boxFileName,
+                                     Glyph::FontStyle style, bool image) {
+    // find path + name + ext:
+    QFileInfo info(boxFileName);
+    int dotCount = info.fileName().count(".");
+    QStringList results = info.fileName().split(".");
+    QString path, base, ext;
+    path = info.path() + QDir::separator();
+
+    if (dotCount < 3) {
+        base = info.baseName();
+        ext = info.completeSuffix();
+    } else  {
+        for (int dot = 0; dot < (dotCount - 1); ++dot) {
+            base += results[dot];
+            if (dot < (dotCount - 2))
+                base += ".";
+        }
+        ext = results[(dotCount - 1)] + "." + results[dotCount];
+    }
+    if (image)
+        ext.replace(ext.size() - 3 , 3, "png");
+    return path + base + Glyph::fontStyleName(style) + "." + ext;
+}
+
+QImage FontSplitter::composeImage(const QImage& source,
+                                  const QVector<Glyph>& glyphs) {
+    const int imageHeight = source.height();
+    if (source.format() == QImage::Format_Mono) {
+        QImage result(source.size(), QImage::Format_Mono);
+        result.setColorTable(source.colorTable());
+        result.setDotsPerMeterX(source.dotsPerMeterX());
+        result.setDotsPerMeterY(source.dotsPerMeterY());
+        int white = 1 - PageImage::blackIndex(source);
+        result.fill(white);
+
+        const uchar* src = source.constBits();
+        uchar* dst = result.bits();
+        int bpl = source.bytesPerLine();
+        for (int i = 0; i < glyphs.size(); ++i) {
+            QRect r = glyphs.at(i).imageRect(imageHeight)
+                    .intersected(source.rect());
+            if (r.isEmpty())
+                continue;
+            for (int y = r.top(); y <= r.bottom(); ++y)
+                copyMonoSpan(src + y * bpl, dst + y * bpl, r.left(),
+                             r.right() + 1);
+        }
+        return result;
+    }
+
+    QImage rgb = source;
+    if (rgb.format() != QImage::Format_RGB32 &&
+            rgb.format() != QImage::Format_ARGB32)
+        rgb = rgb.convertToFormat(QImage::Format_RGB32);
+    QImage result(rgb.size(), QImage::Format_RGB32);
+    result.setDotsPerMeterX(source.dotsPerMeterX());
+    result.setDotsPerMeterY(source.dotsPerMeterY());
+    result.fill(0xffffffff);
+
+    const uchar* src = rgb.constBits();
+    uchar* dst = result.bits();
+    int bpl = rgb.bytesPerLine();
+    for (int i = 0; i < glyphs.size(); ++i) {
+        QRect r = glyphs.at(i).imageRect(imageHeight).intersected(rgb.rect());
+        if (r.isEmpty())
+            continue;
+        int offset = r.left() * 4;
+        for (int y = r.top(); y <= r.bottom(); ++y)
+            memcpy(dst + y * bpl + offset, src + y * bpl + offset,
+                   r.width() * 4);
+    }
+    return result;
+}
+
+QStringList FontSplitter::exportSplit(const QImage& source,
+                                      const QVector<Glyph>& glyphs,
+                                      const QString& boxFileName,
+                                      const CancelToken& cancel) {
+    QVector<StyleJob> jobs(Glyph::FontStyleCount);
+    for (int i = 0; i < glyphs.size(); ++i)
+        jobs[glyphs.at(i).fontStyle()].glyphs.append(glyphs.at(i));
+
+    QVector<StyleJob> work;
+    for (int style = 0; style < jobs.size(); ++style) {
+        if (jobs.at(style).glyphs.isEmpty())
+            continue;
+        StyleJob job = jobs.at(style);
+        job.style = static_cast<Glyph::FontStyle>(style);
+        job.boxFile = outputFileName(boxFileName, job.style, false);
+        job.imageFile = outputFileName(boxFileName, job.style, true);
+        work.append(job);
+    }
+
+    // all jobs borrow one prepared source image
+    QImage prepared = source;
+    if (source.format() == QImage::Format_MonoLSB)
+        prepared = source.convertToFormat(QImage::Format_Mono);
+    else if (!isBilevel(source) &&
+             source.format() != QImage::Format_RGB32 &&
+             source.format() != QImage::Format_ARGB32)
+        prepared = source.convertToFormat(QImage::Format_RGB32);
+
+    QtConcurrent::blockingMap(work, StyleWriter(prepared, cancel));
+
+    QStringList errors;
+    if (cancel.isCancelled()) {
+        for (int i = 0; i < work.size(); ++i) {
+            if (!work.at(i).written)
+                continue;
+            QFile::remove(work.at(i).boxFile);
+            QFile::remove(work.at(i).imageFile);
+        }
+        errors << QObject::tr("Export was cancelled.");
+        return errors;
+    }
+
+    for (int i = 0; i < work.size(); ++i)
+        if (!work.at(i).error.isEmpty())
+            errors << work.at(i).error;
+    return errors;
+}
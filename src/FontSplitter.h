@@ -0,0 +1,64 @@
+/**********************************************************************
+* File:        FontSplitter.h
+* Description: Split box file and image by font attributes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_FONTSPLITTER_H_
+#define SRC_FONTSPLITTER_H_
+
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "CancelToken.h"
+#include "Glyph.h"
+
+/**
+ * Split-by-font export.
+ * Glyphs are partitioned by font style in one pass; then box file and
+ * image of each style are composed and written concurrently. Boxes are
+ * copied straight from shared source image into white page. Bilevel
+ * source gives 1 bpp (Format_Mono) png, other sources RGB32 png.
+ */
+class FontSplitter {
+  public:
+    /** Write one box file + image per font style present in glyphs.
+     *  Output names are derived from boxFileName (see outputFileName).
+     *  Returns list of error messages (empty on success). Files written
+     *  before cancel are removed again.
+     */
+    static QStringList exportSplit(const QImage& source,
+                                   const QVector<Glyph>& glyphs,
+                                   const QString& boxFileName,
+                                   const CancelToken& cancel = CancelToken());
+
+    /** Name of output file for style: eng.times.exp001.box gives
+     *  eng.timesbold.exp001.box (or .png if image is true).
+     */
+    static QString outputFileName(const QString& boxFileName,
+                                  Glyph::FontStyle style, bool image);
+
+    /** Copy glyph boxes of source into new white page. */
+    static QImage composeImage(const QImage& source,
+                               const QVector<Glyph>& glyphs);
+};
+
+#endif  // SRC_FONTSPLITTER_H_
@@ -0,0 +1,137 @@
+/**********************************************************************
+* File:        Glyph.cpp
+* Description: One box of box file (symbol, bounding box, font attributes)
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "Glyph.h"
+
+Glyph::Glyph()
+    : left(0), bottom(0), right(0), top(0), page(0), bold(false),
+      italic(false), underline(false), confidence(-1) {
+}
+
+bool Glyph::operator==(const Glyph& other) const {
+    return left == other.left && bottom == other.bottom &&
+            right == other.right && top == other.top && page == other.page &&
+            bold == other.bold && italic == other.italic &&
+            underline == other.underline && letter == other.letter;
+}
+
+bool Glyph::fromBoxFields(const QStringList& fields, Glyph* glyph) {
+    if (fields.size() != 6)
+        return false;
+
+    QString letter = fields.at(0);
+    glyph->bold = glyph->italic = glyph->underline = false;
+    // formating is present only in case there are more than 2 letters
+    if (letter.size() > 1 && letter.at(0) == '@') {
+        glyph->bold = true;
+        letter.remove(0, 1);
+    }
+    if (letter.size() > 1 && letter.at(0) == '$') {
+        glyph->italic = true;
+        letter.remove(0, 1);
+    }
+    if (letter.size() > 1 && letter.at(0) == '\'') {
+        glyph->underline = true;
+        letter.remove(0, 1);
+    }
+    glyph->letter = letter;
+    glyph->left = fields.at(1).toInt();
+    glyph->bottom = fields.at(2).toInt();
+    glyph->right = fields.at(3).toInt();
+    glyph->top = fields.at(4).toInt();
+    glyph->page = fields.at(5).toInt();
+    return true;
+}
+
+bool Glyph::fromBoxLine(const QString& line, Glyph* glyph) {
+    QStringList fields = line.split(" ");
+    if (fields.size() == 7) {
+        if (line.startsWith(" "))
+            fields.removeFirst();  // tess2image generate also box for spaces
+        else
+            fields.removeLast();
+    }
+    return fromBoxFields(fields, glyph);
+}
+
+QString Glyph::styledLetter() const {
+    QString styled = letter;
+    if (underline)
+        styled.prepend("\'");
+    if (italic)
+        styled.prepend("$");
+    if (bold)
+        styled.prepend("@");
+    return styled;
+}
+
+QStringList Glyph::toBoxFields(bool withStyle) const {
+    QStringList fields;
+    fields << (withStyle ? styledLetter() : letter)
+           << QString::number(left) << QString::number(bottom)
+           << QString::number(right) << QString::number(top)
+           << QString::number(page);
+    return fields;
+}
+
+QString Glyph::toBoxLine(bool withStyle) const {
+    return toBoxFields(withStyle).join(" ");
+}
+
+QRect Glyph::imageRect(int imageHeight) const {
+    return QRect(QPoint(left, imageHeight - top),
+                 QPoint(right - 1, imageHeight - bottom - 1));
+}
+
+void Glyph::setImageRect(const QRect& rect, int imageHeight) {
+    left = rect.left();
+    right = rect.right() + 1;
+    top = imageHeight - rect.top();
+    bottom = imageHeight - rect.bottom() - 1;
+}
+
+Glyph::FontStyle Glyph::fontStyle() const {
+    if (bold && !italic)
+        return Bold;
+    if (italic && !bold)
+        return Italic;
+    if (italic && bold)
+        return BoldItalic;
+    if (underline)
+        return Underline;
+    return Normal;
+}
+
+QString Glyph::fontStyleName(FontStyle style) {
+    switch (style) {
+    case Bold:
+        return "bold";
+    case Italic:
+        return "italic";
+    case BoldItalic:
+        return "bolditalic";
+    case Underline:
+        return "underline";
+    default:
+        return "normal";
+    }
+}
@@ -0,0 +1,95 @@
+/**********************************************************************
+* File:        Glyph.h
+* Description: One box of box file (symbol, bounding box, font attributes)
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_GLYPH_H_
+#define SRC_GLYPH_H_
+
+#include <QRect>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * One line of tesseract box file.
+ * Coordinates are in tesseract coordinate system (origin in bottom left
+ * corner of page). Font attributes are kept separately from letter; in
+ * box file they are stored as letter prefixes ('@' bold, '$' italic,
+ * '\'' underline). Confidence of generated glyphs is kept only in memory;
+ * it is not part of box file and it is ignored by comparison.
+ */
+struct Glyph {
+    enum FontStyle {
+        Normal = 0,
+        Bold,
+        Italic,
+        BoldItalic,
+        Underline,
+        FontStyleCount
+    };
+
+    Glyph();
+
+    bool operator==(const Glyph& other) const;
+    bool operator!=(const Glyph& other) const {
+        return !(*this == other);
+    }
+
+    /** Parse split box line (letter left bottom right top page).
+     *  Returns false if number of fields is wrong.
+     */
+    static bool fromBoxFields(const QStringList& fields, Glyph* glyph);
+    /** Parse box line. Leading space of space box (tess2image) and
+     *  trailing empty field are ignored.
+     */
+    static bool fromBoxLine(const QString& line, Glyph* glyph);
+
+    /** Letter including font attribute prefixes. */
+    QString styledLetter() const;
+    /** Fields of box line; font prefixes are added if withStyle is true. */
+    QStringList toBoxFields(bool withStyle = true) const;
+    QString toBoxLine(bool withStyle = true) const;
+
+    /** Bounding box in image coordinates (origin in top left corner). */
+    QRect imageRect(int imageHeight) const;
+    /** Set bounding box from rectangle in image coordinates. */
+    void setImageRect(const QRect& rect, int imageHeight);
+    /** Font category used by split-by-font export. */
+    FontStyle fontStyle() const;
+    /** Name of font category used in file names (e.g. "bolditalic"). */
+    static QString fontStyleName(FontStyle style);
+
+    QString letter;
+    int left;
+    int bottom;
+    int right;
+    int top;
+    int page;
+    bool bold;
+    bool italic;
+    bool underline;
+    float confidence;  /**< recognizer confidence 0-100, negative if unknown */
+};
+
+/** Glyphs of one page in box file order. */
+typedef QVector<Glyph> GlyphPage;
+
+#endif  // SRC_GLYPH_H_
@@ -0,0 +1,58 @@
+/**********************************************************************
+* File:        GlyphDiff.cpp
+* Description: Minimal differences between two versions of box file
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "GlyphDiff.h"
+
+GlyphDiff::Hunk GlyphDiff::diffPage(int page, const GlyphPage& from,
+                                    const GlyphPage& to) {
+    Hunk hunk;
+    hunk.page = page;
+    int prefix = 0;
+    int common = qMin(from.size(), to.size());
+    while (prefix < common && from.at(prefix) == to.at(prefix))
+        ++prefix;
+    int suffix = 0;
+    while (suffix < common - prefix &&
+           from.at(from.size() - 1 - suffix) == to.at(to.size() - 1 - suffix))
+        ++suffix;
+
+    hunk.first = prefix;
+    hunk.removed = from.size() - prefix - suffix;
+    hunk.inserted = to.mid(prefix, to.size() - prefix - suffix);
+    return hunk;
+}
+
+QVector<GlyphDiff::Hunk> GlyphDiff::diff(const QVector<GlyphPage>& from,
+                                         const QVector<GlyphPage>& to) {
+    QVector<Hunk> hunks;
+    int pageCount = qMax(from.size(), to.size());
+    GlyphPage empty;
+    for (int page = 0; page < pageCount; ++page) {
+        const GlyphPage& oldPage = page < from.size() ? from.at(page) : empty;
+        const GlyphPage& newPage = page < to.size() ? to.at(page) : empty;
+        // untouched pages share data with snapshot and compare in O(1)
+        if (oldPage == newPage)
+            continue;
+        hunks.append(diffPage(page, oldPage, newPage));
+    }
+    return hunks;
+}
@@ -0,0 +1,56 @@
+/**********************************************************************
+* File:        GlyphDiff.h
+* Description: Minimal differences between two versions of box file
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_GLYPHDIFF_H_
+#define SRC_GLYPHDIFF_H_
+
+#include <QVector>
+
+#include "Glyph.h"
+
+/**
+ * Differences between two versions of document (all pages of box file).
+ * Every changed page is described by one hunk: glyphs between common
+ * prefix and common suffix of old and new page are replaced. Pages that
+ * share data or compare equal produce no hunk, so applying the hunks
+ * touches only what really changed.
+ */
+class GlyphDiff {
+  public:
+    struct Hunk {
+        int page;
+        int first;          /**< first changed glyph (old and new page) */
+        int removed;        /**< glyphs of old page replaced */
+        GlyphPage inserted; /**< glyphs of new page put instead */
+    };
+
+    /** Hunks that turn document from into document to (ordered by page).
+     *  Pages missing in to are reported as hunks removing all glyphs.
+     */
+    static QVector<Hunk> diff(const QVector<GlyphPage>& from,
+                              const QVector<GlyphPage>& to);
+    /** Hunk of one page (removed == 0 and inserted empty if equal). */
+    static Hunk diffPage(int page, const GlyphPage& from,
+                         const GlyphPage& to);
+};
+
+#endif  // SRC_GLYPHDIFF_H_
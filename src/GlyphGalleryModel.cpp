@@ -0,0 +1,258 @@
+/**********************************************************************
+* File:        GlyphGalleryModel.cpp
+* Description: Lazily rendered thumbnails of glyph boxes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "GlyphGalleryModel.h"
+
+#include <QMetaType>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPair>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+
+namespace {
+
+// Thumbnails rendered by worker before handing them to model
+const int kBatchSize = 16;
+// Older requests are dropped (view asks again for visible rows)
+const int kMaxPending = 1024;
+// Decoded pages kept by workers besides pages loaded by document
+const int kRecentPages = 4;
+// Thumbnails kept in cache
+const int kCacheSize = 5000;
+// Small glyphs are not enlarged more than this
+const int kMaxZoom = 4;
+
+QImage renderThumbnail(const QImage& page, const QRect& box) {
+    const int size = GlyphGalleryModel::kThumbnailSize;
+    QImage thumbnail(size, size, QImage::Format_RGB32);
+    thumbnail.fill(qRgb(255, 255, 255));
+    QRect rect = box.adjusted(-1, -1, 1, 1).intersected(page.rect());
+    if (rect.isEmpty())
+        return thumbnail;
+
+    QImage crop = page.copy(rect);
+    QSize fit = crop.size();
+    fit.scale(size - 2, size - 2, Qt::KeepAspectRatio);
+    if (fit.width() > kMaxZoom * crop.width())
+        fit = crop.size() * kMaxZoom;
+    QImage scaled = crop.scaled(fit, Qt::IgnoreAspectRatio,
+                                Qt::SmoothTransformation);
+    QPainter painter(&thumbnail);
+    painter.drawImage((size - scaled.width()) / 2,
+                      (size - scaled.height()) / 2, scaled);
+    return thumbnail;
+}
+
+}  // namespace
+
+/*
+ * Rows waiting for thumbnail, shared by model and its workers
+ */
+class RenderQueue {
+  public:
+    RenderQueue(const QString& imageFile,
+                const QHash<int, PageImagePtr>& loaded,
+                const QVector<GlyphGalleryModel::Item>& items,
+                int generation)
+        : imageFile(imageFile), loaded(loaded), items(items),
+          generation(generation), workers(0), stopped(false) {
+    }
+
+    /** Take newest requests; false (and worker ends) if there are none. */
+    bool take(QList<int>* rows) {
+        QMutexLocker locker(&mutex);
+        rows->clear();
+        while (!stopped && !pending.isEmpty() && rows->size() < kBatchSize)
+            rows->append(pending.takeLast());
+        if (rows->isEmpty()) {
+            --workers;
+            return false;
+        }
+        return true;
+    }
+
+    PageImagePtr page(int page) {
+        {
+            QMutexLocker locker(&mutex);
+            PageImagePtr image = loaded.value(page);
+            if (image)
+                return image;
+            for (int i = 0; i < recent.size(); ++i)
+                if (recent.at(i).first == page)
+                    return recent.at(i).second;
+        }
+        // decode without lock, other workers may crop meanwhile
+        PageImagePtr image = PageImage::load(imageFile, page);
+        QMutexLocker locker(&mutex);
+        recent.prepend(qMakePair(page, image));
+        while (recent.size() > kRecentPages)
+            recent.removeLast();
+        return image;
+    }
+
+    const QString imageFile;
+    const QHash<int, PageImagePtr> loaded;
+    const QVector<GlyphGalleryModel::Item> items;
+    const int generation;
+
+    QMutex mutex;         /**< guards members below */
+    QList<int> pending;   /**< newest request last */
+    QSet<int> requested;  /**< pending or being rendered */
+    QList<QPair<int, PageImagePtr> > recent;
+    int workers;
+    bool stopped;
+};
+
+namespace {
+
+class RenderTask : public QRunnable {
+  public:
+    RenderTask(const QSharedPointer<RenderQueue>& queue,
+               GlyphGalleryModel* model)
+        : m_queue(queue), m_model(model) {
+    }
+
+    void run() {
+        QList<int> rows;
+        while (m_queue->take(&rows)) {
+            QList<QImage> images;
+            for (int i = 0; i < rows.size(); ++i) {
+                const GlyphGalleryModel::Item& item =
+                        m_queue->items.at(rows.at(i));
+                PageImagePtr page = m_queue->page(item.page);
+                images.append(page ? renderThumbnail(
+                                  page->image(),
+                                  item.glyph.imageRect(page->height()))
+                                   : QImage());
+            }
+            // model waits for workers before it is deleted
+            QMetaObject::invokeMethod(m_model, "addThumbnails",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QList<int>, rows),
+                                      Q_ARG(QList<QImage>, images),
+                                      Q_ARG(int, m_queue->generation));
+        }
+    }
+
+  private:
+    QSharedPointer<RenderQueue> m_queue;
+    GlyphGalleryModel* m_model;
+};
+
+}  // namespace
+
+GlyphGalleryModel::GlyphGalleryModel(QObject* parent)
+    : QAbstractListModel(parent), m_cache(kCacheSize) {
+    qRegisterMetaType<QList<int> >("QList<int>");
+    qRegisterMetaType<QList<QImage> >("QList<QImage>");
+    m_queue = QSharedPointer<RenderQueue>(
+                new RenderQueue(QString(), QHash<int, PageImagePtr>(),
+                                QVector<Item>(), 0));
+    m_placeholder = QPixmap(kThumbnailSize, kThumbnailSize);
+    m_placeholder.fill(QColor(230, 230, 230));
+    m_failed = QPixmap(kThumbnailSize, kThumbnailSize);
+    m_failed.fill(QColor(240, 200, 200));
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+GlyphGalleryModel::~GlyphGalleryModel() {
+    {
+        QMutexLocker locker(&m_queue->mutex);
+        m_queue->stopped = true;
+    }
+    m_pool.waitForDone();
+}
+
+void GlyphGalleryModel::setItems(const QString& imageFile,
+                                 const QHash<int, PageImagePtr>& loaded,
+                                 const QVector<Item>& items) {
+    int generation = m_queue->generation + 1;
+    {
+        QMutexLocker locker(&m_queue->mutex);
+        m_queue->stopped = true;
+    }
+    beginResetModel();
+    m_items = items;
+    m_cache.clear();
+    m_queue = QSharedPointer<RenderQueue>(
+                new RenderQueue(imageFile, loaded, items, generation));
+    endResetModel();
+}
+
+int GlyphGalleryModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_items.size();
+}
+
+QVariant GlyphGalleryModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_items.size())
+        return QVariant();
+    const Item& item = m_items.at(index.row());
+    switch (role) {
+    case Qt::DecorationRole: {
+        QPixmap* thumbnail = m_cache.object(index.row());
+        if (thumbnail)
+            return *thumbnail;
+        requestThumbnail(index.row());
+        return m_placeholder;
+    }
+    case Qt::ToolTipRole:
+        return tr("Page %1, row %2").arg(item.page + 1).arg(item.row + 1);
+    default:
+        return QVariant();
+    }
+}
+
+void GlyphGalleryModel::requestThumbnail(int row) const {
+    QMutexLocker locker(&m_queue->mutex);
+    if (m_queue->requested.contains(row))
+        return;
+    m_queue->requested.insert(row);
+    m_queue->pending.append(row);
+    while (m_queue->pending.size() > kMaxPending)
+        m_queue->requested.remove(m_queue->pending.takeFirst());
+    if (m_queue->workers < m_pool.maxThreadCount()) {
+        ++m_queue->workers;
+        m_pool.start(new RenderTask(
+                         m_queue, const_cast<GlyphGalleryModel*>(this)));
+    }
+}
+
+void GlyphGalleryModel::addThumbnails(const QList<int>& rows,
+                                      const QList<QImage>& images,
+                                      int generation) {
+    if (generation != m_queue->generation)
+        return;
+    QMutexLocker locker(&m_queue->mutex);
+    for (int i = 0; i < rows.size(); ++i) {
+        m_queue->requested.remove(rows.at(i));
+        // failed thumbnail is cached too, so page is not decoded again
+        m_cache.insert(rows.at(i), images.at(i).isNull()
+                       ? new QPixmap(m_failed)
+                       : new QPixmap(QPixmap::fromImage(images.at(i))));
+    }
+    locker.unlock();
+    for (int i = 0; i < rows.size(); ++i)
+        emit dataChanged(index(rows.at(i)), index(rows.at(i)));
+}
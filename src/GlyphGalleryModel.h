@@ -0,0 +1,92 @@
+/**********************************************************************
+* File:        GlyphGalleryModel.h
+* Description: Lazily rendered thumbnails of glyph boxes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_GLYPHGALLERYMODEL_H_
+#define SRC_GLYPHGALLERYMODEL_H_
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include "Glyph.h"
+#include "PageImage.h"
+
+class RenderQueue;
+
+/**
+ * List model of glyph boxes shown as thumbnails (e.g. all instances of
+ * one letter in document).
+ * Thumbnails are cropped from shared page images on worker threads only
+ * when view asks for them; most recently requested rows are rendered
+ * first, so fast scrolling does not wait for rows that are no longer
+ * visible. Rendered thumbnails are kept in LRU cache.
+ */
+class GlyphGalleryModel : public QAbstractListModel {
+    Q_OBJECT
+
+  public:
+    struct Item {
+        int page;   /**< index of page in document */
+        int row;    /**< index of box in page */
+        Glyph glyph;
+    };
+
+    /** Side of square thumbnail. */
+    static const int kThumbnailSize = 48;
+
+    explicit GlyphGalleryModel(QObject* parent = 0);
+    ~GlyphGalleryModel();
+
+    /** Show items; pages missing in loaded are decoded from imageFile. */
+    void setItems(const QString& imageFile,
+                  const QHash<int, PageImagePtr>& loaded,
+                  const QVector<Item>& items);
+    const Item& item(int row) const {
+        return m_items.at(row);
+    }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role) const;
+
+  private slots:
+    void addThumbnails(const QList<int>& rows, const QList<QImage>& images,
+                       int generation);
+
+  private:
+    void requestThumbnail(int row) const;
+
+    QVector<Item> m_items;
+    QSharedPointer<RenderQueue> m_queue;
+    mutable QCache<int, QPixmap> m_cache;  /**< row -> thumbnail */
+    QPixmap m_placeholder;
+    QPixmap m_failed;  /**< thumbnail of box whose page cannot be loaded */
+    mutable QThreadPool m_pool;
+};
+
+#endif  // SRC_GLYPHGALLERYMODEL_H_
@@ -0,0 +1,69 @@
+/**********************************************************************
+* File:        GlyphImage.cpp
+* Description: Crop and normalize glyph images
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "GlyphImage.h"
+#include "PageImage.h"
+
+#include <QVector>
+
+#include <cstring>
+
+QImage GlyphImage::blankCell(int width, int height) {
+    QImage cell(width, height, QImage::Format_Indexed8);
+    QVector<QRgb> grayTable(256);
+    for (int i = 0; i < 256; ++i)
+        grayTable[i] = qRgb(i, i, i);
+    cell.setColorTable(grayTable);
+    cell.fill(255);
+    return cell;
+}
+
+QImage GlyphImage::crop(const QImage& gray, const QRect& rect) {
+    QRect r = rect.intersected(gray.rect());
+    if (r.isEmpty())
+        return QImage();
+    return gray.copy(r);
+}
+
+QImage GlyphImage::normalize(const QImage& crop, int size) {
+    QImage cell = blankCell(size, size);
+    if (crop.isNull())
+        return cell;
+
+    // keep 1 px white border around glyph
+    int inner = qMax(1, size - 2);
+    QImage scaled = crop.scaled(inner, inner, Qt::KeepAspectRatio,
+                                Qt::SmoothTransformation);
+    scaled = PageImage::toGrayscale(scaled);
+
+    int x0 = (size - scaled.width()) / 2;
+    int y0 = (size - scaled.height()) / 2;
+    for (int y = 0; y < scaled.height(); ++y)
+        memcpy(cell.scanLine(y0 + y) + x0, scaled.constScanLine(y),
+               scaled.width());
+    return cell;
+}
+
+QImage GlyphImage::normalized(const QImage& gray, const QRect& rect,
+                              int size) {
+    return normalize(crop(gray, rect), size);
+}
@@ -0,0 +1,50 @@
+/**********************************************************************
+* File:        GlyphImage.h
+* Description: Crop and normalize glyph images
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_GLYPHIMAGE_H_
+#define SRC_GLYPHIMAGE_H_
+
+#include <QImage>
+#include <QRect>
+
+/**
+ * Helpers for cutting glyph boxes out of page image.
+ * Cells are 8 bit indexed with identity gray table
+ * (see PageImage::toGrayscale); pages may also be packed 1 bpp.
+ */
+class GlyphImage {
+  public:
+    /** Crop rect (image coordinates) from grayscale or 1 bpp page. Rect is
+     *  clipped to page; returns null image if nothing remains.
+     */
+    static QImage crop(const QImage& gray, const QRect& rect);
+    /** Scale crop to fit size x size cell keeping aspect ratio and center
+     *  it on white background. Null crop gives white cell.
+     */
+    static QImage normalize(const QImage& crop, int size);
+    /** crop() followed by normalize(). */
+    static QImage normalized(const QImage& gray, const QRect& rect, int size);
+    /** White width x height grayscale image. */
+    static QImage blankCell(int width, int height);
+};
+
+#endif  // SRC_GLYPHIMAGE_H_
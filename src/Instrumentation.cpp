@@ -0,0 +1,115 @@
+/**********************************************************************
+* File:        Instrumentation.cpp
+* Description: Timing log of long running operations
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "Instrumentation.h"
+#include "Settings.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegExp>
+#include <QSettings>
+#include <QStringList>
+#include <QTextStream>
+
+namespace {
+
+// log is rotated when it grows over this size
+const qint64 kMaxLogSize = 4 * 1024 * 1024;
+
+// serializes appends of worker threads and guards cached settings
+QMutex logMutex;
+bool settingsRead = false;
+bool enabled = false;
+QString logFile;
+
+QString csvField(const QString& value) {
+    if (!value.contains(QRegExp("[\",\n]")))
+        return value;
+    QString quoted = value;
+    quoted.replace("\"", "\"\"");
+    return "\"" + quoted + "\"";
+}
+
+// caller holds logMutex
+void loadSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    enabled = settings.value("GUI/Instrumentation", false).toBool();
+    logFile = QFileInfo(settings.fileName()).absolutePath() +
+            "/instrumentation.csv";
+    settingsRead = true;
+}
+
+}  // namespace
+
+bool Instrumentation::isEnabled() {
+    QMutexLocker locker(&logMutex);
+    if (!settingsRead)
+        loadSettings();
+    return enabled;
+}
+
+void Instrumentation::readSettings() {
+    QMutexLocker locker(&logMutex);
+    loadSettings();
+}
+
+QString Instrumentation::logFileName() {
+    QMutexLocker locker(&logMutex);
+    if (!settingsRead)
+        loadSettings();
+    return logFile;
+}
+
+void Instrumentation::record(const QString& operation,
+                             const QString& fileName, int page, qint64 msecs,
+                             const QString& result, const QString& detail) {
+    if (!isEnabled())
+        return;
+
+    QStringList fields;
+    fields << QDateTime::currentDateTime().toString(Qt::ISODate)
+           << csvField(operation) << csvField(fileName)
+           << QString::number(page) << QString::number(msecs)
+           << csvField(result) << csvField(detail);
+
+    QMutexLocker locker(&logMutex);
+    QDir().mkpath(QFileInfo(logFile).absolutePath());
+    QFile file(logFile);
+    if (file.size() > kMaxLogSize) {
+        QFile::remove(logFile + ".1");
+        file.rename(logFile + ".1");
+        file.setFileName(logFile);
+    }
+    bool newFile = !file.exists();
+    if (!file.open(QFile::WriteOnly | QFile::Append | QFile::Text))
+        return;
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    if (newFile)
+        out << "time,operation,file,page,msecs,result,detail\n";
+    out << fields.join(",") << "\n";
+}
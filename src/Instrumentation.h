@@ -0,0 +1,48 @@
+/**********************************************************************
+* File:        Instrumentation.h
+* Description: Timing log of long running operations
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_INSTRUMENTATION_H_
+#define SRC_INSTRUMENTATION_H_
+
+#include <QString>
+
+/**
+ * Timing log for finding pathological pages and slow operations.
+ * Each record is appended as one CSV row (time, operation, file, page,
+ * milliseconds, result, detail) to instrumentation.csv next to settings
+ * file. Logging is off unless GUI/Instrumentation is set; full log is
+ * renamed to instrumentation.csv.1 (replacing older one). Records may be
+ * written from any thread.
+ */
+class Instrumentation {
+  public:
+    /** Setting is read once; readSettings() refreshes it. */
+    static bool isEnabled();
+    /** Read GUI/Instrumentation again (after settings were changed). */
+    static void readSettings();
+    static QString logFileName();
+    static void record(const QString& operation, const QString& fileName,
+                       int page, qint64 msecs, const QString& result,
+                       const QString& detail = QString());
+};
+
+#endif  // SRC_INSTRUMENTATION_H_
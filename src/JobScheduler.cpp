@@ -0,0 +1,290 @@
+/**********************************************************************
+* File:        JobScheduler.cpp
+* Description: Prioritized background jobs with cancellation and metrics
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "JobScheduler.h"
+#include "Instrumentation.h"
+
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThread>
+
+namespace {
+
+// Ended jobs kept for jobs panel
+const int kHistorySize = 200;
+
+class JobRunner : public QRunnable {
+  public:
+    JobRunner(JobScheduler* scheduler, int id,
+              const QSharedPointer<JobScheduler::Job>& job)
+        : m_scheduler(scheduler), m_id(id), m_job(job) {
+    }
+
+    void run() {
+        QString error;
+        bool ok = !m_job->isCancelled() && m_job->run(&error);
+        // scheduler waits for workers before it is deleted
+        QMetaObject::invokeMethod(m_scheduler, "runnerFinished",
+                                  Qt::QueuedConnection, Q_ARG(int, m_id),
+                                  Q_ARG(bool, ok), Q_ARG(QString, error));
+    }
+
+  private:
+    JobScheduler* m_scheduler;
+    int m_id;
+    QSharedPointer<JobScheduler::Job> m_job;
+};
+
+}  // namespace
+
+JobScheduler::Job::Job(const QString& name, const QString& document,
+                       Priority priority)
+    : m_name(name), m_document(document), m_priority(priority) {
+}
+
+JobScheduler::Job::~Job() {
+}
+
+void JobScheduler::Job::finish(State /*state*/, const QString& /*error*/) {
+}
+
+JobScheduler::Info::Info()
+    : id(0), priority(Normal), state(Waiting), queuedMs(0), runMs(0) {
+}
+
+JobScheduler* JobScheduler::instance() {
+    static JobScheduler* scheduler = 0;
+    if (!scheduler)
+        scheduler = new JobScheduler(QCoreApplication::instance());
+    return scheduler;
+}
+
+JobScheduler::JobScheduler(QObject* parent)
+    : QObject(parent), m_nextId(1), m_runningBulk(0) {
+    // at least one worker for interactive jobs besides bulk ones
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+    m_clock.start();
+}
+
+JobScheduler::~JobScheduler() {
+    QMap<int, Entry>::iterator it;
+    for (it = m_active.begin(); it != m_active.end(); ++it)
+        it.value().job->token().cancel();
+    m_pool.waitForDone();
+}
+
+int JobScheduler::submit(Job* job, const QList<int>& dependencies) {
+    Entry entry;
+    entry.job = QSharedPointer<Job>(job);
+    entry.submitted = m_clock.elapsed();
+    entry.started = -1;
+    entry.info.id = m_nextId++;
+    entry.info.name = job->name();
+    entry.info.document = job->document();
+    entry.info.priority = job->priority();
+
+    bool failed = false;
+    for (int i = 0; i < dependencies.size(); ++i) {
+        int dependency = dependencies.at(i);
+        if (m_active.contains(dependency))
+            entry.waitingFor.append(dependency);
+        else if (m_ended.value(dependency, Finished) != Finished)
+            failed = true;
+    }
+    entry.info.state = entry.waitingFor.isEmpty() ? Queued : Waiting;
+    int id = entry.info.id;
+    m_active.insert(id, entry);
+    emit jobChanged(snapshot(entry));
+
+    if (failed)
+        end(id, Cancelled, tr("Required job did not finish."));
+    else
+        dispatch();
+    return id;
+}
+
+void JobScheduler::cancel(int id) {
+    if (!m_active.contains(id))
+        return;
+    Entry& entry = m_active[id];
+    entry.job->token().cancel();
+    if (entry.info.state != Running)
+        end(id, Cancelled, QString());
+}
+
+/*
+ * Start best ready jobs while there are free workers
+ */
+void JobScheduler::dispatch() {
+    forever {
+        if (m_busy.size() >= m_pool.maxThreadCount())
+            return;
+        int best = -1;
+        int bestPriority = -1;
+        QHash<QString, bool> seen;  // older job of document goes first
+        QMap<int, Entry>::const_iterator it;
+        for (it = m_active.constBegin(); it != m_active.constEnd(); ++it) {
+            const Entry& entry = it.value();
+            const QString& document = entry.info.document;
+            bool first = document.isEmpty() || !seen.contains(document);
+            if (!document.isEmpty())
+                seen.insert(document, true);
+            if (entry.info.state != Queued || !first)
+                continue;
+            if (!document.isEmpty() && m_busy.contains(document))
+                continue;
+            if (entry.info.priority == Bulk &&
+                    m_runningBulk >= m_pool.maxThreadCount() - 1)
+                continue;
+            if (entry.info.priority > bestPriority) {
+                best = it.key();
+                bestPriority = entry.info.priority;
+            }
+        }
+        if (best < 0)
+            return;
+
+        Entry& entry = m_active[best];
+        entry.info.state = Running;
+        entry.started = m_clock.elapsed();
+        // jobs without document are counted under their own key
+        m_busy.insert(entry.info.document.isEmpty()
+                      ? QString("#%1").arg(best) : entry.info.document,
+                      best);
+        if (entry.info.priority == Bulk)
+            ++m_runningBulk;
+        emit jobChanged(snapshot(entry));
+        m_pool.start(new JobRunner(this, best, entry.job),
+                     entry.info.priority);
+    }
+}
+
+void JobScheduler::runnerFinished(int id, bool ok, const QString& error) {
+    if (!m_active.contains(id))
+        return;
+    const Entry& entry = m_active[id];
+    m_busy.remove(entry.info.document.isEmpty()
+                  ? QString("#%1").arg(id) : entry.info.document);
+    if (entry.info.priority == Bulk)
+        --m_runningBulk;
+    State state = entry.job->isCancelled() ? Cancelled
+                                           : (ok ? Finished : Failed);
+    end(id, state, error);
+}
+
+void JobScheduler::end(int id, State state, const QString& error) {
+    Entry entry = m_active.take(id);
+    entry.info.state = state;
+    entry.info.error = error;
+    Info info = snapshot(entry);
+    if (entry.started >= 0)
+        Instrumentation::record(info.name, info.document, -1, info.runMs,
+                                stateName(state),
+                                tr("queued %1 ms").arg(info.queuedMs));
+    entry.job->finish(state, error);
+
+    m_ended.insert(id, state);
+    m_history.append(info);
+    while (m_history.size() > kHistorySize)
+        m_ended.remove(m_history.takeFirst().id);
+    emit jobChanged(info);
+
+    // dependents go on or are cancelled too
+    QList<int> cancelled;
+    QMap<int, Entry>::iterator it;
+    for (it = m_active.begin(); it != m_active.end(); ++it) {
+        Entry& other = it.value();
+        if (!other.waitingFor.removeAll(id))
+            continue;
+        if (state != Finished) {
+            cancelled.append(it.key());
+        } else if (other.waitingFor.isEmpty()) {
+            other.info.state = Queued;
+            emit jobChanged(snapshot(other));
+        }
+    }
+    for (int i = 0; i < cancelled.size(); ++i)
+        if (m_active.contains(cancelled.at(i)))
+            end(cancelled.at(i), Cancelled,
+                tr("Required job did not finish."));
+    dispatch();
+}
+
+JobScheduler::Info JobScheduler::snapshot(const Entry& entry) const {
+    Info info = entry.info;
+    qint64 now = m_clock.elapsed();
+    if (entry.started < 0) {
+        info.queuedMs = now - entry.submitted;
+        info.runMs = 0;
+    } else {
+        info.queuedMs = entry.started - entry.submitted;
+        info.runMs = now - entry.started;
+    }
+    return info;
+}
+
+QList<JobScheduler::Info> JobScheduler::jobs() const {
+    QList<Info> jobs = m_history;
+    QMap<int, Entry>::const_iterator it;
+    for (it = m_active.constBegin(); it != m_active.constEnd(); ++it)
+        jobs.append(snapshot(it.value()));
+    return jobs;
+}
+
+JobScheduler::Info JobScheduler::info(int id) const {
+    if (m_active.contains(id))
+        return snapshot(m_active[id]);
+    for (int i = m_history.size() - 1; i >= 0; --i)
+        if (m_history.at(i).id == id)
+            return m_history.at(i);
+    return Info();
+}
+
+QString JobScheduler::stateName(State state) {
+    switch (state) {
+    case Waiting:
+        return tr("waiting");
+    case Queued:
+        return tr("queued");
+    case Running:
+        return tr("running");
+    case Finished:
+        return tr("finished");
+    case Failed:
+        return tr("failed");
+    case Cancelled:
+        return tr("cancelled");
+    }
+    return QString();
+}
+
+QString JobScheduler::priorityName(Priority priority) {
+    switch (priority) {
+    case Bulk:
+        return tr("bulk");
+    case Normal:
+        return tr("normal");
+    case Interactive:
+        return tr("interactive");
+    }
+    return QString();
+}
@@ -0,0 +1,172 @@
+/**********************************************************************
+* File:        JobScheduler.h
+* Description: Prioritized background jobs with cancellation and metrics
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_JOBSCHEDULER_H_
+#define SRC_JOBSCHEDULER_H_
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include "CancelToken.h"
+
+/**
+ * Central pool for heavy operations, so GUI thread only prepares data and
+ * applies results.
+ * Ready jobs are started by priority (then in order of submission);
+ * bulk jobs never take the last worker, so interactive jobs do not wait
+ * behind long exports. Jobs of one document run one after another in
+ * order of submission. A job may wait for other jobs; it is cancelled if
+ * any of them fails or is cancelled. Queue and run time of every job is
+ * written to Instrumentation log and shown in jobs panel.
+ * Scheduler is used from GUI thread only; Job::run() is called on worker.
+ */
+class JobScheduler : public QObject {
+    Q_OBJECT
+
+  public:
+    enum Priority {
+        Bulk = 0,         /**< exports, prefetch */
+        Normal = 1,
+        Interactive = 2   /**< user waits for result */
+    };
+
+    enum State {
+        Waiting = 0,  /**< for other jobs */
+        Queued,
+        Running,
+        Finished,
+        Failed,
+        Cancelled
+    };
+
+    class Job {
+      public:
+        /** document: jobs with same non-empty document are serialized. */
+        Job(const QString& name, const QString& document,
+            Priority priority);
+        virtual ~Job();
+
+        /** Do the work on worker thread; check isCancelled() regularly.
+         *  Returns false and error on failure.
+         */
+        virtual bool run(QString* error) = 0;
+        /** Called in GUI thread when job ended (also when it was
+         *  cancelled before start).
+         */
+        virtual void finish(State state, const QString& error);
+
+        QString name() const {
+            return m_name;
+        }
+        QString document() const {
+            return m_document;
+        }
+        Priority priority() const {
+            return m_priority;
+        }
+        bool isCancelled() const {
+            return m_token.isCancelled();
+        }
+        CancelToken token() const {
+            return m_token;
+        }
+
+      private:
+        QString m_name;
+        QString m_document;
+        Priority m_priority;
+        CancelToken m_token;
+    };
+
+    /** Snapshot of job for display. */
+    struct Info {
+        Info();
+
+        int id;
+        QString name;
+        QString document;
+        Priority priority;
+        State state;
+        qint64 queuedMs;  /**< from submission to start (or now) */
+        qint64 runMs;     /**< from start to end (or now) */
+        QString error;
+    };
+
+    static JobScheduler* instance();
+    ~JobScheduler();
+
+    /** Schedule job (scheduler takes ownership) after dependencies
+     *  finish. Returns id of job.
+     */
+    int submit(Job* job, const QList<int>& dependencies = QList<int>());
+    /** Cancel job; waiting job ends at once, running job is asked to
+     *  stop.
+     */
+    void cancel(int id);
+    /** Jobs waiting, queued or running. */
+    int activeCount() const {
+        return m_active.size();
+    }
+    /** Active jobs and recently ended ones (oldest first). */
+    QList<Info> jobs() const;
+    Info info(int id) const;
+
+    static QString stateName(State state);
+    static QString priorityName(Priority priority);
+
+  signals:
+    void jobChanged(const JobScheduler::Info& info);
+
+  private slots:
+    void runnerFinished(int id, bool ok, const QString& error);
+
+  private:
+    struct Entry {
+        QSharedPointer<Job> job;
+        Info info;
+        QList<int> waitingFor;
+        qint64 submitted;
+        qint64 started;
+    };
+
+    explicit JobScheduler(QObject* parent = 0);
+    void dispatch();
+    void end(int id, State state, const QString& error);
+    Info snapshot(const Entry& entry) const;
+
+    QThreadPool m_pool;
+    QElapsedTimer m_clock;
+    int m_nextId;
+    int m_runningBulk;
+    QMap<int, Entry> m_active;      /**< id order is submission order */
+    QHash<QString, int> m_busy;     /**< document -> running job */
+    QList<Info> m_history;          /**< recently ended jobs */
+    QHash<int, State> m_ended;      /**< state of ended jobs by id */
+};
+
+#endif  // SRC_JOBSCHEDULER_H_
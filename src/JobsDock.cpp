@@ -0,0 +1,160 @@
+/**********************************************************************
+* File:        JobsDock.cpp
+* Description: Dock with background jobs and their timing
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "JobsDock.h"
+
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace {
+
+// Item data roles with job id and state
+const int kIdRole = Qt::UserRole;
+const int kStateRole = Qt::UserRole + 1;
+// Rows kept in panel
+const int kMaxItems = 200;
+// Refresh of times of active jobs
+const int kRefreshInterval = 500;
+
+bool isActive(const QTreeWidgetItem* item) {
+    int state = item->data(0, kStateRole).toInt();
+    return state == JobScheduler::Waiting || state == JobScheduler::Queued ||
+            state == JobScheduler::Running;
+}
+
+}  // namespace
+
+JobsDock::JobsDock(QWidget* parent)
+    : QDockWidget(tr("Jobs"), parent) {
+    setObjectName("jobsDock");
+    QWidget* widget = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    tree = new QTreeWidget(widget);
+    tree->setRootIsDecorated(false);
+    tree->setUniformRowHeights(true);
+    tree->setAlternatingRowColors(true);
+    tree->setHeaderLabels(QStringList() << tr("Job") << tr("Document")
+                          << tr("Priority") << tr("State")
+                          << tr("Queued (ms)") << tr("Run (ms)"));
+    layout->addWidget(tree);
+
+    QHBoxLayout* buttons = new QHBoxLayout;
+    buttons->addStretch();
+    cancelButton = new QPushButton(tr("&Cancel job"), widget);
+    cancelButton->setEnabled(false);
+    buttons->addWidget(cancelButton);
+    layout->addLayout(buttons);
+    setWidget(widget);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(kRefreshInterval);
+    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    connect(cancelButton, SIGNAL(clicked()), this, SLOT(cancelSelected()));
+    connect(tree, SIGNAL(itemSelectionChanged()), this,
+            SLOT(updateCancelButton()));
+
+    JobScheduler* scheduler = JobScheduler::instance();
+    connect(scheduler, SIGNAL(jobChanged(JobScheduler::Info)), this,
+            SLOT(jobChanged(JobScheduler::Info)));
+    QList<JobScheduler::Info> jobs = scheduler->jobs();
+    for (int i = 0; i < jobs.size(); ++i)
+        jobChanged(jobs.at(i));
+}
+
+void JobsDock::showEvent(QShowEvent* event) {
+    refresh();
+    refreshTimer->start();
+    QDockWidget::showEvent(event);
+}
+
+void JobsDock::hideEvent(QHideEvent* event) {
+    refreshTimer->stop();
+    QDockWidget::hideEvent(event);
+}
+
+void JobsDock::jobChanged(const JobScheduler::Info& info) {
+    QTreeWidgetItem* item = items.value(info.id);
+    if (!item) {
+        item = new QTreeWidgetItem(tree);
+        item->setData(0, kIdRole, info.id);
+        items.insert(info.id, item);
+        // drop oldest ended jobs
+        for (int i = 0; i < tree->topLevelItemCount() &&
+             tree->topLevelItemCount() > kMaxItems; ) {
+            QTreeWidgetItem* old = tree->topLevelItem(i);
+            if (isActive(old)) {
+                ++i;
+                continue;
+            }
+            items.remove(old->data(0, kIdRole).toInt());
+            delete old;
+        }
+    }
+    setItem(item, info);
+    updateCancelButton();
+}
+
+void JobsDock::setItem(QTreeWidgetItem* item,
+                       const JobScheduler::Info& info) {
+    item->setData(0, kStateRole, info.state);
+    item->setText(0, info.name);
+    item->setText(1, QFileInfo(info.document).fileName());
+    item->setToolTip(1, info.document);
+    item->setText(2, JobScheduler::priorityName(info.priority));
+    item->setText(3, JobScheduler::stateName(info.state));
+    item->setToolTip(3, info.error);
+    item->setText(4, QString::number(info.queuedMs));
+    item->setText(5, info.state == JobScheduler::Waiting ||
+                  info.state == JobScheduler::Queued
+                  ? QString() : QString::number(info.runMs));
+}
+
+void JobsDock::refresh() {
+    JobScheduler* scheduler = JobScheduler::instance();
+    QHash<int, QTreeWidgetItem*>::const_iterator it;
+    for (it = items.constBegin(); it != items.constEnd(); ++it) {
+        if (isActive(it.value()))
+            setItem(it.value(), scheduler->info(it.key()));
+    }
+}
+
+void JobsDock::cancelSelected() {
+    QList<QTreeWidgetItem*> selected = tree->selectedItems();
+    for (int i = 0; i < selected.size(); ++i)
+        JobScheduler::instance()->cancel(
+                    selected.at(i)->data(0, kIdRole).toInt());
+}
+
+void JobsDock::updateCancelButton() {
+    bool active = false;
+    QList<QTreeWidgetItem*> selected = tree->selectedItems();
+    for (int i = 0; i < selected.size() && !active; ++i)
+        active = isActive(selected.at(i));
+    cancelButton->setEnabled(active);
+}
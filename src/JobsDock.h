@@ -0,0 +1,65 @@
+/**********************************************************************
+* File:        JobsDock.h
+* Description: Dock with background jobs and their timing
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_JOBSDOCK_H_
+#define SRC_JOBSDOCK_H_
+
+#include <QDockWidget>
+#include <QHash>
+
+#include "JobScheduler.h"
+
+class QPushButton;
+class QTimer;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+ * Jobs of JobScheduler with state, queue time and run time. Times of
+ * active jobs are refreshed while the dock is visible.
+ */
+class JobsDock : public QDockWidget {
+    Q_OBJECT
+
+  public:
+    explicit JobsDock(QWidget* parent = 0);
+
+  protected:
+    void showEvent(QShowEvent* event);
+    void hideEvent(QHideEvent* event);
+
+  private slots:
+    void jobChanged(const JobScheduler::Info& info);
+    void refresh();
+    void cancelSelected();
+    void updateCancelButton();
+
+  private:
+    void setItem(QTreeWidgetItem* item, const JobScheduler::Info& info);
+
+    QTreeWidget* tree;
+    QPushButton* cancelButton;
+    QTimer* refreshTimer;
+    QHash<int, QTreeWidgetItem*> items;  /**< job id -> item */
+};
+
+#endif  // SRC_JOBSDOCK_H_
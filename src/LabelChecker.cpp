@@ -0,0 +1,400 @@
+/**********************************************************************
+* File:        LabelChecker.cpp
+* Description: Detection of mislabeled glyphs by clustering
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "LabelChecker.h"
+#include "PageRunner.h"
+#include "Settings.h"
+
+#include <QObject>
+#include <QSettings>
+#include <QStringList>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif  // __SSE2__
+
+namespace {
+
+// Side of grid the ink of box is scaled to
+const int kGrid = 10;
+// Grid cells followed by relative height and width (padded for SSE)
+const int kFeatureSize = kGrid * kGrid + 4;
+// Weight of box size against normalized shape
+const float kSizeWeight = 1.0f;
+// Glyphs assigned to nearest centroid in one task
+const int kAssignChunk = 4096;
+
+inline float squaredDistance(const float* a, const float* b) {
+#ifdef __SSE2__
+    __m128 sum = _mm_setzero_ps();
+    for (int i = 0; i < kFeatureSize; i += 4) {
+        __m128 d = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        sum = _mm_add_ps(sum, _mm_mul_ps(d, d));
+    }
+    float parts[4];
+    _mm_storeu_ps(parts, sum);
+    return parts[0] + parts[1] + parts[2] + parts[3];
+#else
+    float sum = 0;
+    for (int i = 0; i < kFeatureSize; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+#endif  // __SSE2__
+}
+
+/*
+ * Feature vector of box: ink scaled into centered kGrid x kGrid square
+ * (L2 normalized), then height and width relative to median box height.
+ * Returns false for box without ink.
+ */
+bool boxFeatures(const QImage& mono, uchar black, const QRect& box,
+                 float medianHeight, float* out) {
+    std::fill(out, out + kFeatureSize, 0.0f);
+    QRect rect = box.intersected(mono.rect());
+    if (rect.isEmpty())
+        return false;
+
+    int side = qMax(rect.width(), rect.height());
+    float scale = static_cast<float>(kGrid) / side;
+    float offsetX = (side - rect.width()) * 0.5f * scale;
+    float offsetY = (side - rect.height()) * 0.5f * scale;
+    int ink = 0;
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const uchar* line = mono.constScanLine(y);
+        int gy = qMin(kGrid - 1,
+                      static_cast<int>(offsetY + (y - rect.top()) * scale));
+        float* cells = out + gy * kGrid;
+        for (int x = rect.left(); x <= rect.right(); ++x) {
+            if (((line[x >> 3] >> (7 - (x & 7))) & 1) != black)
+                continue;
+            int gx = qMin(kGrid - 1, static_cast<int>(
+                              offsetX + (x - rect.left()) * scale));
+            cells[gx] += 1.0f;
+            ++ink;
+        }
+    }
+    if (ink == 0)
+        return false;
+
+    float norm = 0;
+    for (int i = 0; i < kGrid * kGrid; ++i)
+        norm += out[i] * out[i];
+    norm = 1.0f / std::sqrt(norm);
+    for (int i = 0; i < kGrid * kGrid; ++i)
+        out[i] *= norm;
+    out[kGrid * kGrid] = kSizeWeight * rect.height() / medianHeight;
+    out[kGrid * kGrid + 1] = kSizeWeight * rect.width() / medianHeight;
+    return true;
+}
+
+struct FeatureTask : PageTask {
+    QVector<int> rows;        /**< rows with features */
+    QVector<float> features;  /**< kFeatureSize floats per row */
+};
+
+class FeatureExtractor {
+  public:
+    void operator()(FeatureTask& task) const {
+        QImage mono = PageImage::toMono(task.image->binarized());
+        uchar black = PageImage::blackIndex(mono);
+        int imageHeight = mono.height();
+
+        QVector<int> heights;
+        for (int i = 0; i < task.glyphs.size(); ++i) {
+            const Glyph& glyph = task.glyphs.at(i);
+            if (glyph.letter.trimmed().isEmpty())
+                continue;
+            heights.append(qMax(1, glyph.top - glyph.bottom));
+        }
+        if (heights.isEmpty())
+            return;
+        std::nth_element(heights.begin(), heights.begin() + heights.size() / 2,
+                         heights.end());
+        float medianHeight = heights.at(heights.size() / 2);
+
+        task.features.resize(heights.size() * kFeatureSize);
+        int count = 0;
+        for (int i = 0; i < task.glyphs.size(); ++i) {
+            const Glyph& glyph = task.glyphs.at(i);
+            if (glyph.letter.trimmed().isEmpty())
+                continue;
+            if (boxFeatures(mono, black, glyph.imageRect(imageHeight),
+                            medianHeight,
+                            task.features.data() + count * kFeatureSize)) {
+                task.rows.append(i);
+                ++count;
+            }
+        }
+        task.features.resize(count * kFeatureSize);
+    }
+};
+
+struct AssignTask {
+    int first;
+    int last;     /**< exclusive */
+    int changed;
+};
+
+/*
+ * Assign range of vectors to nearest centroid
+ */
+class Assigner {
+  public:
+    typedef void result_type;
+
+    Assigner(const QVector<float>& features, const QVector<float>& centroids,
+             QVector<int>* clusters)
+        : m_features(features.constData()),
+          m_centroids(centroids.constData()),
+          m_k(centroids.size() / kFeatureSize),
+          m_clusters(clusters->data()) {
+    }
+
+    void operator()(AssignTask& task) const {
+        task.changed = 0;
+        for (int i = task.first; i < task.last; ++i) {
+            const float* vector = m_features + i * kFeatureSize;
+            int best = 0;
+            float bestDistance = std::numeric_limits<float>::max();
+            for (int c = 0; c < m_k; ++c) {
+                float d = squaredDistance(vector,
+                                          m_centroids + c * kFeatureSize);
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    best = c;
+                }
+            }
+            if (m_clusters[i] != best) {
+                m_clusters[i] = best;
+                ++task.changed;
+            }
+        }
+    }
+
+  private:
+    const float* m_features;
+    const float* m_centroids;
+    int m_k;
+    int* m_clusters;
+};
+
+bool moreSuspicious(const LabelChecker::Suspect& a,
+                    const LabelChecker::Suspect& b) {
+    return a.score > b.score;
+}
+
+}  // namespace
+
+LabelChecker::Options::Options()
+    : minClusterSize(5), minShare(0.6), iterations(8) {
+}
+
+LabelChecker::Options LabelChecker::Options::fromSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    Options options;
+    if (settings.contains("LabelCheck/MinClusterSize"))
+        options.minClusterSize =
+                settings.value("LabelCheck/MinClusterSize").toInt();
+    if (settings.contains("LabelCheck/MinShare"))
+        options.minShare = settings.value("LabelCheck/MinShare").toDouble();
+    if (settings.contains("LabelCheck/Iterations"))
+        options.iterations = settings.value("LabelCheck/Iterations").toInt();
+    options.minClusterSize = qMax(2, options.minClusterSize);
+    options.minShare = qBound(0.5, options.minShare, 1.0);
+    options.iterations = qMax(1, options.iterations);
+    return options;
+}
+
+bool LabelChecker::checkDocument(const QString& imageFile,
+                                 const QVector<GlyphPage>& pages,
+                                 const QHash<int, PageImagePtr>& loaded,
+                                 const Options& options,
+                                 QVector<Suspect>* suspects,
+                                 QString* error,
+                                 const CancelToken& cancel) {
+    suspects->clear();
+
+    // 1. feature vectors of all boxes; few decoded pages at once
+    QVector<float> features;
+    QVector<int> glyphPage;
+    QVector<int> glyphRow;
+    PageRunner<FeatureTask> runner(
+                PageRunner<FeatureTask>::forPages(imageFile, pages, loaded));
+    while (runner.next(FeatureExtractor())) {
+        if (cancel.isCancelled())
+            return false;
+        const QVector<FeatureTask>& tasks = runner.chunk();
+        for (int t = 0; t < tasks.size(); ++t) {
+            const FeatureTask& task = tasks.at(t);
+            if (!task.error.isEmpty()) {
+                *error = task.error;
+                return false;
+            }
+            features += task.features;
+            for (int i = 0; i < task.rows.size(); ++i) {
+                glyphPage.append(task.page);
+                glyphRow.append(task.rows.at(i));
+            }
+        }
+    }
+    const int n = glyphRow.size();
+
+    // 2. letter of each vector; frequent letters seed one centroid each
+    QHash<QString, int> letterIds;
+    QStringList letters;
+    QVector<int> labels(n);
+    for (int i = 0; i < n; ++i) {
+        const QString& letter = pages.at(glyphPage.at(i))
+                .at(glyphRow.at(i)).letter;
+        QHash<QString, int>::const_iterator it = letterIds.constFind(letter);
+        if (it == letterIds.constEnd()) {
+            it = letterIds.insert(letter, letters.size());
+            letters.append(letter);
+        }
+        labels[i] = it.value();
+    }
+    QVector<int> letterCount(letters.size(), 0);
+    for (int i = 0; i < n; ++i)
+        ++letterCount[labels.at(i)];
+    QVector<int> seedOf(letters.size(), -1);  // letter -> its centroid
+    int k = 0;
+    for (int l = 0; l < letters.size(); ++l)
+        if (letterCount.at(l) >= options.minClusterSize)
+            seedOf[l] = k++;
+    if (k < 2)
+        return true;
+
+    QVector<int> clusters(n, -1);
+    for (int i = 0; i < n; ++i)
+        clusters[i] = seedOf.at(labels.at(i));
+
+    // 3. k-means: centroids from assignment, then parallel reassignment
+    QVector<float> centroids(k * kFeatureSize);
+    QVector<int> clusterSize(k);
+    QVector<AssignTask> ranges;
+    for (int first = 0; first < n; first += kAssignChunk) {
+        AssignTask task;
+        task.first = first;
+        task.last = qMin(n, first + kAssignChunk);
+        task.changed = 0;
+        ranges.append(task);
+    }
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        if (cancel.isCancelled())
+            return false;
+        QVector<float> sums(k * kFeatureSize, 0.0f);
+        clusterSize.fill(0);
+        for (int i = 0; i < n; ++i) {
+            int c = clusters.at(i);
+            if (c < 0)
+                continue;
+            const float* vector = features.constData() + i * kFeatureSize;
+            float* sum = sums.data() + c * kFeatureSize;
+            for (int d = 0; d < kFeatureSize; ++d)
+                sum[d] += vector[d];
+            ++clusterSize[c];
+        }
+        for (int c = 0; c < k; ++c) {
+            // empty cluster keeps its previous centroid
+            if (clusterSize.at(c) == 0)
+                continue;
+            float inv = 1.0f / clusterSize.at(c);
+            for (int d = 0; d < kFeatureSize; ++d)
+                centroids[c * kFeatureSize + d] =
+                        sums.at(c * kFeatureSize + d) * inv;
+        }
+
+        QtConcurrent::blockingMap(ranges,
+                                  Assigner(features, centroids, &clusters));
+        int changed = 0;
+        for (int r = 0; r < ranges.size(); ++r)
+            changed += ranges.at(r).changed;
+        if (changed == 0)
+            break;
+    }
+
+    // 4. majority letter of clusters
+    QVector<QHash<int, int> > votes(k);
+    clusterSize.fill(0);
+    for (int i = 0; i < n; ++i) {
+        ++votes[clusters.at(i)][labels.at(i)];
+        ++clusterSize[clusters.at(i)];
+    }
+    QVector<int> majority(k, -1);
+    QVector<int> majorityCount(k, 0);
+    for (int c = 0; c < k; ++c) {
+        QHash<int, int>::const_iterator it;
+        for (it = votes.at(c).constBegin(); it != votes.at(c).constEnd();
+             ++it) {
+            if (it.value() > majorityCount.at(c)) {
+                majorityCount[c] = it.value();
+                majority[c] = it.key();
+            }
+        }
+    }
+
+    // 5. glyphs outvoted by their cluster
+    for (int i = 0; i < n; ++i) {
+        int c = clusters.at(i);
+        int label = labels.at(i);
+        if (majority.at(c) == label || clusterSize.at(c) <
+                options.minClusterSize)
+            continue;
+        double share = static_cast<double>(majorityCount.at(c)) /
+                clusterSize.at(c);
+        if (share < options.minShare)
+            continue;
+
+        // closer to other letter than to own letter means more suspicious
+        const float* vector = features.constData() + i * kFeatureSize;
+        double distance = std::sqrt(squaredDistance(
+                                        vector, centroids.constData() +
+                                        c * kFeatureSize));
+        double margin = 1.0;
+        if (seedOf.at(label) >= 0) {
+            double own = std::sqrt(squaredDistance(
+                                       vector, centroids.constData() +
+                                       seedOf.at(label) * kFeatureSize));
+            margin = own > 0 ? 1.0 - distance / own : 0.0;
+        }
+
+        Suspect suspect;
+        suspect.page = glyphPage.at(i);
+        suspect.row = glyphRow.at(i);
+        suspect.glyph = pages.at(suspect.page).at(suspect.row);
+        suspect.expected = letters.at(majority.at(c));
+        suspect.share = share;
+        suspect.clusterSize = clusterSize.at(c);
+        suspect.score = share * (0.5 + 0.5 * margin);
+        suspects->append(suspect);
+    }
+    std::sort(suspects->begin(), suspects->end(), moreSuspicious);
+    return true;
+}
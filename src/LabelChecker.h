@@ -0,0 +1,78 @@
+/**********************************************************************
+* File:        LabelChecker.h
+* Description: Detection of mislabeled glyphs by clustering
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_LABELCHECKER_H_
+#define SRC_LABELCHECKER_H_
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "CancelToken.h"
+#include "Glyph.h"
+#include "PageImage.h"
+
+/**
+ * Finds glyphs whose letter disagrees with visually similar glyphs (e.g.
+ * 'l' boxed as '1').
+ * Ink of each box in binarized page is scaled (keeping aspect ratio) to
+ * small fixed grid and completed with box size relative to page median.
+ * Vectors are clustered by k-means seeded with mean vector of each
+ * letter; assignment runs in parallel with SSE distance kernel. Glyph is
+ * suspicious when it lands in cluster dominated by other letter.
+ */
+class LabelChecker {
+  public:
+    struct Suspect {
+        int page;          /**< index of page in document */
+        int row;           /**< index of box in page */
+        Glyph glyph;
+        QString expected;  /**< majority letter of glyph's cluster */
+        double share;      /**< part of cluster with expected letter */
+        int clusterSize;
+        double score;      /**< 0-1, higher is more suspicious */
+    };
+
+    struct Options {
+        Options();
+        static Options fromSettings();
+
+        int minClusterSize;  /**< smaller letters/clusters are not judged */
+        double minShare;     /**< majority needed to overrule label */
+        int iterations;      /**< maximum k-means iterations */
+    };
+
+    /** Check all pages of document. Pages missing in loaded are decoded
+     *  from imageFile. Suspects are sorted by score (most suspicious
+     *  first). Returns false (and error) if page can not be loaded.
+     *  Cancel is checked between chunks of pages and k-means iterations;
+     *  cancelled check returns false without error.
+     */
+    static bool checkDocument(const QString& imageFile,
+                              const QVector<GlyphPage>& pages,
+                              const QHash<int, PageImagePtr>& loaded,
+                              const Options& options,
+                              QVector<Suspect>* suspects, QString* error,
+                              const CancelToken& cancel = CancelToken());
+};
+
+#endif  // SRC_LABELCHECKER_H_
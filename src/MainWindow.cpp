@@ -24,9 +24,20 @@
 
 #include "MainWindow.h"
 #include "dialogs/ShortCutsDialog.h"
+#include "Instrumentation.h"
+#include "TessTools.h"
 
 MainWindow::MainWindow() {
   tabWidget = new QTabWidget;
+  memoryManager = new DocumentMemoryManager(this);
+  workspaceDock = new WorkspaceDock(this);
+  addDockWidget(Qt::LeftDockWidgetArea, workspaceDock);
+  workspaceDock->hide();
+  connect(workspaceDock, SIGNAL(documentActivated(QString)), this,
+          SLOT(addChild(QString)));
+  jobsDock = new JobsDock(this);
+  addDockWidget(Qt::BottomDockWidgetArea, jobsDock);
+  jobsDock->hide();
 
 #if QT_VERSION >= 0x040500
   tabWidget->setTabsClosable(true);
@@ -35,6 +46,9 @@ MainWindow::MainWindow() {
 
   connect(tabWidget, SIGNAL(tabCloseRequested(int)), this,
           SLOT(handleClose(int)));
+  // restore hibernated document before menus ask it for state
+  connect(tabWidget, SIGNAL(currentChanged(int)), this,
+          SLOT(documentActivated()));
   connect(tabWidget, SIGNAL(currentChanged(int)), this,
           SLOT(updateMenus()));
   connect(tabWidget, SIGNAL(currentChanged(int)), this,
@@ -65,6 +79,17 @@ MainWindow::MainWindow() {
 }
 
 void MainWindow::closeEvent(QCloseEvent* event) {
+  int jobs = JobScheduler::instance()->activeCount();
+  if (jobs > 0 &&
+      QMessageBox::question(this, SETTING_APPLICATION,
+                            tr("%n background job(s) did not finish yet.\n"
+                               "Do you want to cancel them and quit?", "",
+                               jobs),
+                            QMessageBox::Yes | QMessageBox::No)
+      != QMessageBox::Yes) {
+    event->ignore();
+    return;
+  }
   if (closeAllTabs()) {
     writeSettings();
     event->accept();
@@ -96,6 +121,22 @@ void MainWindow::open() {
   addChild(imageFile);
 }
 
+void MainWindow::openWorkspace() {
+  QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                     SETTING_ORGANIZATION, SETTING_APPLICATION);
+  QString root = settings.value("Workspace/Root",
+                                settings.value("last_path")).toString();
+  root = QFileDialog::getExistingDirectory(
+           this, tr("Select workspace directory..."), root);
+  if (root.isEmpty())
+    return;
+
+  settings.setValue("Workspace/Root", root);
+  workspaceDock->openWorkspace(root);
+  workspaceDock->show();
+  workspaceDock->raise();
+}
+
 void MainWindow::addChild(const QString& imageFileName) {
   if (!imageFileName.isEmpty()) {
     QString canonicalImageFileName =
@@ -189,7 +230,7 @@ void MainWindow::splitToFeatureBF() {
   QString fileName = activeChild()->currentBoxFile();
 
   if (activeChild() && activeChild()->splitToFeatureBF(fileName))
-    statusBar()->showMessage(tr("File saved"), 2000);
+    statusBar()->showMessage(tr("Export started"), 2000);
 }
 
 /**
@@ -305,7 +346,28 @@ void MainWindow::exportToFile(int type) {
     return;
 
   if (activeChild() && activeChild()->exportTxt(type, fileName))
-    statusBar()->showMessage(tr("Data exported"), 2000);
+    statusBar()->showMessage(tr("Export started"), 2000);
+}
+
+/**
+ * Export normalized glyph crops of all pages for classifier training,
+ * either to atlas png sheets or to tar archive.
+ */
+void MainWindow::exportTrainingGlyphs() {
+  if (!activeChild())
+    return;
+
+  QString currentFileName = activeChild()->currentBoxFile().replace(
+                              ".box", ".png");
+  QString fileName = QFileDialog::getSaveFileName(this,
+                     tr("Export training glyphs..."),
+                     currentFileName,
+                     tr("Glyph atlas (*.png);;Tar archive (*.tar)"));
+
+  if (fileName.isEmpty())
+    return;
+
+  activeChild()->exportTrainingGlyphs(fileName);
 }
 
 bool MainWindow::closeActiveTab() {
@@ -476,6 +538,30 @@ void MainWindow::goToRow() {
   }
 }
 
+void MainWindow::selectLine() {
+  if (activeChild()) {
+    activeChild()->selectLine();
+  }
+}
+
+void MainWindow::selectWord() {
+  if (activeChild()) {
+    activeChild()->selectWord();
+  }
+}
+
+void MainWindow::nextLine() {
+  if (activeChild()) {
+    activeChild()->nextLine();
+  }
+}
+
+void MainWindow::previousLine() {
+  if (activeChild()) {
+    activeChild()->previousLine();
+  }
+}
+
 void MainWindow::find() {
   if (activeChild()) {
     activeChild()->find();
@@ -508,6 +594,8 @@ void MainWindow::redo() {
 }
 
 void MainWindow::reReadSetting() {
+  TessTools::setupEnvironment();
+  Instrumentation::readSettings();
   for (int i = 0; i < tabWidget->count(); ++i) {
     ChildWidget* child = qobject_cast<ChildWidget*> (tabWidget->widget(i));
     child->readSettings();
@@ -538,7 +626,7 @@ void MainWindow::genBoxFile() {
                     QMessageBox::No)) {
         case QMessageBox::Yes: {
               if (activeChild() && activeChild()->qCreateBoxes(currentFileName))
-                statusBar()->showMessage(tr("Boxfile regenerated"), 2000);
+                statusBar()->showMessage(tr("Regenerating boxfile..."), 2000);
               break;
           }
           case QMessageBox::No:
@@ -548,12 +636,84 @@ void MainWindow::genBoxFile() {
           }
 }
 
+void MainWindow::tightenBoxes() {
+  if (activeChild())
+    activeChild()->tightenAllBoxes();
+}
+
+void MainWindow::sortReadingOrder() {
+  if (activeChild())
+    activeChild()->sortReadingOrder();
+}
+
+void MainWindow::labelSimilarShapes() {
+  if (activeChild())
+    activeChild()->labelSimilarShapes();
+}
+
+void MainWindow::validateBoxes() {
+  if (activeChild())
+    activeChild()->validateBoxes();
+}
+
+void MainWindow::checkLabels() {
+  if (activeChild())
+    activeChild()->checkLabels();
+}
+
 void MainWindow::getBinImage() {
     if (activeChild()) {
       activeChild()->binarizeImage();
     }
 }
 
+void MainWindow::genRectBoxes() {
+  if (activeChild())
+    activeChild()->regenerateBoxesInRectangle();
+}
+
+void MainWindow::recognizeBox() {
+  if (activeChild())
+    activeChild()->recognizeBox();
+}
+
+void MainWindow::setAutoRecognize(bool checked) {
+  QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                     SETTING_ORGANIZATION, SETTING_APPLICATION);
+  settings.setValue("Tesseract/RecognizeAfterEdit", checked);
+  for (int i = 0; i < tabWidget->count(); ++i) {
+    ChildWidget* child = qobject_cast<ChildWidget*> (tabWidget->widget(i));
+    if (child)
+      child->setAutoRecognize(checked);
+  }
+}
+
+void MainWindow::documentActivated() {
+  if (activeChild())
+    memoryManager->activate(activeChild());
+}
+
+void MainWindow::memoryReport() {
+  QList<DocumentMemoryManager::Usage> usage = memoryManager->usage();
+  qint64 total = 0;
+  QString text;
+  for (int i = 0; i < usage.size(); ++i) {
+    const DocumentMemoryManager::Usage& item = usage.at(i);
+    text += tr("%1: %2 MB").arg(item.name)
+            .arg(item.bytes / (1024.0 * 1024.0), 0, 'f', 1);
+    if (item.hibernated)
+      text += tr(" (hibernated)");
+    text += "\n";
+    total += item.bytes;
+  }
+  text += "\n" + tr("Total: %1 MB")
+          .arg(total / (1024.0 * 1024.0), 0, 'f', 1);
+  if (memoryManager->budget() > 0)
+    text += "\n" + tr("Budget: %1 MB")
+            .arg(memoryManager->budget() / (1024 * 1024));
+  QMessageBox::information(this, tr("Memory usage"), text);
+}
+
 void MainWindow::checkForUpdate() {
   statusBar()->showMessage(tr("Checking for new version..."), 2000);
 
@@ -652,6 +812,7 @@ void MainWindow::updateMenus() {
   reLoadAct->setEnabled((activeChild()) != 0);
   reLoadImgAct->setEnabled((activeChild()) != 0);
   genBoxAct->setEnabled((activeChild()) != 0);
+  recognizeBoxAct->setEnabled((activeChild()) != 0);
   getBinAct->setEnabled((activeChild()) != 0);
   splitToFeatureBFAct->setEnabled((activeChild()) != 0);
   importPLSymAct->setEnabled((activeChild()) != 0);
@@ -659,6 +820,13 @@ void MainWindow::updateMenus() {
   symbolPerLineAct->setEnabled((activeChild()) != 0);
   rowPerLineAct->setEnabled((activeChild()) != 0);
   paragraphPerLineAct->setEnabled((activeChild()) != 0);
+  trainingGlyphsAct->setEnabled((activeChild()) != 0);
+  tightenBoxesAct->setEnabled((activeChild()) != 0);
+  sortReadingOrderAct->setEnabled((activeChild()) != 0);
+  labelSimilarAct->setEnabled((activeChild()) != 0);
+  validateAct->setEnabled((activeChild()) != 0);
+  checkLabelsAct->setEnabled((activeChild()) != 0);
+  memoryAct->setEnabled((activeChild()) != 0);
   closeAct->setEnabled(activeChild() != 0);
   closeAllAct->setEnabled(activeChild() != 0);
   nextAct->setEnabled(tabWidget->count() > 1);
@@ -673,6 +841,10 @@ void MainWindow::updateMenus() {
   zoomToSelectionAct->setEnabled(activeChild() != 0);
   showSymbolAct->setEnabled(activeChild() != 0);
   goToRowAct->setEnabled(activeChild() != 0);
+  selectLineAct->setEnabled(activeChild() != 0);
+  selectWordAct->setEnabled(activeChild() != 0);
+  nextLineAct->setEnabled(activeChild() != 0);
+  previousLineAct->setEnabled(activeChild() != 0);
   findAct->setEnabled(activeChild() != 0);
   statsAct->setEnabled(activeChild() != 0);
   undoAct->setEnabled(activeChild() != 0);
@@ -703,6 +875,8 @@ void MainWindow::updateCommandActions() {
                            ? activeChild()->isDrawBoxes() : false);
   drawRectAct->setChecked((activeChild())
                           ? activeChild()->isDrawRect() : false);
+  genRectBoxAct->setEnabled((activeChild())
+                            ? activeChild()->isDrawRect() : false);
   DirectTypingAct->setChecked((activeChild())
                               ? activeChild()->isDirectTypingMode() : false);
   showFontColumnsAct->setChecked((activeChild())
@@ -774,6 +948,11 @@ void MainWindow::updateViewMenu() {
 
   viewMenu->addSeparator();
   viewMenu->addAction(statsAct);
+  viewMenu->addAction(validateAct);
+  viewMenu->addAction(checkLabelsAct);
+  viewMenu->addAction(memoryAct);
+  viewMenu->addAction(workspaceDock->toggleViewAction());
+  viewMenu->addAction(jobsDock->toggleViewAction());
 }
 
 void MainWindow::createActions() {
@@ -784,6 +963,15 @@ void MainWindow::createActions() {
   openAct->setStatusTip(tr("Open an existing file"));
   connect(openAct, SIGNAL(triggered()), this, SLOT(open()));
 
+  openWorkspaceAct = new QAction(tr("Open &workspace..."), this);
+  openWorkspaceAct->setShortcut(tr("Ctrl+Shift+O"));
+  openWorkspaceAct->setToolTip(
+    tr("List and index all documents of directory tree"));
+  openWorkspaceAct->setStatusTip(
+    tr("List and index all documents of directory tree"));
+  connect(openWorkspaceAct, SIGNAL(triggered()), this,
+          SLOT(openWorkspace()));
+
   saveAct = new QAction(QIcon::fromTheme("filesave"),
                         tr("&Save"), this);
   saveAct->setShortcuts(QKeySequence::Save);
@@ -866,6 +1054,15 @@ void MainWindow::createActions() {
   exportMapper->setMapping(paragraphPerLineAct, 3);
   connect(exportMapper, SIGNAL(mapped(int)), this, SLOT(exportToFile(int)));
 
+  trainingGlyphsAct = new QAction(tr("Training glyphs…"), this);
+  trainingGlyphsAct->setToolTip(tr("Export normalized box images of all "
+                                   "pages to atlas or archive."));
+  trainingGlyphsAct->setStatusTip(tr("Export normalized box images of all "
+                                     "pages to atlas or archive."));
+  trainingGlyphsAct->setEnabled(false);
+  connect(trainingGlyphsAct, SIGNAL(triggered()), this,
+          SLOT(exportTrainingGlyphs()));
+
   closeAct = new QAction(QIcon::fromTheme("window-close"),
                          tr("Cl&ose"), this);
   closeAct->setShortcut(QKeySequence::Close);
@@ -1025,6 +1222,27 @@ void MainWindow::createActions() {
   goToRowAct->setShortcut(tr("Ctrl+G"));
   connect(goToRowAct, SIGNAL(triggered()), this, SLOT(goToRow()));
 
+  selectLineAct = new QAction(tr("Select &line"), this);
+  selectLineAct->setShortcut(tr("Ctrl+Alt+L"));
+  selectLineAct->setStatusTip(tr("Select all boxes of current text line"));
+  connect(selectLineAct, SIGNAL(triggered()), this, SLOT(selectLine()));
+
+  selectWordAct = new QAction(tr("Select &word"), this);
+  selectWordAct->setShortcut(tr("Ctrl+Alt+W"));
+  selectWordAct->setStatusTip(tr("Select all boxes of current word"));
+  connect(selectWordAct, SIGNAL(triggered()), this, SLOT(selectWord()));
+
+  nextLineAct = new QAction(tr("Ne&xt line"), this);
+  nextLineAct->setShortcut(tr("Ctrl+Alt+Down"));
+  nextLineAct->setStatusTip(tr("Go to first box of next text line"));
+  connect(nextLineAct, SIGNAL(triggered()), this, SLOT(nextLine()));
+
+  previousLineAct = new QAction(tr("Pre&vious line"), this);
+  previousLineAct->setShortcut(tr("Ctrl+Alt+Up"));
+  previousLineAct->setStatusTip(
+      tr("Go to first box of previous text line"));
+  connect(previousLineAct, SIGNAL(triggered()), this, SLOT(previousLine()));
+
   findAct = new QAction(QIcon::fromTheme("find"),
                         tr("&Find…"), this);
   findAct->setShortcut(tr("Ctrl+F"));
@@ -1035,6 +1253,56 @@ void MainWindow::createActions() {
   statsAct->setShortcut(tr("Ctrl+I"));
   connect(statsAct, SIGNAL(triggered()), this, SLOT(stats()));
 
+  tightenBoxesAct = new QAction(tr("Tighten all boxes"), this);
+  tightenBoxesAct->setToolTip(tr("Snap boxes of all pages to ink they "
+                                 "contain"));
+  tightenBoxesAct->setStatusTip(tr("Snap boxes of all pages to ink they "
+                                   "contain"));
+  tightenBoxesAct->setEnabled(false);
+  connect(tightenBoxesAct, SIGNAL(triggered()), this, SLOT(tightenBoxes()));
+
+  sortReadingOrderAct = new QAction(tr("Sort page into reading order"),
+                                    this);
+  sortReadingOrderAct->setToolTip(tr("Order boxes of page by columns, text "
+                                     "lines from top and boxes in writing "
+                                     "direction"));
+  sortReadingOrderAct->setStatusTip(tr("Order boxes of page by columns, "
+                                       "text lines from top and boxes in "
+                                       "writing direction"));
+  sortReadingOrderAct->setEnabled(false);
+  connect(sortReadingOrderAct, SIGNAL(triggered()), this,
+          SLOT(sortReadingOrder()));
+
+  labelSimilarAct = new QAction(tr("Label similar shapes"), this);
+  labelSimilarAct->setShortcut(tr("Ctrl+Shift+L"));
+  labelSimilarAct->setToolTip(tr("Give letter of relabeled box to all boxes "
+                                 "with the same shape"));
+  labelSimilarAct->setStatusTip(tr("Give letter of relabeled box to all "
+                                   "boxes with the same shape"));
+  labelSimilarAct->setEnabled(false);
+  connect(labelSimilarAct, SIGNAL(triggered()), this,
+          SLOT(labelSimilarShapes()));
+
+  validateAct = new QAction(tr("&Validate boxes…"), this);
+  validateAct->setToolTip(tr("Check boxes of all pages against image"));
+  validateAct->setStatusTip(tr("Check boxes of all pages against image"));
+  validateAct->setEnabled(false);
+  connect(validateAct, SIGNAL(triggered()), this, SLOT(validateBoxes()));
+
+  checkLabelsAct = new QAction(tr("Find suspicious &labels…"), this);
+  checkLabelsAct->setToolTip(tr("List boxes labeled differently from "
+                                "similar looking boxes"));
+  checkLabelsAct->setStatusTip(tr("List boxes labeled differently from "
+                                  "similar looking boxes"));
+  checkLabelsAct->setEnabled(false);
+  connect(checkLabelsAct, SIGNAL(triggered()), this, SLOT(checkLabels()));
+
+  memoryAct = new QAction(tr("&Memory usage…"), this);
+  memoryAct->setToolTip(tr("Show memory used by open documents"));
+  memoryAct->setStatusTip(tr("Show memory used by open documents"));
+  memoryAct->setEnabled(false);
+  connect(memoryAct, SIGNAL(triggered()), this, SLOT(memoryReport()));
+
   drawRectAct = new QAction(QIcon::fromTheme("rectangle"),
                             tr("Draw/Hide &Rectangle…"), this);
   drawRectAct->setCheckable(true);
@@ -1064,7 +1332,36 @@ void MainWindow::createActions() {
   genBoxAct->setStatusTip(tr("Re-generate boxes for current page."));
   connect(genBoxAct, SIGNAL(triggered()), this, SLOT(genBoxFile()));
 
-  getBinAct = new QAction(tr("Convert to binary"), this);
+  genRectBoxAct = new QAction(tr("Generate boxes in rectangle"), this);
+  genRectBoxAct->setShortcut(tr("Ctrl+Shift+G"));
+  genRectBoxAct->setToolTip(tr("Re-generate boxes inside drawn rectangle."));
+  genRectBoxAct->setStatusTip(tr("Re-generate boxes inside drawn "
+                                 "rectangle."));
+  genRectBoxAct->setEnabled(false);
+  connect(genRectBoxAct, SIGNAL(triggered()), this, SLOT(genRectBoxes()));
+
+  recognizeBoxAct = new QAction(tr("Recognize box"), this);
+  recognizeBoxAct->setShortcut(tr("Ctrl+Shift+R"));
+  recognizeBoxAct->setToolTip(tr("Show tesseract choices for current box."));
+  recognizeBoxAct->setStatusTip(tr("Show tesseract choices for current box."));
+  connect(recognizeBoxAct, SIGNAL(triggered()), this, SLOT(recognizeBox()));
+
+  autoRecognizeAct = new QAction(tr("Recognize box after edit"), this);
+  autoRecognizeAct->setCheckable(true);
+  autoRecognizeAct->setToolTip(tr("Show tesseract choices whenever box is "
+                                  "resized."));
+  autoRecognizeAct->setStatusTip(tr("Show tesseract choices whenever box is "
+                                    "resized."));
+  {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    autoRecognizeAct->setChecked(
+      settings.value("Tesseract/RecognizeAfterEdit").toBool());
+  }
+  connect(autoRecognizeAct, SIGNAL(toggled(bool)), this,
+          SLOT(setAutoRecognize(bool)));
+
+  getBinAct = new QAction(tr("Convert to binary..."), this);
   getBinAct->setToolTip(tr("Convert current image page to binary - used for " \
                            "tesseract-ocr training."));
   getBinAct->setStatusTip(tr("Convert current image page to binary - used for " \
@@ -1100,6 +1397,7 @@ void MainWindow::createMenus() {
 
   fileMenu = menuBar()->addMenu(tr("&File"));
   fileMenu->addAction(openAct);
+  fileMenu->addAction(openWorkspaceAct);
   fileMenu->addAction(saveAct);
   fileMenu->addAction(saveAsAct);
   fileMenu->addAction(reLoadAct);
@@ -1113,6 +1411,8 @@ void MainWindow::createMenus() {
   exportMenu->addAction(symbolPerLineAct);
   exportMenu->addAction(rowPerLineAct);
   exportMenu->addAction(paragraphPerLineAct);
+  exportMenu->addSeparator();
+  exportMenu->addAction(trainingGlyphsAct);
   fileMenu->addSeparator();
   fileMenu->addAction(closeAct);
   fileMenu->addAction(closeAllAct);
@@ -1135,11 +1435,18 @@ void MainWindow::createMenus() {
   editMenu->addAction(joinAct);
   editMenu->addAction(splitAct);
   editMenu->addAction(deleteAct);
+  editMenu->addAction(tightenBoxesAct);
+  editMenu->addAction(sortReadingOrderAct);
+  editMenu->addAction(labelSimilarAct);
   editMenu->addSeparator();
   editMenu->addAction(moveUpAct);
   editMenu->addAction(moveDownAct);
   editMenu->addAction(moveToAct);
   editMenu->addAction(goToRowAct);
+  editMenu->addAction(selectLineAct);
+  editMenu->addAction(selectWordAct);
+  editMenu->addAction(nextLineAct);
+  editMenu->addAction(previousLineAct);
   editMenu->addAction(findAct);
   editMenu->addSeparator();
   editMenu->addAction(DirectTypingAct);
@@ -1153,6 +1460,9 @@ void MainWindow::createMenus() {
 
   tessMenu = menuBar()->addMenu(tr("&Tesseract"));
   tessMenu->addAction(genBoxAct);
+  tessMenu->addAction(genRectBoxAct);
+  tessMenu->addAction(recognizeBoxAct);
+  tessMenu->addAction(autoRecognizeAct);
   tessMenu->addAction(getBinAct);
 
   menuBar()->addSeparator();
@@ -1232,6 +1542,8 @@ void MainWindow::createStatusBar() {
 void MainWindow::readSettings(bool init) {
   QSettings settings(QSettings::IniFormat, QSettings::UserScope,
                      SETTING_ORGANIZATION, SETTING_APPLICATION);
+  // workers initialize tesseract, but only GUI thread sets its environment
+  TessTools::setupEnvironment();
 
   // run this section only durin initializaiton time
   if (init) {
@@ -1239,9 +1551,14 @@ void MainWindow::readSettings(bool init) {
     restoreGeometry(settings.value("geometry").toByteArray());
     restoreState(settings.value("state").toByteArray());
     settings.endGroup();
+    // index of last workspace is shown at once and refreshed in background
+    QString root = settings.value("Workspace/Root").toString();
+    if (!root.isEmpty() && QDir(root).exists())
+      workspaceDock->openWorkspace(root);
   }
   if (settings.contains("Text/OpenDialog"))
     openSettings = settings.value("Text/OpenDialog").toBool();
+  memoryManager->setBudget(DocumentMemoryManager::budgetFromSettings());
 }
 
 void MainWindow::writeSettings() {
@@ -50,8 +50,11 @@
 
 
 #include "ChildWidget.h"
+#include "DocumentMemoryManager.h"
 #include "Settings.h"
 #include "SettingsDialog.h"
+#include "WorkspaceDock.h"
+#include "JobsDock.h"
 
 class ChildWidget;
 class QAction;
@@ -67,10 +70,10 @@ class MainWindow : public QMainWindow {
   public:
     MainWindow();
 
-    void addChild(const QString& imageFileName);
     SettingsDialog* runSettingsDialog;
 
   public slots:
+    void addChild(const QString& imageFileName);
     void checkForUpdate();
     void requestFinished(QNetworkReply* reply);
 
@@ -81,6 +84,7 @@ class MainWindow : public QMainWindow {
 
   private slots:
     void open();
+    void openWorkspace();
     void openRecentFile();
     void save();
     void splitToFeatureBF();
@@ -92,6 +96,17 @@ class MainWindow : public QMainWindow {
     void importPLSym();
     void importTextSym();
     void exportToFile(int type);
+    void exportTrainingGlyphs();
+    void tightenBoxes();
+    void sortReadingOrder();
+    void labelSimilarShapes();
+    void validateBoxes();
+    void checkLabels();
+    void memoryReport();
+    void recognizeBox();
+    void genRectBoxes();
+    void setAutoRecognize(bool checked);
+    void documentActivated();
     bool closeActiveTab();
     bool closeAllTabs();
     void nextTab();
@@ -118,6 +133,10 @@ class MainWindow : public QMainWindow {
     void moveDown();
     void moveTo();
     void goToRow();
+    void selectLine();
+    void selectWord();
+    void nextLine();
+    void previousLine();
     void find();
     void stats();
     void drawRect(bool checked);
@@ -140,6 +159,9 @@ class MainWindow : public QMainWindow {
 
   private:
     ShortCutsDialog* shortCutsDialog;
+    DocumentMemoryManager* memoryManager;
+    WorkspaceDock* workspaceDock;
+    JobsDock* jobsDock;
     ChildWidget* activeChild();
     void createActions();
     void createMenus();
@@ -171,6 +193,7 @@ class MainWindow : public QMainWindow {
     QToolBar* viewToolBar;
 
     QAction* openAct;
+    QAction* openWorkspaceAct;
     QAction* saveAct;
     QAction* splitToFeatureBFAct;
     QAction* saveAsAct;
@@ -181,6 +204,7 @@ class MainWindow : public QMainWindow {
     QAction* symbolPerLineAct;
     QAction* rowPerLineAct;
     QAction* paragraphPerLineAct;
+    QAction* trainingGlyphsAct;
     QAction* closeAct;
     QAction* closeAllAct;
     QAction* fSeparatorAct;
@@ -211,16 +235,29 @@ class MainWindow : public QMainWindow {
     QAction* insertAct;
     QAction* joinAct;
     QAction* deleteAct;
+    QAction* tightenBoxesAct;
+    QAction* sortReadingOrderAct;
+    QAction* labelSimilarAct;
+    QAction* validateAct;
+    QAction* checkLabelsAct;
+    QAction* memoryAct;
     QAction* moveUpAct;
     QAction* moveToAct;
     QAction* moveDownAct;
     QAction* goToRowAct;
+    QAction* selectLineAct;
+    QAction* selectWordAct;
+    QAction* nextLineAct;
+    QAction* previousLineAct;
     QAction* findAct;
     QAction* statsAct;
     QAction* drawRectAct;
     QAction* undoAct;
     QAction* redoAct;
     QAction* genBoxAct;
+    QAction* genRectBoxAct;
+    QAction* recognizeBoxAct;
+    QAction* autoRecognizeAct;
     QAction* getBinAct;
     QAction* checkForUpdateAct;
     QAction* shortCutListAct;
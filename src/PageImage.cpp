@@ -0,0 +1,184 @@
+/**********************************************************************
+* File:        PageImage.cpp
+* Description: Shared decoded image of one document page
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include <leptonica/allheaders.h>
+
+#include "PageImage.h"
+#include "Binarizer.h"
+#include "TessTools.h"
+
+#include <QMutexLocker>
+#include <QVector>
+
+PageImage::PageImage(const QString& fileName, int page, const QImage& image)
+    : m_fileName(fileName), m_page(page), m_image(image) {
+}
+
+/*
+ * Convert any image to 8 bit indexed image with gray color table
+ */
+QImage PageImage::toGrayscale(const QImage& source) {
+    if (source.format() == QImage::Format_Indexed8 &&
+            source.colorCount() == 256) {
+        bool identity = true;
+        for (int i = 0; i < 256 && identity; ++i)
+            identity = (source.color(i) == qRgb(i, i, i));
+        if (identity)
+            return source;
+    }
+
+    QImage rgb = source.convertToFormat(QImage::Format_RGB32);
+    QImage gray(rgb.width(), rgb.height(), QImage::Format_Indexed8);
+    QVector<QRgb> grayTable(256);
+    for (int i = 0; i < 256; ++i)
+        grayTable[i] = qRgb(i, i, i);
+    gray.setColorTable(grayTable);
+
+    for (int y = 0; y < rgb.height(); ++y) {
+        const QRgb* src = reinterpret_cast<const QRgb*>(rgb.constScanLine(y));
+        uchar* dst = gray.scanLine(y);
+        for (int x = 0; x < rgb.width(); ++x)
+            dst[x] = qGray(src[x]);
+    }
+    gray.setDotsPerMeterX(source.dotsPerMeterX());
+    gray.setDotsPerMeterY(source.dotsPerMeterY());
+    return gray;
+}
+
+QImage PageImage::toMono(const QImage& bilevel) {
+    if (bilevel.format() == QImage::Format_Mono)
+        return bilevel;
+    return bilevel.convertToFormat(QImage::Format_Mono, Qt::ThresholdDither);
+}
+
+uchar PageImage::blackIndex(const QImage& mono) {
+    return (mono.colorCount() >= 2 &&
+            qGray(mono.color(0)) < qGray(mono.color(1))) ? 0 : 1;
+}
+
+bool PageImage::isTiff(const QString& fileName) {
+    QByteArray name = fileName.toLocal8Bit();
+    FILE* fp = lept_fopen(name.constData(), "rb");
+    if (!fp)
+        return false;
+    bool tiff = fileFormatIsTiff(fp);
+    lept_fclose(fp);
+    return tiff;
+}
+
+int PageImage::pageCount(const QString& fileName) {
+    QByteArray name = fileName.toLocal8Bit();
+    FILE* fp = lept_fopen(name.constData(), "rb");
+    if (!fp)
+        return 0;
+    l_int32 nPages = 1;
+    if (fileFormatIsTiff(fp))
+        tiffGetCount(fp, &nPages);
+    lept_fclose(fp);
+    return nPages;
+}
+
+PageImagePtr PageImage::load(const QString& fileName, int page) {
+    QImage image;
+    if (isTiff(fileName)) {
+        QByteArray name = fileName.toLocal8Bit();
+        PIX* pix = pixReadTiff(name.constData(), page);
+        if (pix) {
+            image = TessTools::PIX2qImage(pix);
+            pixDestroy(&pix);
+        }
+    } else if (page == 0) {
+        //  pixReadStream/PIX2qImage was not able to display png image
+        //  So lets use QImage for other format than tiff...
+        image.load(fileName);
+    }
+
+    if (image.isNull())
+        return PageImagePtr();
+    // one packed bit order for display, tesseract and exports
+    if (image.format() == QImage::Format_MonoLSB)
+        image = image.convertToFormat(QImage::Format_Mono);
+    return PageImagePtr(new PageImage(fileName, page, image));
+}
+
+QImage PageImage::image() const {
+    return m_image;
+}
+
+QImage PageImage::grayscale() const {
+    QMutexLocker locker(&m_mutex);
+    if (m_grayscale.isNull())
+        m_grayscale = toGrayscale(m_image);
+    return m_grayscale;
+}
+
+QImage PageImage::binarized() const {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_binarized.isNull())
+            return m_binarized;
+    }
+    // binarizer borrows grayscale(), so do not hold the lock here
+    QImage result = Binarizer::binarize(*this,
+                                        Binarizer::Options::fromSettings());
+    QMutexLocker locker(&m_mutex);
+    if (m_binarized.isNull())
+        m_binarized = result;
+    return m_binarized;
+}
+
+void PageImage::setBinarized(const QImage& image) {
+    QMutexLocker locker(&m_mutex);
+    m_binarized = image;
+    m_components.clear();
+}
+
+ComponentIndexPtr PageImage::components() const {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_components)
+            return m_components;
+    }
+    ComponentIndexPtr result(new ComponentIndex(binarized()));
+    QMutexLocker locker(&m_mutex);
+    if (!m_components)
+        m_components = result;
+    return m_components;
+}
+
+void PageImage::clearDerived() {
+    QMutexLocker locker(&m_mutex);
+    m_grayscale = QImage();
+    m_binarized = QImage();
+    m_components.clear();
+}
+
+qint64 PageImage::memoryUsage() const {
+    QMutexLocker locker(&m_mutex);
+    qint64 bytes = m_image.byteCount() + m_binarized.byteCount();
+    // grayscale image may share pixels with original
+    if (m_grayscale.cacheKey() != m_image.cacheKey())
+        bytes += m_grayscale.byteCount();
+    if (m_components)
+        bytes += m_components->memoryUsage();
+    return bytes;
+}
@@ -0,0 +1,111 @@
+/**********************************************************************
+* File:        PageImage.h
+* Description: Shared decoded image of one document page
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_PAGEIMAGE_H_
+#define SRC_PAGEIMAGE_H_
+
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+#include "ComponentIndex.h"
+
+class PageImage;
+typedef QSharedPointer<PageImage> PageImagePtr;
+
+/**
+ * Decoded pixels of one page of an image file.
+ * The page is decoded once and borrowed by all consumers (display,
+ * tesseract, exports). Derived versions (grayscale, binarized, connected
+ * components) are created on first request and cached next to the
+ * original. All getters are thread safe, so the object can be shared with
+ * worker threads.
+ */
+class PageImage {
+  public:
+    /** Decode page (0-based) of fileName. Tiff files are read by leptonica,
+     *  other formats by QImage. Returns null pointer on failure.
+     */
+    static PageImagePtr load(const QString& fileName, int page = 0);
+    /** Number of pages in image file (1 for non-tiff files). */
+    static int pageCount(const QString& fileName);
+    /** Returns true if fileName is tiff file. */
+    static bool isTiff(const QString& fileName);
+    /** Convert image to 8 bit indexed image with identity gray table. */
+    static QImage toGrayscale(const QImage& source);
+    /** Bilevel image as QImage::Format_Mono (thresholded if needed). */
+    static QImage toMono(const QImage& bilevel);
+    /** Index of black color in 1 bpp image; it differs between sources
+     *  (Qt, leptonica).
+     */
+    static uchar blackIndex(const QImage& mono);
+
+    QString fileName() const {
+        return m_fileName;
+    }
+    int page() const {
+        return m_page;
+    }
+    int width() const {
+        return m_image.width();
+    }
+    int height() const {
+        return m_image.height();
+    }
+    /** True for 1 bpp page (kept packed as QImage::Format_Mono). */
+    bool isBilevel() const {
+        return m_image.format() == QImage::Format_Mono;
+    }
+
+    /** Original decoded pixels. */
+    QImage image() const;
+    /** 8 bit grayscale version of image (indexed with gray color table). */
+    QImage grayscale() const;
+    /** Binarized version of image. Computed on first request. */
+    QImage binarized() const;
+    /** Replace cached binarized version (e.g. with other method). */
+    void setBinarized(const QImage& image);
+    /** Connected components of binarized version. Computed on first
+     *  request.
+     */
+    ComponentIndexPtr components() const;
+    /** Drop derived versions. */
+    void clearDerived();
+    /** Approximate memory of pixels and derived versions (bytes). */
+    qint64 memoryUsage() const;
+
+  private:
+    PageImage(const QString& fileName, int page, const QImage& image);
+    Q_DISABLE_COPY(PageImage)
+
+    QString m_fileName;
+    int m_page;
+    QImage m_image;
+
+    mutable QMutex m_mutex;  /**< guards derived images */
+    mutable QImage m_grayscale;
+    mutable QImage m_binarized;
+    mutable ComponentIndexPtr m_components;
+};
+
+#endif  // SRC_PAGEIMAGE_H_
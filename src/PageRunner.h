@@ -0,0 +1,156 @@
+/**********************************************************************
+* File:        PageRunner.h
+* Description: Per-page tasks over document with few decoded pages in memory
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_PAGERUNNER_H_
+#define SRC_PAGERUNNER_H_
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrentMap>
+
+#include "Glyph.h"
+#include "PageImage.h"
+
+/**
+ * Work on one page of document. Tasks of consumers derive from it and add
+ * their own parameters and results.
+ */
+struct PageTask {
+    PageTask() : page(0) {
+    }
+
+    QString imageFile;
+    int page;
+    GlyphPage glyphs;
+    PageImagePtr image;  /**< decoded page; loaded by runner when null */
+    QString error;       /**< set when page cannot be loaded */
+};
+
+/**
+ * Runs per-page tasks in chunks: pages of chunk are processed in parallel
+ * (or serially on calling thread), so only few decoded pages are in
+ * memory at once. Runner decodes page of task before process(task) is
+ * called and releases it afterwards; process is not called for page which
+ * cannot be loaded (task.error is set instead).
+ *
+ *     PageRunner<MyTask> runner(PageRunner<MyTask>::forPages(...));
+ *     while (runner.next(MyProcess()))
+ *         consume(runner.chunk());
+ */
+template <typename Task>
+class PageRunner {
+  public:
+    explicit PageRunner(const QVector<Task>& tasks)
+        : m_tasks(tasks), m_next(0), m_serial(false) {
+    }
+
+    /** Tasks for non-empty pages; decoded pages are taken from loaded. */
+    static QVector<Task> forPages(const QString& imageFile,
+                                  const QVector<GlyphPage>& pages,
+                                  const QHash<int, PageImagePtr>& loaded) {
+        QVector<Task> tasks;
+        for (int page = 0; page < pages.size(); ++page) {
+            if (pages.at(page).isEmpty())
+                continue;
+            Task task;
+            task.imageFile = imageFile;
+            task.page = page;
+            task.glyphs = pages.at(page);
+            task.image = loaded.value(page);
+            tasks.append(task);
+        }
+        return tasks;
+    }
+
+    /** Pages processed at once: one decoded page per core at most. */
+    static int chunkSize() {
+        return qMax(1, QThread::idealThreadCount());
+    }
+
+    /** Process tasks on calling thread (e.g. low priority background
+     *  thread which should not occupy global pool).
+     */
+    void setSerial(bool serial) {
+        m_serial = serial;
+    }
+
+    /** Process next chunk of tasks; returns false when all are done. */
+    template <typename Process>
+    bool next(const Process& process) {
+        if (m_next >= m_tasks.size())
+            return false;
+        m_chunk = m_tasks.mid(m_next, chunkSize());
+        // processed tasks are kept only in chunk
+        for (int i = 0; i < m_chunk.size(); ++i)
+            m_tasks[m_next + i] = Task();
+        m_next += m_chunk.size();
+        Runner<Process> runner(process);
+        if (m_serial) {
+            for (int i = 0; i < m_chunk.size(); ++i)
+                runner(m_chunk[i]);
+        } else {
+            QtConcurrent::blockingMap(m_chunk, runner);
+        }
+        return true;
+    }
+
+    /** Tasks of last processed chunk. */
+    QVector<Task>& chunk() {
+        return m_chunk;
+    }
+
+  private:
+    template <typename Process>
+    class Runner {
+      public:
+        typedef void result_type;
+
+        explicit Runner(const Process& process) : m_process(process) {
+        }
+
+        void operator()(Task& task) const {
+            if (!task.image)
+                task.image = PageImage::load(task.imageFile, task.page);
+            if (!task.image) {
+                task.error = QObject::tr("Cannot load page %1 from file %2.")
+                        .arg(task.page + 1).arg(task.imageFile);
+                return;
+            }
+            m_process(task);
+            // do not keep decoded page longer than needed
+            task.image.clear();
+        }
+
+      private:
+        Process m_process;
+    };
+
+    QVector<Task> m_tasks;
+    QVector<Task> m_chunk;
+    int m_next;
+    bool m_serial;
+};
+
+#endif  // SRC_PAGERUNNER_H_
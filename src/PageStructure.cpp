@@ -0,0 +1,480 @@
+/**********************************************************************
+* File:        PageStructure.cpp
+* Description: Text lines and words of page built from boxes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "PageStructure.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+// Letters reaching below baseline (ignored by baseline estimate)
+const char kDescenders[] = "gjpqyQ,;()[]{}|";
+// Letters of x-height (used by x-height estimate)
+const char kXHeightLetters[] = "acemnorsuvwxz";
+
+bool containsAny(const QString& letter, const char* set) {
+    for (int i = 0; i < letter.size(); ++i) {
+        ushort c = letter.at(i).unicode();
+        if (c > 0 && c < 128 && strchr(set, static_cast<char>(c)))
+            return true;
+    }
+    return false;
+}
+
+int median(QVector<int>* values) {
+    if (values->isEmpty())
+        return 0;
+    int* middle = values->begin() + values->size() / 2;
+    std::nth_element(values->begin(), middle, values->end());
+    return *middle;
+}
+
+/*
+ * Box starts new line if it moves back to the left by more than twice
+ * its width (same rule as text export always used)
+ */
+bool startsLine(const Glyph& previous, const Glyph& glyph) {
+    return glyph.left - previous.right <= 2 * (glyph.left - glyph.right);
+}
+
+// Sort key of reading order (x is negated for right to left text)
+struct OrderKey {
+    int line;
+    int x;
+    int row;
+    bool operator<(const OrderKey& other) const {
+        if (line != other.line)
+            return line < other.line;
+        if (x != other.x)
+            return x < other.x;
+        return row < other.row;
+    }
+};
+
+// Row with column and vertical center (tesseract coordinates grow upwards)
+struct CenterRow {
+    int column;
+    int center;
+    int row;
+    bool operator<(const CenterRow& other) const {
+        if (column != other.column)
+            return column < other.column;
+        if (center != other.center)
+            return center > other.center;
+        return row < other.row;
+    }
+};
+
+// Horizontal extent of box
+struct Span {
+    int left;
+    int right;
+    bool operator<(const Span& other) const {
+        return left < other.left;
+    }
+};
+
+}  // namespace
+
+PageStructure::PageStructure(int wordSpace, int paragraphIndent)
+    : m_wordSpace(wordSpace), m_paragraphIndent(paragraphIndent),
+      m_dirtyFirst(-1), m_dirtyLast(-1), m_needsBuild(true) {
+}
+
+void PageStructure::setOptions(int wordSpace, int paragraphIndent) {
+    if (wordSpace == m_wordSpace && paragraphIndent == m_paragraphIndent)
+        return;
+    m_wordSpace = wordSpace;
+    m_paragraphIndent = paragraphIndent;
+    m_needsBuild = true;
+}
+
+void PageStructure::build(const Source& source) {
+    m_lines = sweep(source, 0, source.size() - 1);
+    updateParagraphs(0, m_lines.size() - 1);
+    m_dirtyFirst = m_dirtyLast = -1;
+    m_needsBuild = false;
+}
+
+void PageStructure::build(const GlyphPage& glyphs) {
+    build(PageSource(glyphs));
+}
+
+void PageStructure::clear() {
+    m_lines.clear();
+    m_dirtyFirst = m_dirtyLast = -1;
+    m_needsBuild = true;
+}
+
+void PageStructure::rowsInserted(int first, int count) {
+    if (m_needsBuild || m_lines.isEmpty()) {
+        m_needsBuild = true;
+        return;
+    }
+    // new rows belong to line of previous row until next update()
+    int target = first > 0 ? lineOf(first - 1) : 0;
+    if (target < 0) {
+        m_needsBuild = true;
+        return;
+    }
+    for (int i = target; i < m_lines.size(); ++i) {
+        Line& line = m_lines[i];
+        if (i > target)
+            line.first += count;
+        line.last += count;
+    }
+    if (m_dirtyFirst >= first)
+        m_dirtyFirst += count;
+    if (m_dirtyLast >= first)
+        m_dirtyLast += count;
+    markDirty(first - 1, first + count);
+}
+
+void PageStructure::rowsRemoved(int first, int count) {
+    if (m_needsBuild || m_lines.isEmpty()) {
+        m_needsBuild = true;
+        return;
+    }
+    int end = first + count;
+    QVector<Line> kept;
+    kept.reserve(m_lines.size());
+    for (int i = 0; i < m_lines.size(); ++i) {
+        Line line = m_lines.at(i);
+        int lineFirst = line.first < first ? line.first
+                      : (line.first >= end ? line.first - count : first);
+        int lineLast = line.last < first ? line.last
+                     : (line.last >= end ? line.last - count : first - 1);
+        if (lineLast < lineFirst)
+            continue;  // all rows of line were removed
+        line.first = lineFirst;
+        line.last = lineLast;
+        kept.append(line);
+    }
+    m_lines = kept;
+    if (m_dirtyFirst >= 0) {
+        int dirtyFirst = m_dirtyFirst < first ? m_dirtyFirst
+                       : (m_dirtyFirst >= end ? m_dirtyFirst - count : first);
+        int dirtyLast = m_dirtyLast < first ? m_dirtyLast
+                      : (m_dirtyLast >= end ? m_dirtyLast - count : first);
+        m_dirtyFirst = dirtyFirst;
+        m_dirtyLast = qMax(dirtyFirst, dirtyLast);
+    }
+    markDirty(first - 1, first);
+}
+
+void PageStructure::rowsChanged(int first, int last) {
+    markDirty(first, last);
+}
+
+void PageStructure::markDirty(int first, int last) {
+    first = qMax(0, first);
+    last = qMax(first, last);
+    if (m_dirtyFirst < 0) {
+        m_dirtyFirst = first;
+        m_dirtyLast = last;
+    } else {
+        m_dirtyFirst = qMin(m_dirtyFirst, first);
+        m_dirtyLast = qMax(m_dirtyLast, last);
+    }
+}
+
+void PageStructure::update(const Source& source) {
+    if (!isDirty())
+        return;
+    int size = source.size();
+    if (m_needsBuild || m_lines.isEmpty() || m_lines.last().last != size - 1) {
+        build(source);
+        return;
+    }
+    int firstLine = lineOf(qMin(m_dirtyFirst, size - 1));
+    int lastLine = lineOf(qMin(m_dirtyLast, size - 1));
+    if (firstLine < 0 || lastLine < 0) {
+        build(source);
+        return;
+    }
+    // line breaks depend on pairs of boxes, so one unchanged line on both
+    // sides is enough to join swept part with the rest
+    firstLine = qMax(0, firstLine - 1);
+    lastLine = qMin(m_lines.size() - 1, lastLine + 1);
+    QVector<Line> swept = sweep(source, m_lines.at(firstLine).first,
+                                m_lines.at(lastLine).last);
+    m_lines = m_lines.mid(0, firstLine) + swept + m_lines.mid(lastLine + 1);
+    // paragraph of following line depends on last swept line
+    updateParagraphs(firstLine, firstLine + swept.size());
+    m_dirtyFirst = m_dirtyLast = -1;
+}
+
+int PageStructure::lineOf(int row) const {
+    int low = 0;
+    int high = m_lines.size() - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        const Line& line = m_lines.at(middle);
+        if (row < line.first)
+            high = middle - 1;
+        else if (row > line.last)
+            low = middle + 1;
+        else
+            return middle;
+    }
+    return -1;
+}
+
+bool PageStructure::wordRange(int row, int* first, int* last) const {
+    int index = lineOf(row);
+    if (index < 0)
+        return false;
+    const Line& line = m_lines.at(index);
+    const QVector<int>& words = line.words;
+    int word = std::upper_bound(words.begin(), words.end(), row - line.first)
+            - words.begin() - 1;
+    *first = line.first + words.at(word);
+    *last = (word + 1 < words.size()) ? line.first + words.at(word + 1) - 1
+                                      : line.last;
+    return true;
+}
+
+bool PageStructure::isWordStart(int row) const {
+    int index = lineOf(row);
+    if (index < 0)
+        return false;
+    const Line& line = m_lines.at(index);
+    return std::binary_search(line.words.begin(), line.words.end(),
+                              row - line.first);
+}
+
+QVector<PageStructure::Line> PageStructure::sweep(const Source& source,
+                                                  int first,
+                                                  int last) const {
+    QVector<Line> lines;
+    if (first > last)
+        return lines;
+    Line line;
+    line.first = first;
+    Glyph previous = source.glyph(first);
+    for (int row = first + 1; row <= last; ++row) {
+        Glyph glyph = source.glyph(row);
+        if (startsLine(previous, glyph)) {
+            line.last = row - 1;
+            finishLine(source, &line);
+            lines.append(line);
+            line.first = row;
+        }
+        previous = glyph;
+    }
+    line.last = last;
+    finishLine(source, &line);
+    lines.append(line);
+    return lines;
+}
+
+void PageStructure::finishLine(const Source& source, Line* line) const {
+    QVector<Glyph> glyphs;
+    glyphs.reserve(line->last - line->first + 1);
+    for (int row = line->first; row <= line->last; ++row)
+        glyphs.append(source.glyph(row));
+
+    const Glyph& head = glyphs.at(0);
+    line->left = head.left;
+    line->bottom = head.bottom;
+    line->right = head.right;
+    line->top = head.top;
+    QVector<int> bottoms, heights, xHeights;
+    for (int i = 0; i < glyphs.size(); ++i) {
+        const Glyph& glyph = glyphs.at(i);
+        line->left = qMin(line->left, glyph.left);
+        line->bottom = qMin(line->bottom, glyph.bottom);
+        line->right = qMax(line->right, glyph.right);
+        line->top = qMax(line->top, glyph.top);
+        int height = glyph.top - glyph.bottom;
+        heights.append(height);
+        if (!containsAny(glyph.letter, kDescenders))
+            bottoms.append(glyph.bottom);
+        if (glyph.letter.size() == 1 &&
+                containsAny(glyph.letter, kXHeightLetters))
+            xHeights.append(height);
+    }
+    line->baseline = bottoms.isEmpty() ? line->bottom : median(&bottoms);
+    line->xHeight = xHeights.isEmpty() ? 2 * median(&heights) / 3
+                                       : median(&xHeights);
+    line->paragraph = false;
+
+    int threshold = wordThreshold(*line);
+    line->words.clear();
+    line->words.append(0);
+    for (int i = 1; i < glyphs.size(); ++i) {
+        if (glyphs.at(i).left - glyphs.at(i - 1).right >= threshold)
+            line->words.append(i);
+    }
+}
+
+int PageStructure::wordThreshold(const Line& line) const {
+    if (m_wordSpace > 0)
+        return m_wordSpace;
+    return qMax(2, line.xHeight / 2);
+}
+
+void PageStructure::updateParagraphs(int firstLine, int lastLine) {
+    lastLine = qMin(lastLine, m_lines.size() - 1);
+    for (int i = qMax(0, firstLine); i <= lastLine; ++i) {
+        Line& line = m_lines[i];
+        if (i == 0) {
+            line.paragraph = true;
+            continue;
+        }
+        const Line& previous = m_lines.at(i - 1);
+        if (m_paragraphIndent > 0) {
+            // explicit indent keeps rule of former text export: right
+            // edges differing by half of indent in either direction
+            int indent = m_paragraphIndent;
+            line.paragraph = (line.left - previous.left >= indent) ||
+                    (previous.bottom - line.top >= indent) ||
+                    (qAbs(line.right - previous.right) >= indent / 2);
+            continue;
+        }
+        int indent = 2 * qMax(1, line.xHeight);
+        // indented line, space between lines or short previous line
+        line.paragraph = (line.left - previous.left >= indent) ||
+                (previous.bottom - line.top >= indent) ||
+                (line.right - previous.right >= indent);
+    }
+}
+
+QVector<int> PageStructure::readingOrder(const GlyphPage& glyphs,
+                                         bool rightToLeft) {
+    QVector<int> heights;
+    heights.reserve(glyphs.size());
+    for (int i = 0; i < glyphs.size(); ++i)
+        heights.append(glyphs.at(i).top - glyphs.at(i).bottom);
+    int lineHeight = median(&heights);
+    int minHeight = lineHeight / 2;
+
+    // columns are separated by vertical gaps of at least two line heights
+    // which no box of usual height crosses
+    QVector<Span> spans;
+    for (int i = 0; i < glyphs.size(); ++i) {
+        const Glyph& glyph = glyphs.at(i);
+        if (glyph.top - glyph.bottom >= minHeight) {
+            Span span = { glyph.left, glyph.right };
+            spans.append(span);
+        }
+    }
+    std::sort(spans.begin(), spans.end());
+    QVector<int> separators;
+    int covered = spans.isEmpty() ? 0 : spans.at(0).right;
+    for (int i = 1; i < spans.size(); ++i) {
+        if (spans.at(i).left - covered >= 2 * qMax(1, lineHeight))
+            separators.append((covered + spans.at(i).left) / 2);
+        covered = qMax(covered, spans.at(i).right);
+    }
+    int columns = separators.size() + 1;
+
+    // lines are formed by boxes of at least half of usual height; next box
+    // of column (by vertical center) starts new line if it is under all
+    // boxes of line
+    QVector<int> columnOfRow(glyphs.size(), 0);
+    QVector<CenterRow> main;
+    QVector<int> small;
+    for (int i = 0; i < glyphs.size(); ++i) {
+        const Glyph& glyph = glyphs.at(i);
+        int x = (glyph.left + glyph.right) / 2;
+        int column = std::upper_bound(separators.constBegin(),
+                                      separators.constEnd(), x) -
+                separators.constBegin();
+        columnOfRow[i] = rightToLeft ? columns - 1 - column : column;
+        if (glyph.top - glyph.bottom >= minHeight) {
+            CenterRow item = { columnOfRow.at(i),
+                               (glyph.top + glyph.bottom) / 2, i };
+            main.append(item);
+        } else {
+            small.append(i);
+        }
+    }
+    std::sort(main.begin(), main.end());
+
+    QVector<int> lineOfRow(glyphs.size(), 0);
+    QVector<int> lineBottoms, lineTops, lineColumns;
+    for (int i = 0; i < main.size(); ++i) {
+        const Glyph& glyph = glyphs.at(main.at(i).row);
+        if (lineBottoms.isEmpty() || main.at(i).column != lineColumns.last()
+                || main.at(i).center < lineBottoms.last()) {
+            lineBottoms.append(glyph.bottom);
+            lineTops.append(glyph.top);
+            lineColumns.append(main.at(i).column);
+        } else {
+            lineBottoms.last() = qMin(lineBottoms.last(), glyph.bottom);
+            lineTops.last() = qMax(lineTops.last(), glyph.top);
+        }
+        lineOfRow[main.at(i).row] = lineBottoms.size() - 1;
+    }
+
+    // punctuation, dots and accents go to nearest line (of own column if
+    // possible)
+    for (int i = 0; i < small.size() && !lineBottoms.isEmpty(); ++i) {
+        const Glyph& glyph = glyphs.at(small.at(i));
+        int center = (glyph.top + glyph.bottom) / 2;
+        int best = 0;
+        int bestDistance = INT_MAX;
+        for (int line = 0; line < lineBottoms.size(); ++line) {
+            int distance = qMax(0, qMax(lineBottoms.at(line) - center,
+                                        center - lineTops.at(line)));
+            if (lineColumns.at(line) != columnOfRow.at(small.at(i)))
+                distance = qMin(INT_MAX / 2, distance) + INT_MAX / 2;
+            if (distance < bestDistance) {
+                best = line;
+                bestDistance = distance;
+            }
+        }
+        lineOfRow[small.at(i)] = best;
+    }
+
+    QVector<OrderKey> keys(glyphs.size());
+    for (int i = 0; i < glyphs.size(); ++i) {
+        keys[i].line = lineOfRow.at(i);
+        keys[i].x = rightToLeft ? -glyphs.at(i).right : glyphs.at(i).left;
+        keys[i].row = i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    QVector<int> order(keys.size());
+    for (int i = 0; i < keys.size(); ++i)
+        order[i] = keys.at(i).row;
+    return order;
+}
+
+bool PageStructure::isRightToLeft(const GlyphPage& glyphs) {
+    int rtl = 0;
+    int ltr = 0;
+    for (int i = 0; i < glyphs.size(); ++i) {
+        const QString& letter = glyphs.at(i).letter;
+        for (int j = 0; j < letter.size(); ++j) {
+            QChar::Direction direction = letter.at(j).direction();
+            if (direction == QChar::DirR || direction == QChar::DirAL)
+                ++rtl;
+            else if (direction == QChar::DirL)
+                ++ltr;
+        }
+    }
+    return rtl > ltr;
+}
@@ -0,0 +1,148 @@
+/**********************************************************************
+* File:        PageStructure.h
+* Description: Text lines and words of page built from boxes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_PAGESTRUCTURE_H_
+#define SRC_PAGESTRUCTURE_H_
+
+#include <QVector>
+
+#include "Glyph.h"
+
+/**
+ * Text lines and words of one page.
+ * Lines are runs of boxes in box file order; a line ends where the next
+ * box moves back to the left by more than twice its width. Words are
+ * split by horizontal gaps, paragraphs start at indented lines, after
+ * vertical space or after short lines. Every line knows its bounding box,
+ * baseline and x-height (medians of its boxes).
+ *
+ * Structure is built by one sweep over boxes. Edits only mark rows dirty;
+ * next update() sweeps again just the lines around dirty rows (all
+ * coordinates are in tesseract coordinate system).
+ */
+class PageStructure {
+  public:
+    struct Line {
+        int first;           /**< first row */
+        int last;            /**< last row */
+        int left;
+        int bottom;
+        int right;
+        int top;
+        int baseline;        /**< median bottom of non-descender boxes */
+        int xHeight;         /**< median height of x-height letters */
+        bool paragraph;      /**< line starts paragraph */
+        QVector<int> words;  /**< start of every word (offset from first) */
+    };
+
+    /** Boxes of page structure is built from. */
+    class Source {
+      public:
+        virtual ~Source() {}
+        virtual int size() const = 0;
+        virtual Glyph glyph(int row) const = 0;
+    };
+
+    /** Source reading glyph vector. */
+    class PageSource : public Source {
+      public:
+        explicit PageSource(const GlyphPage& glyphs) : m_glyphs(glyphs) {
+        }
+        int size() const {
+            return m_glyphs.size();
+        }
+        Glyph glyph(int row) const {
+            return m_glyphs.at(row);
+        }
+
+      private:
+        const GlyphPage& m_glyphs;
+    };
+
+    /** Permutation sorting glyphs into reading order; element i is row
+     *  which should be shown at position i. Columns are split at vertical
+     *  gaps (at least two line heights wide) crossing whole page and read
+     *  one after another; lines of column go from top to bottom. Columns
+     *  and boxes of line go from left to right, or from right to left for
+     *  rightToLeft text. Column gap which is interrupted by heading or
+     *  figure spanning columns is not detected.
+     */
+    static QVector<int> readingOrder(const GlyphPage& glyphs,
+                                     bool rightToLeft = false);
+    /** True if most letters of glyphs are of right to left script. */
+    static bool isRightToLeft(const GlyphPage& glyphs);
+
+    /** wordSpace and paragraphIndent of 0 mean estimate from x-height.
+     *  With explicit paragraphIndent line after line whose right edge
+     *  differs by half of indent (either way) starts paragraph, as in
+     *  former text export; estimated indent only counts short previous
+     *  line.
+     */
+    explicit PageStructure(int wordSpace = 0, int paragraphIndent = 0);
+
+    void setOptions(int wordSpace, int paragraphIndent);
+    void build(const Source& source);
+    void build(const GlyphPage& glyphs);
+    void clear();
+
+    /** Rows were inserted before row first. */
+    void rowsInserted(int first, int count);
+    /** Rows first..first + count - 1 were removed. */
+    void rowsRemoved(int first, int count);
+    /** Boxes of rows were changed. */
+    void rowsChanged(int first, int last);
+    bool isDirty() const {
+        return m_dirtyFirst >= 0 || m_needsBuild;
+    }
+    /** Sweep again lines around dirty rows. */
+    void update(const Source& source);
+
+    int lineCount() const {
+        return m_lines.size();
+    }
+    const Line& line(int i) const {
+        return m_lines.at(i);
+    }
+    /** Line containing row or -1. */
+    int lineOf(int row) const;
+    /** Row range of word containing row. Returns false if row is not
+     *  part of structure.
+     */
+    bool wordRange(int row, int* first, int* last) const;
+    bool isWordStart(int row) const;
+
+  private:
+    QVector<Line> sweep(const Source& source, int first, int last) const;
+    void finishLine(const Source& source, Line* line) const;
+    void updateParagraphs(int firstLine, int lastLine);
+    void markDirty(int first, int last);
+    int wordThreshold(const Line& line) const;
+
+    int m_wordSpace;
+    int m_paragraphIndent;
+    QVector<Line> m_lines;
+    int m_dirtyFirst;   /**< dirty rows (-1 if clean) */
+    int m_dirtyLast;
+    bool m_needsBuild;  /**< lines do not match source at all */
+};
+
+#endif  // SRC_PAGESTRUCTURE_H_
@@ -0,0 +1,98 @@
+/**********************************************************************
+* File:        RecognitionJob.cpp
+* Description: Cancellable tesseract recognition with progress
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include <tesseract/ocrclass.h>
+
+#include "RecognitionJob.h"
+#include "Instrumentation.h"
+#include "Settings.h"
+
+#include <QElapsedTimer>
+#include <QSettings>
+
+RecognitionJob::RecognitionJob(tesseract::TessBaseAPI* api,
+                               const CancelToken& cancel)
+    : m_api(api), m_cancel(cancel), m_deadline(0), m_elapsed(0),
+      m_page(0) {
+}
+
+void RecognitionJob::setDeadline(int msecs) {
+    m_deadline = msecs;
+}
+
+void RecognitionJob::setSource(const QString& fileName, int page,
+                               const QString& detail) {
+    m_fileName = fileName;
+    m_page = page;
+    m_detail = detail;
+}
+
+int RecognitionJob::deadlineFromSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    return settings.value("Tesseract/TimeLimit", 0).toInt() * 1000;
+}
+
+QString RecognitionJob::statusName(Status status) {
+    switch (status) {
+    case Finished:
+        return "finished";
+    case Cancelled:
+        return "cancelled";
+    case TimedOut:
+        return "timeout";
+    default:
+        return "failed";
+    }
+}
+
+/*
+ * Called by engine after each word; true stops recognition
+ */
+bool RecognitionJob::cancelRequested(void* job, int /*words*/) {
+    return static_cast<RecognitionJob*>(job)->m_cancel.isCancelled();
+}
+
+RecognitionJob::Status RecognitionJob::run() {
+    ETEXT_DESC monitor;
+    monitor.cancel = &RecognitionJob::cancelRequested;
+    monitor.cancel_this = this;
+    if (m_deadline > 0)
+        monitor.set_deadline_msecs(m_deadline);
+
+    QElapsedTimer timer;
+    timer.start();
+    int result = m_api->Recognize(&monitor);
+    m_elapsed = timer.elapsed();
+
+    Status status = Finished;
+    if (m_cancel.isCancelled())
+        status = Cancelled;
+    else if (m_deadline > 0 && monitor.deadline_exceeded())
+        status = TimedOut;
+    else if (result != 0)
+        status = Failed;
+
+    Instrumentation::record("recognize", m_fileName, m_page, m_elapsed,
+                            statusName(status), m_detail);
+    return status;
+}
@@ -0,0 +1,80 @@
+/**********************************************************************
+* File:        RecognitionJob.h
+* Description: Cancellable tesseract recognition with progress
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_RECOGNITIONJOB_H_
+#define SRC_RECOGNITIONJOB_H_
+
+#include <tesseract/baseapi.h>
+
+#include <QString>
+
+#include "CancelToken.h"
+
+/**
+ * One TessBaseAPI::Recognize call with ETEXT_DESC monitor.
+ * Recognition runs on calling thread (scheduler worker, never GUI
+ * thread); cancel token and optional deadline stop the engine at next
+ * word. Duration and result of each job are recorded by Instrumentation.
+ * Image and rectangle must be set to engine before run().
+ */
+class RecognitionJob {
+  public:
+    enum Status {
+        Finished = 0,
+        Failed,
+        Cancelled,
+        TimedOut
+    };
+
+    RecognitionJob(tesseract::TessBaseAPI* api, const CancelToken& cancel);
+
+    /** Stop recognition after msecs (0 = no deadline). */
+    void setDeadline(int msecs);
+    /** Image file, page and detail (e.g. rectangle) for instrumentation. */
+    void setSource(const QString& fileName, int page,
+                   const QString& detail = QString());
+
+    /** Recognize and wait for result. */
+    Status run();
+    qint64 elapsed() const {
+        return m_elapsed;
+    }
+
+    /** Deadline from setting Tesseract/TimeLimit (seconds, 0 = none). */
+    static int deadlineFromSettings();
+    static QString statusName(Status status);
+
+  private:
+    static bool cancelRequested(void* job, int words);
+
+    tesseract::TessBaseAPI* m_api;
+    CancelToken m_cancel;
+    int m_deadline;
+    qint64 m_elapsed;
+    QString m_fileName;
+    int m_page;
+    QString m_detail;
+
+    Q_DISABLE_COPY(RecognitionJob)
+};
+
+#endif  // SRC_RECOGNITIONJOB_H_
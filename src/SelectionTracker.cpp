@@ -0,0 +1,216 @@
+/**********************************************************************
+* File:        SelectionTracker.cpp
+* Description: Selected rows of box table
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "SelectionTracker.h"
+
+#include <QAbstractItemModel>
+#include <QItemSelectionModel>
+
+SelectionTracker::SelectionTracker(QObject* parent)
+    : QObject(parent), m_count(0), m_anchor(-1), m_current(-1) {
+}
+
+void SelectionTracker::setSelectionModel(
+        QItemSelectionModel* selectionModel) {
+    if (m_selectionModel) {
+        disconnect(m_selectionModel, 0, this, 0);
+        if (m_selectionModel->model())
+            disconnect(m_selectionModel->model(), 0, this, 0);
+    }
+    m_selectionModel = selectionModel;
+    reset();
+    if (!selectionModel)
+        return;
+
+    connect(selectionModel,
+            SIGNAL(selectionChanged(const QItemSelection&, const QItemSelection&)),
+            this,
+            SLOT(selectionChanged(const QItemSelection&, const QItemSelection&)));
+    const QAbstractItemModel* model = selectionModel->model();
+    connect(model, SIGNAL(rowsInserted(const QModelIndex&, int, int)), this,
+            SLOT(rowsInserted(const QModelIndex&, int, int)));
+    connect(model, SIGNAL(rowsRemoved(const QModelIndex&, int, int)), this,
+            SLOT(rowsRemoved(const QModelIndex&, int, int)));
+    connect(model, SIGNAL(modelReset()), this, SLOT(reset()));
+}
+
+bool SelectionTracker::isSelected(int row) const {
+    int i = rangeAfter(row);
+    return i < m_ranges.size() && m_ranges.at(i).first <= row;
+}
+
+QVector<int> SelectionTracker::rows() const {
+    QVector<int> result;
+    result.reserve(m_count);
+    for (int i = 0; i < m_ranges.size(); ++i)
+        for (int row = m_ranges.at(i).first; row <= m_ranges.at(i).last; ++row)
+            result.append(row);
+    return result;
+}
+
+int SelectionTracker::rangeAfter(int row) const {
+    int low = 0;
+    int high = m_ranges.size();
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (m_ranges.at(middle).last < row)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+void SelectionTracker::select(int first, int last) {
+    // merge with overlapping and adjacent ranges
+    int begin = rangeAfter(first - 1);
+    int end = begin;
+    while (end < m_ranges.size() && m_ranges.at(end).first <= last + 1) {
+        const Range& range = m_ranges.at(end);
+        first = qMin(first, range.first);
+        last = qMax(last, range.last);
+        m_count -= range.last - range.first + 1;
+        ++end;
+    }
+    m_ranges.remove(begin, end - begin);
+    m_ranges.insert(begin, Range(first, last));
+    m_count += last - first + 1;
+}
+
+void SelectionTracker::deselect(int first, int last) {
+    int i = rangeAfter(first);
+    while (i < m_ranges.size() && m_ranges.at(i).first <= last) {
+        Range range = m_ranges.at(i);
+        int from = qMax(first, range.first);
+        int to = qMin(last, range.last);
+        m_count -= to - from + 1;
+        if (range.first < from && range.last > to) {
+            // hole in the middle of range
+            m_ranges[i].last = from - 1;
+            m_ranges.insert(i + 1, Range(to + 1, range.last));
+            return;
+        }
+        if (range.first < from) {
+            m_ranges[i++].last = from - 1;
+        } else if (range.last > to) {
+            m_ranges[i].first = to + 1;
+            return;
+        } else {
+            m_ranges.remove(i);
+        }
+    }
+}
+
+void SelectionTracker::updateEnds() {
+    if (m_count == 0) {
+        m_anchor = m_current = -1;
+        return;
+    }
+    if (!isSelected(m_current))
+        m_current = m_ranges.last().last;
+    if (!isSelected(m_anchor))
+        m_anchor = m_current;
+}
+
+void SelectionTracker::selectionChanged(const QItemSelection& selected,
+                                        const QItemSelection& deselected) {
+    // table selects whole rows, so any deselected cell clears row
+    for (int i = 0; i < deselected.size(); ++i)
+        deselect(deselected.at(i).top(), deselected.at(i).bottom());
+    for (int i = 0; i < selected.size(); ++i)
+        select(selected.at(i).top(), selected.at(i).bottom());
+
+    if (!selected.isEmpty()) {
+        m_anchor = selected.first().top();
+        m_current = selected.last().bottom();
+    }
+    updateEnds();
+}
+
+void SelectionTracker::rowsInserted(const QModelIndex& parent, int first,
+                                    int last) {
+    if (parent.isValid())
+        return;
+    int inserted = last - first + 1;
+    int i = rangeAfter(first);
+    if (i < m_ranges.size() && m_ranges.at(i).first < first) {
+        // split range at insertion point
+        Range tail(first, m_ranges.at(i).last);
+        m_ranges[i].last = first - 1;
+        m_ranges.insert(++i, tail);
+    }
+    for (; i < m_ranges.size(); ++i) {
+        m_ranges[i].first += inserted;
+        m_ranges[i].last += inserted;
+    }
+    // inserted rows may fall inside selected range
+    for (int row = first; row <= last; ++row)
+        if (m_selectionModel &&
+                m_selectionModel->isRowSelected(row, QModelIndex()))
+            select(row, row);
+
+    if (m_anchor >= first)
+        m_anchor += inserted;
+    if (m_current >= first)
+        m_current += inserted;
+}
+
+void SelectionTracker::rowsRemoved(const QModelIndex& parent, int first,
+                                   int last) {
+    if (parent.isValid())
+        return;
+    int removed = last - first + 1;
+    deselect(first, last);
+    int i = rangeAfter(first);
+    for (int j = i; j < m_ranges.size(); ++j) {
+        m_ranges[j].first -= removed;
+        m_ranges[j].last -= removed;
+    }
+    // ranges around removed rows may touch now
+    if (i > 0 && i < m_ranges.size() &&
+            m_ranges.at(i - 1).last + 1 == m_ranges.at(i).first) {
+        m_ranges[i - 1].last = m_ranges.at(i).last;
+        m_ranges.remove(i);
+    }
+
+    if (m_anchor > last)
+        m_anchor -= removed;
+    if (m_current > last)
+        m_current -= removed;
+    updateEnds();
+}
+
+void SelectionTracker::reset() {
+    m_ranges.clear();
+    m_count = 0;
+    m_anchor = m_current = -1;
+    if (!m_selectionModel || !m_selectionModel->model())
+        return;
+
+    QItemSelection selection = m_selectionModel->selection();
+    for (int i = 0; i < selection.size(); ++i) {
+        select(selection.at(i).top(), selection.at(i).bottom());
+        m_current = selection.at(i).bottom();
+    }
+    if (!selection.isEmpty())
+        m_anchor = selection.first().top();
+}
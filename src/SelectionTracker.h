@@ -0,0 +1,101 @@
+/**********************************************************************
+* File:        SelectionTracker.h
+* Description: Selected rows of box table
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_SELECTIONTRACKER_H_
+#define SRC_SELECTIONTRACKER_H_
+
+#include <QItemSelection>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+class QAbstractItemModel;
+class QItemSelectionModel;
+
+/**
+ * Selected rows of QItemSelectionModel as sorted list of row ranges.
+ * State is updated from selection deltas and row insert/remove signals,
+ * so work depends on size of change and number of ranges, not on row
+ * count of model. Anchor and current row are first and last row of most
+ * recent selection (current row replaces selectedRows().last()).
+ */
+class SelectionTracker : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit SelectionTracker(QObject* parent = 0);
+
+    /** Track selectionModel (and its model). Must be called before other
+     *  receivers of selectionChanged are connected, so they see updated
+     *  state.
+     */
+    void setSelectionModel(QItemSelectionModel* selectionModel);
+
+    bool isEmpty() const {
+        return m_count == 0;
+    }
+    int count() const {
+        return m_count;
+    }
+    bool isSelected(int row) const;
+    /** First row of most recent selection or -1. */
+    int anchorRow() const {
+        return m_anchor;
+    }
+    /** Last row of most recent selection or -1. */
+    int currentRow() const {
+        return m_current;
+    }
+    /** Selected rows in ascending order. */
+    QVector<int> rows() const;
+
+  private slots:
+    void selectionChanged(const QItemSelection& selected,
+                          const QItemSelection& deselected);
+    void rowsInserted(const QModelIndex& parent, int first, int last);
+    void rowsRemoved(const QModelIndex& parent, int first, int last);
+    void reset();
+
+  private:
+    /** Inclusive range of selected rows. */
+    struct Range {
+        Range() : first(0), last(-1) {}
+        Range(int f, int l) : first(f), last(l) {}
+        int first;
+        int last;
+    };
+
+    /** Index of first range that ends at row or after it. */
+    int rangeAfter(int row) const;
+    void select(int first, int last);
+    void deselect(int first, int last);
+    void updateEnds();
+
+    QPointer<QItemSelectionModel> m_selectionModel;
+    /** Sorted, disjoint and not adjacent */
+    QVector<Range> m_ranges;
+    int m_count;
+    int m_anchor;
+    int m_current;
+};
+
+#endif  // SRC_SELECTIONTRACKER_H_
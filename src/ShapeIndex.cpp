@@ -0,0 +1,192 @@
+/**********************************************************************
+* File:        ShapeIndex.cpp
+* Description: Perceptual hash index of glyph shapes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "ShapeIndex.h"
+#include "PageRunner.h"
+
+namespace {
+
+// Side of grid of average hash (64 cells)
+const int kGrid = 8;
+
+// Boxes differing in size more than this are not the same shape
+bool similarSize(int a, int b) {
+    return qAbs(a - b) <= qMax(2, b / 5);
+}
+
+inline int bitCount(quint64 value) {
+#ifdef __GNUC__
+    return __builtin_popcountll(value);
+#else
+    int count = 0;
+    for (; value; value &= value - 1)
+        ++count;
+    return count;
+#endif  // __GNUC__
+}
+
+inline quint16 hashPart(quint64 hash, int part) {
+    return static_cast<quint16>(hash >> (16 * part));
+}
+
+struct HashTask : PageTask {
+    QVector<ShapeIndex::Entry> entries;
+};
+
+class PageHasher {
+  public:
+    void operator()(HashTask& task) const {
+        QImage bilevel = task.image->binarized();
+        int imageHeight = bilevel.height();
+        for (int i = 0; i < task.glyphs.size(); ++i) {
+            const Glyph& glyph = task.glyphs.at(i);
+            if (glyph.letter.trimmed().isEmpty())
+                continue;
+            ShapeIndex::Entry entry;
+            if (!ShapeIndex::shapeHash(bilevel, glyph.imageRect(imageHeight),
+                                       &entry.hash))
+                continue;
+            entry.page = task.page;
+            entry.left = glyph.left;
+            entry.bottom = glyph.bottom;
+            entry.right = glyph.right;
+            entry.top = glyph.top;
+            task.entries.append(entry);
+        }
+    }
+};
+
+}  // namespace
+
+bool ShapeIndex::shapeHash(const QImage& bilevel, const QRect& box,
+                           quint64* hash) {
+    QImage mono = PageImage::toMono(bilevel);
+    uchar black = PageImage::blackIndex(mono);
+    QRect rect = box.intersected(mono.rect());
+    if (rect.isEmpty())
+        return false;
+
+    // ink of box centered in square grid
+    int cells[kGrid * kGrid] = { 0 };
+    int side = qMax(rect.width(), rect.height());
+    int offsetX = (side - rect.width()) / 2;
+    int offsetY = (side - rect.height()) / 2;
+    int ink = 0;
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const uchar* line = mono.constScanLine(y);
+        int* row = cells + (offsetY + y - rect.top()) * kGrid / side * kGrid;
+        for (int x = rect.left(); x <= rect.right(); ++x) {
+            if (((line[x >> 3] >> (7 - (x & 7))) & 1) != black)
+                continue;
+            ++row[(offsetX + x - rect.left()) * kGrid / side];
+            ++ink;
+        }
+    }
+    if (ink == 0)
+        return false;
+
+    // bit is set for cells with more ink than average
+    quint64 result = 0;
+    for (int i = 0; i < kGrid * kGrid; ++i)
+        if (cells[i] * kGrid * kGrid > ink)
+            result |= Q_UINT64_C(1) << i;
+    *hash = result;
+    return true;
+}
+
+quint64 ShapeIndex::boxKey(int left, int bottom, int right, int top) {
+    return (quint64(quint16(left)) << 48) | (quint64(quint16(bottom)) << 32) |
+            (quint64(quint16(right)) << 16) | quint64(quint16(top));
+}
+
+ShapeIndexPtr ShapeIndex::build(const QString& imageFile,
+                                const QVector<GlyphPage>& pages,
+                                const QHash<int, PageImagePtr>& loaded,
+                                const CancelToken& cancel) {
+    ShapeIndexPtr index(new ShapeIndex);
+    index->m_boxes.resize(pages.size());
+    // pages which cannot be loaded are left out of index
+    PageRunner<HashTask> runner(
+                PageRunner<HashTask>::forPages(imageFile, pages, loaded));
+    while (!cancel.isCancelled() && runner.next(PageHasher())) {
+        const QVector<HashTask>& tasks = runner.chunk();
+        for (int t = 0; t < tasks.size(); ++t)
+            for (int i = 0; i < tasks.at(t).entries.size(); ++i)
+                index->insert(tasks.at(t).entries.at(i));
+    }
+    return index;
+}
+
+void ShapeIndex::insert(const Entry& entry) {
+    int id = m_entries.size();
+    m_entries.append(entry);
+    for (int part = 0; part < 4; ++part)
+        m_tables[part][hashPart(entry.hash, part)].append(id);
+    if (entry.page >= m_boxes.size())
+        m_boxes.resize(entry.page + 1);
+    m_boxes[entry.page].insert(boxKey(entry.left, entry.bottom, entry.right,
+                                      entry.top), id);
+}
+
+bool ShapeIndex::hashOf(int page, const Glyph& glyph, quint64* hash) const {
+    if (page < 0 || page >= m_boxes.size())
+        return false;
+    QHash<quint64, int>::const_iterator it = m_boxes.at(page).constFind(
+                boxKey(glyph.left, glyph.bottom, glyph.right, glyph.top));
+    if (it == m_boxes.at(page).constEnd())
+        return false;
+    *hash = m_entries.at(it.value()).hash;
+    return true;
+}
+
+QVector<ShapeIndex::Entry> ShapeIndex::similar(quint64 hash, int width,
+                                               int height,
+                                               int maxDistance) const {
+    maxDistance = qMin(maxDistance, static_cast<int>(kMaxDistance));
+    QVector<Entry> result;
+    for (int part = 0; part < 4; ++part) {
+        QHash<quint16, QVector<int> >::const_iterator bucket =
+                m_tables[part].constFind(hashPart(hash, part));
+        if (bucket == m_tables[part].constEnd())
+            continue;
+        const QVector<int>& ids = bucket.value();
+        for (int i = 0; i < ids.size(); ++i) {
+            const Entry& entry = m_entries.at(ids.at(i));
+            // entry sharing earlier part was already checked there
+            bool seen = false;
+            for (int earlier = 0; earlier < part && !seen; ++earlier)
+                seen = hashPart(entry.hash, earlier) == hashPart(hash, earlier);
+            if (seen || bitCount(entry.hash ^ hash) > maxDistance)
+                continue;
+            if (!similarSize(entry.right - entry.left, width) ||
+                    !similarSize(entry.top - entry.bottom, height))
+                continue;
+            result.append(entry);
+        }
+    }
+    return result;
+}
+
+qint64 ShapeIndex::memoryUsage() const {
+    // entry, four table references and box key with hash overhead
+    return qint64(m_entries.size()) * (sizeof(Entry) + 4 * sizeof(int) + 32);
+}
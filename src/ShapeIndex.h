@@ -0,0 +1,99 @@
+/**********************************************************************
+* File:        ShapeIndex.h
+* Description: Perceptual hash index of glyph shapes
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_SHAPEINDEX_H_
+#define SRC_SHAPEINDEX_H_
+
+#include <QHash>
+#include <QImage>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include "CancelToken.h"
+#include "Glyph.h"
+#include "PageImage.h"
+
+class ShapeIndex;
+typedef QSharedPointer<ShapeIndex> ShapeIndexPtr;
+
+/**
+ * 64 bit shape hashes of all boxes of document for finding near identical
+ * glyphs (e.g. to relabel all of them at once).
+ * Hash is average hash of box ink scaled (keeping aspect ratio) into 8x8
+ * grid. Lookup uses multi-index hashing: hash is split into four 16 bit
+ * parts, each with its own table; every hash within 3 bits of query
+ * shares at least one part with it, so only few buckets are verified.
+ * Entries are identified by page and box coordinates, so index stays
+ * usable while rows are inserted or moved; edited boxes are not found.
+ */
+class ShapeIndex {
+  public:
+    struct Entry {
+        quint64 hash;
+        int page;
+        int left;    /**< box in tesseract coordinates */
+        int bottom;
+        int right;
+        int top;
+    };
+
+    /** Largest hamming distance supported by lookup. */
+    static const int kMaxDistance = 3;
+
+    /** Build index of all boxes of document (may run in worker thread).
+     *  Pages missing in loaded are decoded from imageFile; pages which can
+     *  not be loaded are skipped. Cancel is checked between chunks of
+     *  pages; cancelled build returns incomplete index.
+     */
+    static ShapeIndexPtr build(const QString& imageFile,
+                               const QVector<GlyphPage>& pages,
+                               const QHash<int, PageImagePtr>& loaded,
+                               const CancelToken& cancel = CancelToken());
+    /** Hash of box (image coordinates) in binarized page. Returns false
+     *  for box without ink.
+     */
+    static bool shapeHash(const QImage& bilevel, const QRect& box,
+                          quint64* hash);
+    /** Key of box coordinates used to find glyph of entry in page. */
+    static quint64 boxKey(int left, int bottom, int right, int top);
+
+    /** Hash of indexed box; false if box is not in index. */
+    bool hashOf(int page, const Glyph& glyph, quint64* hash) const;
+    /** Entries within maxDistance bits of hash and of similar size. */
+    QVector<Entry> similar(quint64 hash, int width, int height,
+                           int maxDistance = kMaxDistance) const;
+
+    int size() const {
+        return m_entries.size();
+    }
+    qint64 memoryUsage() const;
+
+  private:
+    void insert(const Entry& entry);
+
+    QVector<Entry> m_entries;
+    QHash<quint16, QVector<int> > m_tables[4];  /**< part -> entries */
+    QVector<QHash<quint64, int> > m_boxes;  /**< page: boxKey -> entry */
+};
+
+#endif  // SRC_SHAPEINDEX_H_
@@ -22,12 +22,11 @@
 
 #include <locale.h>
 #include "TessTools.h"
+#include "PageImage.h"
+#include "RecognitionJob.h"
 #include "Settings.h"
 
-#ifdef TESSERACT_VERSION  // 3.03 API
-#include <tesseract/renderer.h>
-#endif  // TESSERACT_VERSION
-#include <tesseract/strngs.h>
+#include <tesseract/resultiterator.h>
 
 #include <QApplication>
 #include <QWidget>
@@ -39,6 +38,8 @@
 #include <QDebug>
 #include <QFile>
 
+#include <cstring>
+
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include <QGuiApplication>
 #endif  // QT5
@@ -47,10 +48,12 @@ const char *TessTools::kTrainedDataSuffix = "traineddata";
 
 // TODO(zdenop): Improve code here...
 
-TessTools::TessTools() {
+TessTools::TessTools()
+  : m_releasePending(0), m_api(0), m_pix(NULL), m_imageKey(0) {
 }
 
 TessTools::~TessTools() {
+  freeEngine();
 }
 
 /*
@@ -63,69 +66,150 @@ const char *TessTools::qString2Char(QString string) {
 }
 
 /*!
- * Create tesseract box data from QImage
+ * Recognize page (or only rect of it) and collect symbol boxes straight
+ * from result iterator. Coordinates are converted to tesseract box
+ * coordinates (origin in bottom left corner); font attributes of word are
+ * copied to each of its symbols. Engine and image are kept for next call,
+ * so further rectangles of same image cost only their recognition.
  */
-QString TessTools::makeBoxes(const QImage& qImage, const int page) {
-  PIX   *pixs;
+bool TessTools::makeGlyphs(const QImage& qImage, const int page,
+                           GlyphPage* glyphs, const QRect& rect,
+                           const CancelToken& cancel, QString* error) {
+  QMutexLocker locker(&m_mutex);
+  // engine is needed again, release asked for meanwhile is obsolete
+  m_releasePending = 0;
+  bool ok = recognizeGlyphs(qImage, page, glyphs, rect, cancel, error);
+  // document was hibernated while engine was busy
+  if (m_releasePending.fetchAndStoreOrdered(0))
+    freeEngine();
+  return ok;
+}
 
-  if ((pixs = qImage2PIX(qImage)) == NULL) {
-    msg("Unsupported image type");
-    return "";
+bool TessTools::recognizeGlyphs(const QImage& qImage, const int page,
+                                GlyphPage* glyphs, const QRect& rect,
+                                const CancelToken& cancel, QString* error) {
+  QString key = engineKey();
+  if (m_api && key != m_engineKey)
+    freeEngine();
+  if (!m_api) {
+    m_api = new tesseract::TessBaseAPI();
+    if (!initApi(m_api, error)) {
+      delete m_api;
+      m_api = 0;
+      return false;
+    }
+    m_engineKey = key;
   }
 
-  // http://code.google.com/p/tesseract-ocr/issues/detail?id=228
-  setlocale(LC_NUMERIC, "C");
-  // QString to  const char *
-  #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-  QByteArray byteArray = getLang().toAscii();
-  #else
-  QByteArray byteArray = getLang().toLocal8Bit();
-  #endif
-  const char * apiLang = byteArray.constData();
-
-  // workaroung if datapath/TESSDATA_PREFIX is set...
-  #ifdef _WIN32
-  QString envQString = "TESSDATA_PREFIX=" + getDataPath() ;
-  QByteArray byteArrayWin = envQString.toUtf8();
-  const char * env = byteArrayWin.data();
-  putenv(env);
-  #else
-  QByteArray byteArray1 = getDataPath().toUtf8();
-  const char * datapath = byteArray1.data();
-  setenv("TESSDATA_PREFIX", datapath, 1);
-  #endif
-
-  tesseract::TessBaseAPI *api = new tesseract::TessBaseAPI();
-  if (api->Init(NULL, apiLang)) {
-    msg("Could not initialize tesseract.\n");
-    return "";
+  if (!m_pix || m_imageKey != qImage.cacheKey()) {
+    pixDestroy(&m_pix);
+    if ((m_pix = qImage2PIX(qImage)) == NULL) {
+      *error = QObject::tr("Unsupported image type");
+      return false;
+    }
+    m_imageKey = qImage.cacheKey();
+    m_api->SetImage(m_pix);
+  }
+  if (rect.isNull())
+    m_api->SetRectangle(0, 0, qImage.width(), qImage.height());
+  else
+    m_api->SetRectangle(rect.left(), rect.top(), rect.width(), rect.height());
+
+  RecognitionJob job(m_api, cancel);
+  int deadline = RecognitionJob::deadlineFromSettings();
+  job.setDeadline(deadline);
+  job.setSource(m_sourceName, page, rect.isNull() ? QString("page")
+                : QString("%1,%2 %3x%4").arg(rect.left()).arg(rect.top())
+                  .arg(rect.width()).arg(rect.height()));
+  switch (job.run()) {
+  case RecognitionJob::Finished:
+    break;
+  case RecognitionJob::Cancelled:
+    return false;
+  case RecognitionJob::TimedOut:
+    *error = QObject::tr("Recognition was stopped after time limit of %1 s.")
+        .arg(deadline / 1000);
+    return false;
+  default:
+    *error = QObject::tr("Error during processing.");
+    return false;
+  }
+
+  const int height = qImage.height();
+  glyphs->clear();
+  tesseract::ResultIterator* it = m_api->GetIterator();
+  if (it && !it->Empty(tesseract::RIL_SYMBOL)) {
+    bool bold = false;
+    bool italic = false;
+    bool underline = false;
+    do {
+      if (it->IsAtBeginningOf(tesseract::RIL_WORD)) {
+        bool monospace, serif, smallcaps;
+        int pointsize, fontId;
+        // not available for all engines; keep plain style then
+        if (!it->WordFontAttributes(&bold, &italic, &underline, &monospace,
+                                    &serif, &smallcaps, &pointsize, &fontId))
+          bold = italic = underline = false;
+      }
+      char* text = it->GetUTF8Text(tesseract::RIL_SYMBOL);
+      int left, top, right, bottom;
+      // bounding box is in image coordinates also for rectangle
+      if (text && it->BoundingBox(tesseract::RIL_SYMBOL, &left, &top,
+                                  &right, &bottom)) {
+        Glyph glyph;
+        glyph.letter = QString::fromUtf8(text);
+        glyph.left = left;
+        glyph.bottom = height - bottom;
+        glyph.right = right;
+        glyph.top = height - top;
+        glyph.page = page;
+        glyph.bold = bold;
+        glyph.italic = italic;
+        glyph.underline = underline;
+        glyph.confidence = it->Confidence(tesseract::RIL_SYMBOL);
+        glyphs->append(glyph);
+      }
+      delete[] text;
+    } while (it->Next(tesseract::RIL_SYMBOL));
+  }
+  delete it;
+  return true;
+}
+
+void TessTools::releaseEngine() {
+  // do not wait for recognition running on worker
+  if (!m_mutex.tryLock()) {
+    m_releasePending = 1;
+    return;
   }
+  freeEngine();
+  m_mutex.unlock();
+}
 
-  STRING text_out;
-  QApplication::setOverrideCursor(Qt::WaitCursor);
-
-  int timeout_millisec = 0;
-  const char* filename = NULL;
-  const char* retry_config = NULL;
-#ifdef TESSERACT_VERSION
-  const char* outputbase = NULL;
-  tesseract::TessResultRenderer* renderer = NULL;
-  renderer = new tesseract::TessBoxTextRenderer(outputbase);
-  if (!api->ProcessPage(pixs, page, filename, retry_config,
-                        timeout_millisec, renderer)) {
-#else
-  api->SetVariable("tessedit_create_boxfile", "1");
-  if (!api->ProcessPage(pixs, page, filename, retry_config, timeout_millisec,
-                        &text_out)) {
-#endif  // TESSERACT_VERSION
-    msg("Error during processing.\n");
+void TessTools::freeEngine() {
+  if (m_api) {
+    m_api->End();
+    delete m_api;
+    m_api = 0;
   }
-  QApplication::restoreOverrideCursor();
+  pixDestroy(&m_pix);
+  m_imageKey = 0;
+}
 
-  pixDestroy(&pixs);
-  api->End();
-  delete api;
-  return QString::fromUtf8(text_out.string());
+bool TessTools::initApi(tesseract::TessBaseAPI* api, QString* error) {
+  QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                     SETTING_ORGANIZATION, SETTING_APPLICATION);
+  QString lang = settings.value("Tesseract/Lang").toString();
+  if (lang.isEmpty()) {
+    *error = QObject::tr("You need to configure tesseract in Settings!");
+    return false;
+  }
+  QByteArray apiLang = lang.toLocal8Bit();
+  if (api->Init(NULL, apiLang.constData())) {
+    *error = QObject::tr("Could not initialize tesseract.");
+    return false;
+  }
+  return true;
 }
 
 /*!
@@ -136,6 +220,9 @@ QString TessTools::makeBoxes(const QImage& qImage, const int page) {
 PIX* TessTools::qImage2PIX(const QImage& qImage) {
   PIX * pixs;
 
+  if (qImage.format() == QImage::Format_Mono)
+    return mono2PIX(qImage);
+
   QImage myImage = qImage.rgbSwapped();
   int width = myImage.width();
   int height = myImage.height();
@@ -166,12 +253,74 @@ PIX* TessTools::qImage2PIX(const QImage& qImage) {
   return pixEndianByteSwapNew(pixs);
 }
 
+/*!
+ * Copy packed 1 bpp QImage to PIX without unpacking it.
+ * Leptonica stores rows in 32 bit words with 1 = black.
+ */
+PIX* TessTools::mono2PIX(const QImage& qImage) {
+  int width = qImage.width();
+  int height = qImage.height();
+  PIX * pixs = pixCreate(width, height, 1);
+  if (pixs == NULL)
+    return NULL;
+  int wpl = pixGetWpl(pixs);
+  int bytes = qMin(wpl * 4, qImage.bytesPerLine());
+  l_uint32 *datas = pixGetData(pixs);
+  for (int y = 0; y < height; y++)
+    memcpy(datas + y * wpl, qImage.constScanLine(y), bytes);
+  pixEndianByteSwap(pixs);
+  pixSetPadBits(pixs, 0);
+  if (PageImage::blackIndex(qImage) == 0)
+    pixInvert(pixs, pixs);
+
+  const qreal toDPM = 1.0 / 0.0254;
+  int resolutionX = qImage.dotsPerMeterX() / toDPM;
+  int resolutionY = qImage.dotsPerMeterY() / toDPM;
+  if (resolutionX < 300) resolutionX = 300;
+  if (resolutionY < 300) resolutionY = 300;
+  pixSetResolution(pixs, resolutionX, resolutionY);
+  return pixs;
+}
+
+/*!
+ * Copy 1 bpp PIX to packed QImage::Format_Mono (index 1 = black)
+ */
+QImage TessTools::PIX2mono(PIX *pixImage) {
+  int width = pixGetWidth(pixImage);
+  int height = pixGetHeight(pixImage);
+  PIX * swapped = pixEndianByteSwapNew(pixImage);
+  if (swapped == NULL)
+    return QImage();
+  QImage result(width, height, QImage::Format_Mono);
+  int wpl = pixGetWpl(swapped);
+  int bytes = qMin(wpl * 4, result.bytesPerLine());
+  const l_uint32 *datas = pixGetData(swapped);
+  for (int y = 0; y < height; y++)
+    memcpy(result.scanLine(y), datas + y * wpl, bytes);
+  pixDestroy(&swapped);
+
+  QVector<QRgb> bwTable;
+  bwTable.append(qRgb(255, 255, 255));
+  bwTable.append(qRgb(0, 0, 0));
+  result.setColorTable(bwTable);
+  l_int32 xres, yres;
+  pixGetResolution(pixImage, &xres, &yres);
+  const qreal toDPM = 1.0 / 0.0254;
+  result.setDotsPerMeterX(xres * toDPM);
+  result.setDotsPerMeterY(yres * toDPM);
+  return result;
+}
+
 /*!
  * Convert Leptonica PIX to QImage
  * input: PIX
  * result: QImage
  */
 QImage TessTools::PIX2qImage(PIX *pixImage) {
+  // bilevel scans stay packed
+  if (pixGetDepth(pixImage) == 1)
+    return PIX2mono(pixImage);
+
   int width = pixGetWidth(pixImage);
   int height = pixGetHeight(pixImage);
   int depth = pixGetDepth(pixImage);
@@ -224,34 +373,23 @@ QImage TessTools::PIX2qImage(PIX *pixImage) {
   return result.rgbSwapped();
 }
 
-QImage TessTools::GetThresholded(const QImage& qImage) {
-    // TODO(zdenop): Check this for memory leak
-    PIX * pixs = qImage2PIX(qImage);
-
-    // Set tessdata as Enviromental Variable to avoid problems
-    QByteArray byteArray1 = getDataPath().toUtf8();
-    #ifdef _WIN32
-    QString envQString = "TESSDATA_PREFIX=" + byteArray1 ;
-    const char * env = qString2Char(envQString);
-    putenv(env);
-    #else
-    const char * datapath = byteArray1.data();
-    setenv("TESSDATA_PREFIX", datapath, 1);
-    #endif
-
-    // TODO(zdenop): Why apiLang = qString2Char(getLang()) do not work???
-    #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-    QByteArray byteArray = getLang().toAscii();
-    #else
-    QByteArray byteArray = getLang().toLocal8Bit();
-    #endif
-    const char * apiLang = byteArray.constData();
-
-    setlocale(LC_NUMERIC, "C");
+void TessTools::setupEnvironment() {
+  qputenv("TESSDATA_PREFIX", getDataPath().toUtf8());
+  // http://code.google.com/p/tesseract-ocr/issues/detail?id=228
+  setlocale(LC_NUMERIC, "C");
+}
 
+QImage TessTools::GetThresholded(const QImage& qImage, QString* error) {
     tesseract::TessBaseAPI *api = new tesseract::TessBaseAPI();
-    if (api->Init(NULL, apiLang)) {
-        msg("Could not initialize tesseract.\n");
+    if (!initApi(api, error)) {
+        delete api;
+        return QImage();
+    }
+    PIX * pixs = qImage2PIX(qImage);
+    if (!pixs) {
+        *error = QObject::tr("Unsupported image type");
+        api->End();
+        delete api;
         return QImage();
     }
     api->SetImage(pixs);
@@ -275,6 +413,13 @@ QString TessTools::getDataPath() {
     return dataPath;
 }
 
+QString TessTools::engineKey() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    return settings.value("Tesseract/DataPath").toString() + '\n' +
+           settings.value("Tesseract/Lang").toString();
+}
+
 QString TessTools::getLang() {
     QSettings settings(QSettings::IniFormat, QSettings::UserScope,
                        SETTING_ORGANIZATION, SETTING_APPLICATION);
@@ -25,27 +25,73 @@
 
 #include <tesseract/baseapi.h>
 #include <leptonica/allheaders.h>
-#include "TessTools.h"
+#include "CancelToken.h"
+#include "Glyph.h"
+#include <QAtomicInt>
+#include <QMutex>
 #include <QString>
 #include <QImage>
+#include <QRect>
 
 class TessTools {
 
 public:
   TessTools();
   ~TessTools();
-  QString makeBoxes(const QImage &qImage, const int page);
+  // Recognize image (or only rect of it in image coordinates) and fill
+  // glyphs (with confidences and font attributes) directly from symbol
+  // level result iterator. Engine and image are cached for next call.
+  // Runs on worker thread and shows no message: returns false and error
+  // (empty when cancelled).
+  bool makeGlyphs(const QImage &qImage, const int page, GlyphPage* glyphs,
+                  const QRect &rect, const CancelToken& cancel,
+                  QString* error);
+  // Free cached engine and image. Engine is also replaced when language
+  // or data path in settings changes. Engine busy on worker is freed
+  // when its recognition ends.
+  void releaseEngine();
+  // Image file name recorded with timing of recognition.
+  void setSourceName(const QString &fileName) { m_sourceName = fileName; }
   static PIX* qImage2PIX(const QImage &qImage);
   static QImage PIX2qImage(PIX *pixImage);
-  static QImage GetThresholded(const QImage& qImage);
+  // Packed 1 bpp conversions (no expansion to 8/32 bpp).
+  static PIX* mono2PIX(const QImage &qImage);
+  static QImage PIX2mono(PIX *pixImage);
+  // Tesseract thresholding; null image and error on failure. Shows no
+  // message, so it can be used from worker threads.
+  static QImage GetThresholded(const QImage& qImage, QString* error);
   static const char *qString2Char(QString string);
+  // Initialize api with configured language. Shows no message, so it can
+  // be used from worker threads.
+  static bool initApi(tesseract::TessBaseAPI* api, QString* error);
+  // Export configured tessdata path (TESSDATA_PREFIX) and C numeric
+  // locale for tesseract. Process wide, so it is done from GUI thread at
+  // start and after settings change, never by workers.
+  static void setupEnvironment();
   QList<QString> getLanguages(QString datapath);
 
 private:
   static QString getDataPath();
   static QString getLang();
+  // Data path and language the engine is initialized with.
+  static QString engineKey();
   static void msg(QString messageText);
   static const char *kTrainedDataSuffix;
+
+  bool recognizeGlyphs(const QImage &qImage, const int page,
+                       GlyphPage* glyphs, const QRect &rect,
+                       const CancelToken& cancel, QString* error);
+  void freeEngine();
+
+  QMutex m_mutex;  // held while engine is used
+  QAtomicInt m_releasePending;
+  tesseract::TessBaseAPI* m_api;
+  PIX* m_pix;
+  qint64 m_imageKey;  // cacheKey of image set to m_api
+  QString m_engineKey;  // engineKey() when m_api was initialized
+  QString m_sourceName;
+
+  Q_DISABLE_COPY(TessTools)
 };
 
 #endif  // SRC_INCLUDE_TESSTOOLS_H_
@@ -0,0 +1,264 @@
+/**********************************************************************
+* File:        TextExport.cpp
+* Description: Export of box file symbols to plain text
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "TextExport.h"
+#include "PageStructure.h"
+#include "Settings.h"
+
+#include <QFile>
+#include <QObject>
+#include <QSettings>
+#include <QThread>
+#include <QtConcurrentMap>
+
+namespace {
+
+// Size of output buffer; file is written in blocks of this size
+const int kSinkBuffer = 1 << 20;
+
+class SymbolPerLineSegmenter : public TextSegmenter {
+  public:
+    SymbolPerLineSegmenter() : m_first(true) {
+    }
+    void reset(const GlyphPage& /*page*/) {
+        m_first = true;
+    }
+    const char* separator(const Glyph& /*glyph*/) {
+        if (m_first) {
+            m_first = false;
+            return "";
+        }
+        return "\n";
+    }
+
+  private:
+    bool m_first;
+};
+
+/*
+ * Lines, words and paragraphs are taken from PageStructure of page.
+ * In paragraph mode lines of one paragraph are joined by space.
+ */
+class StructureSegmenter : public TextSegmenter {
+  public:
+    StructureSegmenter(const TextExport::Options& options, bool paragraphs)
+        : m_structure(options.wordSpace, options.paragraphIndent),
+          m_paragraphs(paragraphs), m_row(0) {
+    }
+    void reset(const GlyphPage& page) {
+        m_structure.build(page);
+        m_row = 0;
+    }
+    const char* separator(const Glyph& /*glyph*/) {
+        int row = m_row++;
+        if (row == 0)
+            return "";
+        const PageStructure::Line& line =
+                m_structure.line(m_structure.lineOf(row));
+        if (line.first == row) {
+            if (m_paragraphs && !line.paragraph)
+                return " ";
+            return "\n";
+        }
+        return m_structure.isWordStart(row) ? " " : "";
+    }
+
+  private:
+    PageStructure m_structure;
+    bool m_paragraphs;
+    int m_row;
+};
+
+/*
+ * Output file with large write buffer
+ */
+class BufferedSink {
+  public:
+    explicit BufferedSink(QFile* file) : m_file(file), m_ok(true) {
+        m_buffer.reserve(kSinkBuffer);
+    }
+    void write(const QByteArray& data) {
+        m_buffer += data;
+        if (m_buffer.size() >= kSinkBuffer)
+            flush();
+    }
+    bool flush() {
+        if (m_ok && !m_buffer.isEmpty())
+            m_ok = (m_file->write(m_buffer) == m_buffer.size());
+        m_buffer.clear();
+        return m_ok;
+    }
+
+  private:
+    QFile* m_file;
+    QByteArray m_buffer;
+    bool m_ok;
+};
+
+struct PageText {
+    GlyphPage glyphs;
+    QByteArray text;
+};
+
+class PageTextWriter {
+  public:
+    typedef void result_type;
+
+    PageTextWriter(TextExport::Mode mode, const TextExport::Options& options)
+        : m_mode(mode), m_options(options) {
+    }
+    void operator()(PageText& page) const {
+        TextSegmenter* segmenter = TextExport::createSegmenter(m_mode,
+                                                               m_options);
+        page.text = TextExport::pageText(page.glyphs, segmenter);
+        page.glyphs.clear();
+        delete segmenter;
+    }
+
+  private:
+    TextExport::Mode m_mode;
+    TextExport::Options m_options;
+};
+
+bool writeDocument(const QVector<GlyphPage>& pages, TextExport::Mode mode,
+                   const TextExport::Options& options,
+                   const QString& fileName, QString* error, bool parallel,
+                   const CancelToken& cancel) {
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Text)) {
+        if (error)
+            *error = QObject::tr("Cannot write file %1:\n%2.")
+                    .arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    BufferedSink sink(&file);
+    if (parallel) {
+        // segment chunk of pages in parallel, write them in order
+        int chunk = qMax(4, 4 * QThread::idealThreadCount());
+        PageTextWriter writer(mode, options);
+        for (int first = 0; first < pages.size() && !cancel.isCancelled();
+             first += chunk) {
+            QVector<PageText> texts(qMin(chunk, pages.size() - first));
+            for (int i = 0; i < texts.size(); ++i)
+                texts[i].glyphs = pages.at(first + i);
+            QtConcurrent::blockingMap(texts, writer);
+            for (int i = 0; i < texts.size(); ++i)
+                sink.write(texts.at(i).text);
+        }
+    } else {
+        TextSegmenter* segmenter = TextExport::createSegmenter(mode, options);
+        for (int i = 0; i < pages.size() && !cancel.isCancelled(); ++i)
+            sink.write(TextExport::pageText(pages.at(i), segmenter));
+        delete segmenter;
+    }
+
+    if (cancel.isCancelled()) {
+        file.remove();
+        if (error)
+            *error = QObject::tr("Export was cancelled.");
+        return false;
+    }
+
+    if (!sink.flush()) {
+        if (error)
+            *error = QObject::tr("Cannot write file %1:\n%2.")
+                    .arg(fileName).arg(file.errorString());
+        return false;
+    }
+    file.close();
+    return true;
+}
+
+class DocumentWriter {
+  public:
+    typedef void result_type;
+
+    DocumentWriter(TextExport::Mode mode, const TextExport::Options& options)
+        : m_mode(mode), m_options(options) {
+    }
+    void operator()(TextExport::Job& job) const {
+        job.ok = writeDocument(job.pages, m_mode, m_options, job.fileName,
+                               &job.error, false, CancelToken());
+    }
+
+  private:
+    TextExport::Mode m_mode;
+    TextExport::Options m_options;
+};
+
+}  // namespace
+
+TextExport::Options::Options()
+    : wordSpace(0), paragraphIndent(0) {
+}
+
+TextExport::Options TextExport::Options::fromSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    Options options;
+    options.wordSpace = settings.value("Text/WordSpace").toInt();
+    options.paragraphIndent = settings.value("Text/ParagraphIndent").toInt();
+    return options;
+}
+
+TextSegmenter* TextExport::createSegmenter(Mode mode,
+                                           const Options& options) {
+    switch (mode) {
+    case LinePerLine:
+        return new StructureSegmenter(options, false);
+    case ParagraphPerLine:
+        return new StructureSegmenter(options, true);
+    default:
+        return new SymbolPerLineSegmenter();
+    }
+}
+
+QByteArray TextExport::pageText(const GlyphPage& page,
+                                TextSegmenter* segmenter) {
+    QByteArray text;
+    text.reserve(page.size() * 3 + 1);
+    segmenter->reset(page);
+    for (int i = 0; i < page.size(); ++i) {
+        text += segmenter->separator(page.at(i));
+        text += page.at(i).letter.toUtf8();
+    }
+    text += '\n';
+    return text;
+}
+
+bool TextExport::exportPages(const QVector<GlyphPage>& pages, Mode mode,
+                             const Options& options, const QString& fileName,
+                             QString* error, const CancelToken& cancel) {
+    return writeDocument(pages, mode, options, fileName, error, true,
+                         cancel);
+}
+
+bool TextExport::exportDocuments(QVector<Job>* jobs, Mode mode,
+                                 const Options& options) {
+    // documents run in parallel, pages of one document sequentially
+    QtConcurrent::blockingMap(*jobs, DocumentWriter(mode, options));
+    bool ok = true;
+    for (int i = 0; i < jobs->size(); ++i)
+        ok = ok && jobs->at(i).ok;
+    return ok;
+}
@@ -0,0 +1,93 @@
+/**********************************************************************
+* File:        TextExport.h
+* Description: Export of box file symbols to plain text
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_TEXTEXPORT_H_
+#define SRC_TEXTEXPORT_H_
+
+#include <QString>
+#include <QVector>
+
+#include "CancelToken.h"
+#include "Glyph.h"
+
+/**
+ * Segmentation strategy of text export.
+ * For every glyph of page (in box file order) it tells which separator
+ * goes before glyph. Glyphs are in tesseract coordinates.
+ */
+class TextSegmenter {
+  public:
+    virtual ~TextSegmenter() {}
+    /** Called at start of each page with all glyphs of page. */
+    virtual void reset(const GlyphPage& page) = 0;
+    /** Separator ("", " " or "\n") to write before glyph. */
+    virtual const char* separator(const Glyph& glyph) = 0;
+};
+
+/**
+ * Streaming text export.
+ * Pages of document are segmented in parallel and written in order
+ * through large buffer to output file. Each page ends with new line.
+ */
+class TextExport {
+  public:
+    enum Mode {
+        SymbolPerLine = 1,  /**< one symbol/box per line */
+        LinePerLine,        /**< one text row per line */
+        ParagraphPerLine    /**< one paragraph per line */
+    };
+
+    struct Options {
+        Options();
+        static Options fromSettings();
+
+        int wordSpace;        /**< minimal gap between words (0: auto) */
+        int paragraphIndent;  /**< minimal indentation of paragraph
+                                   (0: auto) */
+    };
+
+    /** One document of exportDocuments(). */
+    struct Job {
+        QVector<GlyphPage> pages;
+        QString fileName;
+        QString error;
+        bool ok;
+    };
+
+    /** New segmenter for mode (caller takes ownership). */
+    static TextSegmenter* createSegmenter(Mode mode, const Options& options);
+    /** Text of one page including final new line. */
+    static QByteArray pageText(const GlyphPage& page, TextSegmenter* segmenter);
+
+    /** Export all pages of document to fileName. Cancel is checked
+     *  between chunks of pages; cancelled export removes the file.
+     */
+    static bool exportPages(const QVector<GlyphPage>& pages, Mode mode,
+                            const Options& options, const QString& fileName,
+                            QString* error,
+                            const CancelToken& cancel = CancelToken());
+    /** Export many documents in parallel. Returns false if any failed. */
+    static bool exportDocuments(QVector<Job>* jobs, Mode mode,
+                                const Options& options);
+};
+
+#endif  // SRC_TEXTEXPORT_H_
@@ -0,0 +1,358 @@
+/**********************************************************************
+* File:        TrainingExport.cpp
+* Description: Export normalized glyph images for classifier training
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "TrainingExport.h"
+#include "GlyphImage.h"
+#include "PageRunner.h"
+#include "Settings.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QFutureSynchronizer>
+#include <QObject>
+#include <QSettings>
+#include <QtConcurrentRun>
+
+#include <cstring>
+
+namespace {
+
+const int kTarBlock = 512;
+
+struct PageCrops : PageTask {
+    QVector<QImage> cells;
+};
+
+class PageCropper {
+  public:
+    explicit PageCropper(int cellSize) : m_cellSize(cellSize) {
+    }
+
+    void operator()(PageCrops& task) const {
+        // bilevel page is cropped packed; only crops are converted to gray
+        QImage source = task.image->isBilevel() ? task.image->image()
+                                                : task.image->grayscale();
+        int imageHeight = source.height();
+        task.cells.reserve(task.glyphs.size());
+        for (int i = 0; i < task.glyphs.size(); ++i)
+            task.cells.append(GlyphImage::normalized(
+                    source, task.glyphs.at(i).imageRect(imageHeight),
+                    m_cellSize));
+    }
+
+  private:
+    int m_cellSize;
+};
+
+QString escapeField(const QString& field) {
+    QString escaped = field;
+    escaped.replace("\\", "\\\\");
+    escaped.replace("\t", "\\t");
+    escaped.replace("\n", "\\n");
+    return escaped;
+}
+
+QByteArray indexLine(const QString& image, int x, int y, int page,
+                     const Glyph& glyph) {
+    QStringList fields;
+    fields << image << QString::number(x) << QString::number(y)
+           << escapeField(glyph.letter) << QString::number(page)
+           << QString::number(glyph.left) << QString::number(glyph.bottom)
+           << QString::number(glyph.right) << QString::number(glyph.top)
+           << QString::number(glyph.bold) << QString::number(glyph.italic)
+           << QString::number(glyph.underline);
+    return fields.join("\t").toUtf8() + '\n';
+}
+
+QByteArray indexHeader() {
+    return QByteArray("image\tx\ty\tletter\tpage\tleft\tbottom\tright\ttop"
+                      "\tbold\titalic\tunderline\n");
+}
+
+bool saveSheet(QImage sheet, QString fileName) {
+    return sheet.save(fileName, "PNG");
+}
+
+/*
+ * Receives normalized cells in document order
+ */
+class GlyphSink {
+  public:
+    virtual ~GlyphSink() {}
+    virtual bool add(int page, const Glyph& glyph, const QImage& cell) = 0;
+    virtual bool finish() = 0;
+    /** Remove everything written so far */
+    virtual void discard() = 0;
+    QString error;
+};
+
+class AtlasSink : public GlyphSink {
+  public:
+    AtlasSink(const QString& fileName, int cellSize, int sheetSize)
+        : m_cellSize(cellSize), m_used(0) {
+        QFileInfo info(fileName);
+        m_base = info.path() + "/" + info.completeBaseName();
+        m_columns = qMax(1, sheetSize / cellSize);
+        m_perSheet = m_columns * m_columns;
+        m_index = indexHeader();
+    }
+
+    bool add(int page, const Glyph& glyph, const QImage& cell) {
+        if (m_sheet.isNull()) {
+            m_sheet = GlyphImage::blankCell(m_columns * m_cellSize,
+                                            m_columns * m_cellSize);
+            m_used = 0;
+        }
+        int x = (m_used % m_columns) * m_cellSize;
+        int y = (m_used / m_columns) * m_cellSize;
+        for (int row = 0; row < m_cellSize; ++row)
+            memcpy(m_sheet.scanLine(y + row) + x, cell.constScanLine(row),
+                   m_cellSize);
+        m_index += indexLine(QFileInfo(sheetName()).fileName(), x, y, page,
+                             glyph);
+        if (++m_used == m_perSheet)
+            flushSheet();
+        return true;
+    }
+
+    bool finish() {
+        if (!m_sheet.isNull())
+            flushSheet();
+        m_pending.waitForFinished();
+        QList<QFuture<bool> > futures = m_pending.futures();
+        for (int i = 0; i < futures.size(); ++i)
+            if (!futures.at(i).result())
+                error = QObject::tr("Cannot write atlas image %1.")
+                        .arg(m_base);
+
+        QFile file(m_base + ".tsv");
+        if (!file.open(QFile::WriteOnly) ||
+                file.write(m_index) != m_index.size()) {
+            error = QObject::tr("Cannot write file %1:\n%2.")
+                    .arg(file.fileName()).arg(file.errorString());
+        }
+        return error.isEmpty();
+    }
+
+    void discard() {
+        m_pending.waitForFinished();
+        for (int i = 0; i < m_pending.futures().size(); ++i)
+            QFile::remove(sheetName(i));
+        QFile::remove(m_base + ".tsv");
+    }
+
+  private:
+    QString sheetName() const {
+        return sheetName(m_pending.futures().size());
+    }
+
+    QString sheetName(int sheet) const {
+        return QString("%1_%2.png").arg(m_base)
+                .arg(sheet, 3, 10, QChar('0'));
+    }
+
+    void flushSheet() {
+        // last sheet is cut after last used row
+        int rows = (m_used + m_columns - 1) / m_columns;
+        QImage sheet = m_sheet;
+        if (rows * m_cellSize < sheet.height())
+            sheet = sheet.copy(0, 0, sheet.width(), rows * m_cellSize);
+        // encode in background while next pages are cropped
+        m_pending.addFuture(QtConcurrent::run(saveSheet, sheet, sheetName()));
+        m_sheet = QImage();
+    }
+
+    QString m_base;
+    int m_cellSize;
+    int m_columns;
+    int m_perSheet;
+    int m_used;
+    QImage m_sheet;
+    QByteArray m_index;
+    QFutureSynchronizer<bool> m_pending;
+};
+
+class TarSink : public GlyphSink {
+  public:
+    explicit TarSink(const QString& fileName)
+        : m_file(fileName), m_count(0) {
+        m_index = indexHeader();
+        m_mtime = QDateTime::currentDateTime().toTime_t();
+        if (!m_file.open(QFile::WriteOnly))
+            error = QObject::tr("Cannot write file %1:\n%2.")
+                    .arg(fileName).arg(m_file.errorString());
+    }
+
+    bool add(int page, const Glyph& glyph, const QImage& cell) {
+        if (!error.isEmpty())
+            return false;
+        QString name = QString("glyphs/%1.pgm")
+                .arg(++m_count, 8, 10, QChar('0'));
+        QByteArray data = QString("P5\n%1 %2\n255\n").arg(cell.width())
+                .arg(cell.height()).toLatin1();
+        for (int row = 0; row < cell.height(); ++row)
+            data.append(reinterpret_cast<const char*>(cell.constScanLine(row)),
+                        cell.width());
+        m_index += indexLine(name, 0, 0, page, glyph);
+        return writeEntry(name, data);
+    }
+
+    bool finish() {
+        if (!error.isEmpty())
+            return false;
+        if (!writeEntry("index.tsv", m_index))
+            return false;
+        // end of archive: two zero blocks
+        QByteArray end(2 * kTarBlock, '\0');
+        if (m_file.write(end) != end.size()) {
+            error = m_file.errorString();
+            return false;
+        }
+        m_file.close();
+        return true;
+    }
+
+    void discard() {
+        if (m_file.isOpen())
+            m_file.remove();
+    }
+
+  private:
+    static void setOctal(char* field, int size, qint64 value) {
+        QByteArray octal = QByteArray::number(value, 8)
+                .rightJustified(size - 1, '0');
+        memcpy(field, octal.constData(), size - 1);
+        field[size - 1] = '\0';
+    }
+
+    bool writeEntry(const QString& name, const QByteArray& data) {
+        // ustar header
+        char header[kTarBlock];
+        memset(header, 0, kTarBlock);
+        QByteArray path = name.toUtf8().left(99);
+        memcpy(header, path.constData(), path.size());
+        setOctal(header + 100, 8, 0644);
+        setOctal(header + 108, 8, 0);
+        setOctal(header + 116, 8, 0);
+        setOctal(header + 124, 12, data.size());
+        setOctal(header + 136, 12, m_mtime);
+        memset(header + 148, ' ', 8);
+        header[156] = '0';
+        memcpy(header + 257, "ustar", 6);
+        memcpy(header + 263, "00", 2);
+
+        unsigned int checksum = 0;
+        for (int i = 0; i < kTarBlock; ++i)
+            checksum += static_cast<unsigned char>(header[i]);
+        setOctal(header + 148, 7, checksum);
+        header[155] = ' ';
+
+        int padding = (kTarBlock - data.size() % kTarBlock) % kTarBlock;
+        if (m_file.write(header, kTarBlock) != kTarBlock ||
+                m_file.write(data) != data.size() ||
+                m_file.write(QByteArray(padding, '\0')) != padding) {
+            error = QObject::tr("Cannot write file %1:\n%2.")
+                    .arg(m_file.fileName()).arg(m_file.errorString());
+            return false;
+        }
+        return true;
+    }
+
+    QFile m_file;
+    int m_count;
+    uint m_mtime;
+    QByteArray m_index;
+};
+
+}  // namespace
+
+TrainingExport::Options::Options()
+    : format(Atlas), cellSize(32), sheetSize(4096) {
+}
+
+TrainingExport::Options TrainingExport::Options::fromSettings() {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    Options options;
+    if (settings.contains("Export/GlyphCellSize"))
+        options.cellSize = settings.value("Export/GlyphCellSize").toInt();
+    if (settings.contains("Export/AtlasSheetSize"))
+        options.sheetSize = settings.value("Export/AtlasSheetSize").toInt();
+    options.cellSize = qBound(8, options.cellSize, 256);
+    options.sheetSize = qMax(options.cellSize, options.sheetSize);
+    return options;
+}
+
+bool TrainingExport::exportGlyphs(const QString& imageFile,
+                                  const QVector<GlyphPage>& pages,
+                                  const QHash<int, PageImagePtr>& loaded,
+                                  const QString& fileName,
+                                  const Options& options,
+                                  int* exported, QString* error,
+                                  const CancelToken& cancel) {
+    GlyphSink* sink = 0;
+    if (options.format == Archive)
+        sink = new TarSink(fileName);
+    else
+        sink = new AtlasSink(fileName, options.cellSize, options.sheetSize);
+
+    // Cells of only one chunk of pages are in memory at once.
+    int count = 0;
+    bool ok = sink->error.isEmpty();
+    PageRunner<PageCrops> runner(
+                PageRunner<PageCrops>::forPages(imageFile, pages, loaded));
+    while (ok && !cancel.isCancelled() &&
+           runner.next(PageCropper(options.cellSize))) {
+        const QVector<PageCrops>& tasks = runner.chunk();
+        for (int t = 0; ok && t < tasks.size(); ++t) {
+            const PageCrops& task = tasks.at(t);
+            if (!task.error.isEmpty()) {
+                sink->error = task.error;
+                ok = false;
+                break;
+            }
+            for (int i = 0; ok && i < task.cells.size(); ++i) {
+                ok = sink->add(task.page, task.glyphs.at(i),
+                               task.cells.at(i));
+                count++;
+            }
+        }
+    }
+    if (ok && cancel.isCancelled()) {
+        sink->error = QObject::tr("Export was cancelled.");
+        ok = false;
+    }
+    if (ok)
+        ok = sink->finish();
+    // no partial sheets or archive are left behind on any failure
+    if (!ok)
+        sink->discard();
+
+    if (error)
+        *error = sink->error;
+    if (exported)
+        *exported = count;
+    delete sink;
+    return ok;
+}
@@ -0,0 +1,74 @@
+/**********************************************************************
+* File:        TrainingExport.h
+* Description: Export normalized glyph images for classifier training
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_TRAININGEXPORT_H_
+#define SRC_TRAININGEXPORT_H_
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "CancelToken.h"
+#include "Glyph.h"
+#include "PageImage.h"
+
+/**
+ * Batch export of training glyphs.
+ * Every box of every page is cut from page image and normalized to
+ * square grayscale cell. Cells are packed either into atlas png sheets
+ * (name_000.png, name_001.png, ...) with name.tsv index, or into
+ * uncompressed tar archive of pgm files with index.tsv member.
+ * Pages are decoded and cropped in parallel; index columns are
+ * image, x, y, letter, page, left, bottom, right, top (box file
+ * coordinates), bold, italic, underline.
+ */
+class TrainingExport {
+  public:
+    enum Format {
+        Atlas = 0,
+        Archive
+    };
+
+    struct Options {
+        Options();
+        static Options fromSettings();
+
+        Format format;
+        int cellSize;   /**< side of normalized glyph cell */
+        int sheetSize;  /**< maximal side of atlas sheet */
+    };
+
+    /** Export glyphs of all pages. Pages are read from imageFile unless
+     *  they are present in loaded (page index -> decoded page).
+     *  Cancel is checked between chunks of pages; files already written
+     *  by cancelled export are removed.
+     */
+    static bool exportGlyphs(const QString& imageFile,
+                             const QVector<GlyphPage>& pages,
+                             const QHash<int, PageImagePtr>& loaded,
+                             const QString& fileName,
+                             const Options& options,
+                             int* exported, QString* error,
+                             const CancelToken& cancel = CancelToken());
+};
+
+#endif  // SRC_TRAININGEXPORT_H_
@@ -0,0 +1,114 @@
+/**********************************************************************
+* File:        WorkspaceDock.cpp
+* Description: Dock with document list of workspace directory
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include "WorkspaceDock.h"
+#include "WorkspaceIndex.h"
+
+#include <QDir>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSortFilterProxyModel>
+#include <QTableView>
+#include <QVBoxLayout>
+
+WorkspaceDock::WorkspaceDock(QWidget* parent)
+    : QDockWidget(tr("Workspace"), parent) {
+    setObjectName("workspaceDock");
+    index = new WorkspaceIndex(this);
+    proxy = new QSortFilterProxyModel(this);
+    proxy->setSourceModel(index);
+    proxy->setSortRole(Qt::EditRole);
+    proxy->setFilterKeyColumn(-1);
+    proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    // rows keep their place while documents are being indexed
+    proxy->setDynamicSortFilter(false);
+
+    QWidget* widget = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    filterEdit = new QLineEdit(widget);
+    filterEdit->setPlaceholderText(tr("Filter"));
+    layout->addWidget(filterEdit);
+    view = new QTableView(widget);
+    view->setModel(proxy);
+    view->setSortingEnabled(true);
+    view->sortByColumn(WorkspaceIndex::FileColumn, Qt::AscendingOrder);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    view->setSelectionMode(QAbstractItemView::SingleSelection);
+    view->setAlternatingRowColors(true);
+    view->verticalHeader()->hide();
+    // fixed row height: no per row size hints for thousands of documents
+    view->verticalHeader()->setDefaultSectionSize(
+                view->fontMetrics().height() + 4);
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+    view->verticalHeader()->setResizeMode(QHeaderView::Fixed);
+#else
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+#endif
+    view->horizontalHeader()->setStretchLastSection(true);
+    layout->addWidget(view);
+    statusLabel = new QLabel(widget);
+    layout->addWidget(statusLabel);
+    setWidget(widget);
+
+    connect(filterEdit, SIGNAL(textChanged(QString)), this,
+            SLOT(setFilter(QString)));
+    connect(view, SIGNAL(activated(QModelIndex)), this,
+            SLOT(rowActivated(QModelIndex)));
+    connect(index, SIGNAL(progress(int, int)), this,
+            SLOT(updateProgress(int, int)));
+}
+
+void WorkspaceDock::openWorkspace(const QString& root) {
+    setWindowTitle(tr("Workspace - %1").arg(QDir(root).dirName()));
+    setToolTip(QDir::toNativeSeparators(root));
+    index->open(root);
+    updateProgress(index->pendingCount(), index->rowCount());
+    view->resizeColumnsToContents();
+}
+
+QString WorkspaceDock::root() const {
+    return index->root();
+}
+
+void WorkspaceDock::rowActivated(const QModelIndex& proxyIndex) {
+    QModelIndex source = proxy->mapToSource(proxyIndex);
+    if (source.isValid())
+        emit documentActivated(index->entry(source.row()).imageFile);
+}
+
+void WorkspaceDock::setFilter(const QString& text) {
+    proxy->setFilterFixedString(text);
+}
+
+void WorkspaceDock::updateProgress(int pending, int total) {
+    if (pending > 0)
+        statusLabel->setText(tr("%1 documents, indexing %2...")
+                             .arg(total).arg(pending));
+    else
+        statusLabel->setText(tr("%1 documents").arg(total));
+    // sort and filter by indexed values
+    if (pending == 0)
+        proxy->invalidate();
+}
@@ -0,0 +1,67 @@
+/**********************************************************************
+* File:        WorkspaceDock.h
+* Description: Dock with document list of workspace directory
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_WORKSPACEDOCK_H_
+#define SRC_WORKSPACEDOCK_H_
+
+#include <QDockWidget>
+#include <QModelIndex>
+#include <QString>
+
+class QLabel;
+class QLineEdit;
+class QSortFilterProxyModel;
+class QTableView;
+class WorkspaceIndex;
+
+/**
+ * Sortable and filterable list of documents of workspace directory
+ * (see WorkspaceIndex). Filter text is matched against all columns, so
+ * e.g. "problem" or "unsaved" shows documents needing attention.
+ * Activating a row asks main window to open the document.
+ */
+class WorkspaceDock : public QDockWidget {
+    Q_OBJECT
+
+  public:
+    explicit WorkspaceDock(QWidget* parent = 0);
+
+    void openWorkspace(const QString& root);
+    QString root() const;
+
+  signals:
+    void documentActivated(const QString& imageFile);
+
+  private slots:
+    void rowActivated(const QModelIndex& index);
+    void setFilter(const QString& text);
+    void updateProgress(int pending, int total);
+
+  private:
+    WorkspaceIndex* index;
+    QSortFilterProxyModel* proxy;
+    QLineEdit* filterEdit;
+    QTableView* view;
+    QLabel* statusLabel;
+};
+
+#endif  // SRC_WORKSPACEDOCK_H_
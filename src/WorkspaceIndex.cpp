@@ -0,0 +1,548 @@
+/**********************************************************************
+* File:        WorkspaceIndex.cpp
+* Description: Background index of image/box documents in directory tree
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#include <leptonica/allheaders.h>
+
+#include "WorkspaceIndex.h"
+#include "BoxValidator.h"
+#include "DocumentCache.h"
+#include "EditJournal.h"
+#include "PageImage.h"
+#include "Settings.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QRunnable>
+#include <QSettings>
+#include <QThread>
+#include <QtConcurrentRun>
+
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'Q', 'B', 'E', 'W'};
+const quint32 kVersion = 1;
+const int kStreamVersion = QDataStream::Qt_4_6;
+// Wait for burst of file changes (e.g. copying directory) before rescan
+const int kRescanDelay = 1000;
+// Index file is written at most this often while indexing
+const int kSaveDelay = 5000;
+
+QDataStream& operator<<(QDataStream& out,
+                        const WorkspaceIndex::Entry& entry) {
+    out << entry.imageFile << entry.imageSize << entry.imageTime
+        << entry.boxSize << entry.boxTime << entry.unsaved
+        << qint32(entry.pageCount) << entry.pageSize
+        << qint32(entry.glyphCount) << qint32(entry.issueCount)
+        << qint32(entry.status) << entry.error;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, WorkspaceIndex::Entry& entry) {
+    qint32 pageCount, glyphCount, issueCount, status;
+    in >> entry.imageFile >> entry.imageSize >> entry.imageTime
+       >> entry.boxSize >> entry.boxTime >> entry.unsaved
+       >> pageCount >> entry.pageSize >> glyphCount >> issueCount
+       >> status >> entry.error;
+    entry.pageCount = pageCount;
+    entry.glyphCount = glyphCount;
+    entry.issueCount = issueCount;
+    entry.status = static_cast<WorkspaceIndex::Status>(status);
+    return in;
+}
+
+QString boxFileOf(const QString& imageFile) {
+    QFileInfo info(imageFile);
+    return info.path() + "/" + info.completeBaseName() + ".box";
+}
+
+/*
+ * Size of first page from image header (no pixels are decoded)
+ */
+QSize headerSize(const QString& imageFile) {
+    QByteArray name = imageFile.toLocal8Bit();
+    l_int32 format, width, height, bps, spp, iscmap;
+    if (pixReadHeader(name.constData(), &format, &width, &height, &bps, &spp,
+                      &iscmap) == 0)
+        return QSize(width, height);
+    return QImageReader(imageFile).size();
+}
+
+void indexDocument(WorkspaceIndex::Entry* entry,
+                   const BoxValidator::Options& options) {
+    entry->pageCount = PageImage::pageCount(entry->imageFile);
+    entry->pageSize = headerSize(entry->imageFile);
+    entry->glyphCount = 0;
+    entry->issueCount = 0;
+    entry->error.clear();
+    if (entry->boxTime < 0) {
+        entry->status = WorkspaceIndex::NoBoxFile;
+        return;
+    }
+
+    QString boxFile = boxFileOf(entry->imageFile);
+    DocumentCache::Document document;
+    if (!DocumentCache::load(entry->imageFile, boxFile, &document)) {
+        document.pages.clear();
+        if (!BoxValidator::readBoxFile(boxFile, &document.pages,
+                                       &entry->error)) {
+            entry->status = WorkspaceIndex::Failed;
+            return;
+        }
+        // editor opens document from cache then
+        document.pageCount = entry->pageCount;
+        document.pageSizes.fill(QSize(), entry->pageCount);
+        if (!document.pageSizes.isEmpty())
+            document.pageSizes[0] = entry->pageSize;
+        DocumentCache::store(entry->imageFile, boxFile, document);
+    }
+    for (int i = 0; i < document.pages.size(); ++i)
+        entry->glyphCount += document.pages.at(i).size();
+
+    // pages are validated on this low priority thread, not on global pool
+    // used by editor
+    QVector<BoxValidator::Issue> issues;
+    if (!BoxValidator::validateDocument(entry->imageFile, document.pages,
+                                        QHash<int, PageImagePtr>(), options,
+                                        &issues, &entry->error, true)) {
+        entry->status = WorkspaceIndex::Failed;
+        return;
+    }
+    entry->issueCount = issues.size();
+    entry->status = issues.isEmpty() ? WorkspaceIndex::Valid
+                                     : WorkspaceIndex::Problems;
+}
+
+class IndexTask : public QRunnable {
+  public:
+    IndexTask(WorkspaceIndex* index, QAtomicInt* generation,
+              const WorkspaceIndex::Entry& entry,
+              const BoxValidator::Options& options)
+        : m_index(index), m_generation(generation), m_entry(entry),
+          m_options(options), m_started(generation->fetchAndAddRelaxed(0)) {
+    }
+
+    void run() {
+        // workspace was closed or reopened meanwhile
+        if (m_generation->fetchAndAddRelaxed(0) != m_started)
+            return;
+        // editor stays responsive while whole tree is indexed
+        QThread::currentThread()->setPriority(QThread::LowPriority);
+        indexDocument(&m_entry, m_options);
+        // index waits for its tasks before it is deleted
+        QMetaObject::invokeMethod(m_index, "addEntry", Qt::QueuedConnection,
+                                  Q_ARG(WorkspaceIndex::Entry, m_entry),
+                                  Q_ARG(int, m_started));
+    }
+
+  private:
+    WorkspaceIndex* m_index;
+    QAtomicInt* m_generation;
+    WorkspaceIndex::Entry m_entry;
+    BoxValidator::Options m_options;
+    int m_started;
+};
+
+}  // namespace
+
+WorkspaceIndex::Entry::Entry()
+    : imageSize(0), imageTime(0), boxSize(0), boxTime(-1), unsaved(false),
+      pageCount(0), glyphCount(0), issueCount(0), status(Pending) {
+}
+
+WorkspaceIndex::WorkspaceIndex(QObject* parent)
+    : QAbstractTableModel(parent), m_pending(0), m_generation(0),
+      m_rescan(false) {
+    qRegisterMetaType<WorkspaceIndex::Entry>("WorkspaceIndex::Entry");
+    // few documents are validated at once, each one page after another
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
+    m_scanWatcher = new QFutureWatcher<Scan>(this);
+    connect(m_scanWatcher, SIGNAL(finished()), this, SLOT(scanFinished()));
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, SIGNAL(directoryChanged(QString)), this,
+            SLOT(directoryChanged()));
+    m_rescanTimer = new QTimer(this);
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(kRescanDelay);
+    connect(m_rescanTimer, SIGNAL(timeout()), this, SLOT(startScan()));
+    m_saveTimer = new QTimer(this);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(kSaveDelay);
+    connect(m_saveTimer, SIGNAL(timeout()), this, SLOT(save()));
+}
+
+WorkspaceIndex::~WorkspaceIndex() {
+    close();
+}
+
+QStringList WorkspaceIndex::imageFilters() {
+    return QStringList() << "*.bmp" << "*.png" << "*.jpeg" << "*.jpg"
+                         << "*.tif" << "*.tiff";
+}
+
+QString WorkspaceIndex::indexFileName(const QString& root) {
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       SETTING_ORGANIZATION, SETTING_APPLICATION);
+    QByteArray name = QCryptographicHash::hash(
+                QDir(root).absolutePath().toUtf8(), QCryptographicHash::Md5)
+            .toHex();
+    return QFileInfo(settings.fileName()).absolutePath() + "/workspaces/" +
+            QString::fromLatin1(name) + ".qbew";
+}
+
+void WorkspaceIndex::open(const QString& root) {
+    close();
+    beginResetModel();
+    m_root = QDir(root).absolutePath();
+    m_entries.clear();
+    load();
+    rebuildRows();
+    endResetModel();
+    startScan();
+}
+
+void WorkspaceIndex::close() {
+    m_generation.fetchAndAddRelaxed(1);
+    m_rescanTimer->stop();
+    m_pool.waitForDone();
+    m_scanWatcher->waitForFinished();
+    if (m_saveTimer->isActive()) {
+        m_saveTimer->stop();
+        save();
+    }
+    if (!m_watcher->directories().isEmpty())
+        m_watcher->removePaths(m_watcher->directories());
+    beginResetModel();
+    m_root.clear();
+    m_entries.clear();
+    m_rows.clear();
+    m_queued.clear();
+    m_pending = 0;
+    endResetModel();
+}
+
+bool WorkspaceIndex::load() {
+    QFile file(indexFileName(m_root));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    char magic[4];
+    quint32 version;
+    QString root;
+    if (in.readRawData(magic, 4) != 4 || memcmp(magic, kMagic, 4) != 0)
+        return false;
+    in >> version >> root;
+    if (in.status() != QDataStream::Ok || version != kVersion ||
+            root != m_root)
+        return false;
+    quint32 count;
+    in >> count;
+    QVector<Entry> entries;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        in >> entry;
+        entries.append(entry);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+    m_entries = entries;
+    return true;
+}
+
+void WorkspaceIndex::save() {
+    if (m_root.isEmpty())
+        return;
+    QString fileName = indexFileName(m_root);
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly))
+        return;
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out.writeRawData(kMagic, 4);
+    out << kVersion << m_root << quint32(m_entries.size());
+    for (int i = 0; i < m_entries.size(); ++i)
+        out << m_entries.at(i);
+}
+
+void WorkspaceIndex::startScan() {
+    if (m_root.isEmpty())
+        return;
+    if (m_scanWatcher->isRunning()) {
+        m_rescan = true;
+        return;
+    }
+    m_rescan = false;
+    m_scanWatcher->setFuture(QtConcurrent::run(&WorkspaceIndex::scanTree,
+                                               m_root));
+}
+
+void WorkspaceIndex::directoryChanged() {
+    m_rescanTimer->start();
+}
+
+/*
+ * Walk tree and read only file attributes
+ */
+WorkspaceIndex::Scan WorkspaceIndex::scanTree(const QString& root) {
+    Scan scan;
+    scan.root = root;
+    scan.directories.append(root);
+    QDirIterator dirs(root, QDir::Dirs | QDir::NoDotAndDotDot,
+                      QDirIterator::Subdirectories);
+    while (dirs.hasNext())
+        scan.directories.append(dirs.next());
+
+    QStringList filters = imageFilters();
+    for (int i = 0; i < scan.directories.size(); ++i) {
+        QFileInfoList images = QDir(scan.directories.at(i)).entryInfoList(
+                    filters, QDir::Files, QDir::Name);
+        for (int j = 0; j < images.size(); ++j) {
+            const QFileInfo& image = images.at(j);
+            Entry entry;
+            entry.imageFile = image.absoluteFilePath();
+            entry.imageSize = image.size();
+            entry.imageTime = image.lastModified().toMSecsSinceEpoch();
+            QString boxFile = boxFileOf(entry.imageFile);
+            QFileInfo box(boxFile);
+            if (box.exists()) {
+                entry.boxSize = box.size();
+                entry.boxTime = box.lastModified().toMSecsSinceEpoch();
+                entry.unsaved = EditJournal::hasRecovery(boxFile);
+            }
+            scan.files.append(entry);
+        }
+    }
+    return scan;
+}
+
+void WorkspaceIndex::scanFinished() {
+    Scan scan = m_scanWatcher->result();
+    // scan of closed workspace
+    if (scan.root != m_root)
+        return;
+
+    // drop documents which do not exist any more
+    QHash<QString, int> found;
+    for (int i = 0; i < scan.files.size(); ++i)
+        found.insert(scan.files.at(i).imageFile, i);
+    for (int row = m_entries.size() - 1; row >= 0; --row) {
+        if (found.contains(m_entries.at(row).imageFile))
+            continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        m_entries.remove(row);
+        endRemoveRows();
+    }
+    rebuildRows();
+
+    bool changed = false;
+    for (int i = 0; i < scan.files.size(); ++i) {
+        const Entry& file = scan.files.at(i);
+        int row = m_rows.value(file.imageFile, -1);
+        if (row < 0) {
+            row = m_entries.size();
+            beginInsertRows(QModelIndex(), row, row);
+            m_entries.append(file);
+            m_rows.insert(file.imageFile, row);
+            endInsertRows();
+            enqueue(file);
+            changed = true;
+            continue;
+        }
+        Entry& entry = m_entries[row];
+        if (entry.imageSize != file.imageSize ||
+                entry.imageTime != file.imageTime ||
+                entry.boxSize != file.boxSize ||
+                entry.boxTime != file.boxTime ||
+                (entry.status == Pending &&
+                 !m_queued.contains(file.imageFile))) {
+            entry = file;
+            enqueue(file);
+        } else if (entry.unsaved != file.unsaved) {
+            entry.unsaved = file.unsaved;
+        } else {
+            continue;
+        }
+        changed = true;
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    }
+
+    QStringList watched = m_watcher->directories();
+    for (int i = 0; i < watched.size(); ++i)
+        if (!scan.directories.contains(watched.at(i)))
+            m_watcher->removePath(watched.at(i));
+    for (int i = 0; i < scan.directories.size(); ++i)
+        if (!watched.contains(scan.directories.at(i)))
+            m_watcher->addPath(scan.directories.at(i));
+    if (changed)
+        m_saveTimer->start();
+    emit progress(m_pending, m_entries.size());
+    if (m_rescan)
+        startScan();
+}
+
+void WorkspaceIndex::enqueue(const Entry& entry) {
+    ++m_pending;
+    m_queued[entry.imageFile] += 1;
+    m_pool.start(new IndexTask(this, &m_generation, entry,
+                               BoxValidator::Options::fromSettings()));
+}
+
+void WorkspaceIndex::addEntry(const WorkspaceIndex::Entry& entry,
+                              int generation) {
+    if (generation != m_generation.fetchAndAddRelaxed(0))
+        return;
+    m_pending = qMax(0, m_pending - 1);
+    if (--m_queued[entry.imageFile] <= 0)
+        m_queued.remove(entry.imageFile);
+    int row = m_rows.value(entry.imageFile, -1);
+    // newer state of file is waiting for its own task
+    if (row >= 0 && m_entries.at(row).imageTime == entry.imageTime &&
+            m_entries.at(row).boxTime == entry.boxTime &&
+            m_entries.at(row).boxSize == entry.boxSize) {
+        bool unsaved = m_entries.at(row).unsaved;
+        m_entries[row] = entry;
+        m_entries[row].unsaved = unsaved;
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+        m_saveTimer->start();
+    }
+    emit progress(m_pending, m_entries.size());
+    if (m_pending == 0) {
+        m_saveTimer->stop();
+        save();
+    }
+}
+
+void WorkspaceIndex::rebuildRows() {
+    m_rows.clear();
+    for (int row = 0; row < m_entries.size(); ++row)
+        m_rows.insert(m_entries.at(row).imageFile, row);
+}
+
+int WorkspaceIndex::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+int WorkspaceIndex::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant WorkspaceIndex::headerData(int section, Qt::Orientation orientation,
+                                    int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+    case FileColumn:
+        return tr("Document");
+    case PagesColumn:
+        return tr("Pages");
+    case SizeColumn:
+        return tr("Size");
+    case GlyphsColumn:
+        return tr("Boxes");
+    case ModifiedColumn:
+        return tr("Modified");
+    case EditsColumn:
+        return tr("Edits");
+    case StatusColumn:
+        return tr("Validation");
+    default:
+        return QVariant();
+    }
+}
+
+/*
+ * Display role gives text, edit role value for sorting
+ */
+QVariant WorkspaceIndex::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+    const Entry& entry = m_entries.at(index.row());
+    bool indexed = entry.status != Pending;
+
+    if (role == Qt::ToolTipRole) {
+        if (index.column() == StatusColumn && !entry.error.isEmpty())
+            return entry.error;
+        return entry.imageFile;
+    }
+    if (role != Qt::DisplayRole && role != Qt::EditRole)
+        return QVariant();
+    bool display = (role == Qt::DisplayRole);
+
+    switch (index.column()) {
+    case FileColumn:
+        return QDir(m_root).relativeFilePath(entry.imageFile);
+    case PagesColumn:
+        if (!indexed)
+            return QVariant();
+        return entry.pageCount;
+    case SizeColumn:
+        if (!indexed || !entry.pageSize.isValid())
+            return QVariant();
+        if (display)
+            return QString("%1x%2").arg(entry.pageSize.width())
+                    .arg(entry.pageSize.height());
+        return entry.pageSize.width() * entry.pageSize.height();
+    case GlyphsColumn:
+        if (!indexed || entry.boxTime < 0)
+            return QVariant();
+        return entry.glyphCount;
+    case ModifiedColumn: {
+        qint64 time = entry.boxTime < 0 ? entry.imageTime : entry.boxTime;
+        if (display)
+            return QDateTime::fromMSecsSinceEpoch(time)
+                    .toString(Qt::SystemLocaleShortDate);
+        return time;
+    }
+    case EditsColumn:
+        if (display)
+            return entry.unsaved ? tr("unsaved") : QString();
+        return entry.unsaved;
+    case StatusColumn:
+        switch (entry.status) {
+        case Pending:
+            return display ? QVariant(tr("indexing...")) : QVariant(-1);
+        case NoBoxFile:
+            return display ? QVariant(tr("no box file")) : QVariant(-2);
+        case Valid:
+            return display ? QVariant(tr("OK")) : QVariant(0);
+        case Problems:
+            return display ? QVariant(tr("%n problem(s)", "",
+                                         entry.issueCount))
+                           : QVariant(entry.issueCount);
+        case Failed:
+            return display ? QVariant(tr("error")) : QVariant(-3);
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
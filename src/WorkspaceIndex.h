@@ -0,0 +1,159 @@
+/**********************************************************************
+* File:        WorkspaceIndex.h
+* Description: Background index of image/box documents in directory tree
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+#ifndef SRC_WORKSPACEINDEX_H_
+#define SRC_WORKSPACEINDEX_H_
+
+#include <QAbstractTableModel>
+#include <QAtomicInt>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMetaType>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * Table of all documents (image file with box file of same base name) in
+ * directory tree.
+ * Directory tree is walked on worker thread and only documents whose image
+ * or box file changed since last run are indexed again: page count, size
+ * of first page, glyph count and validation result (BoxValidator) are
+ * computed on low priority thread pool and parsed boxes are stored in
+ * DocumentCache, so opening indexed document skips box parsing. Index is
+ * kept in "workspaces" directory next to settings file and directories
+ * are watched for changes.
+ */
+class WorkspaceIndex : public QAbstractTableModel {
+    Q_OBJECT
+
+  public:
+    enum Column {
+        FileColumn = 0,
+        PagesColumn,
+        SizeColumn,
+        GlyphsColumn,
+        ModifiedColumn,
+        EditsColumn,
+        StatusColumn,
+        ColumnCount
+    };
+
+    enum Status {
+        Pending = 0,  /**< not indexed yet */
+        NoBoxFile,
+        Valid,
+        Problems,
+        Failed
+    };
+
+    struct Entry {
+        Entry();
+
+        QString imageFile;  /**< absolute path */
+        qint64 imageSize;
+        qint64 imageTime;   /**< modification (msecs since epoch) */
+        qint64 boxSize;
+        qint64 boxTime;     /**< -1 if there is no box file */
+        bool unsaved;       /**< journal with unsaved edits exists */
+        int pageCount;
+        QSize pageSize;     /**< size of first page */
+        int glyphCount;
+        int issueCount;
+        Status status;
+        QString error;
+    };
+
+    explicit WorkspaceIndex(QObject* parent = 0);
+    ~WorkspaceIndex();
+
+    /** Show documents under root (previous index of root is read at
+     *  once, changes are found in background).
+     */
+    void open(const QString& root);
+    void close();
+    QString root() const {
+        return m_root;
+    }
+    const Entry& entry(int row) const {
+        return m_entries.at(row);
+    }
+    /** Documents waiting for indexing. */
+    int pendingCount() const {
+        return m_pending;
+    }
+
+    /** File name filters of supported images. */
+    static QStringList imageFilters();
+    /** File with persistent index of root. */
+    static QString indexFileName(const QString& root);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role) const;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role) const;
+
+  signals:
+    /** Indexing progress; pending is 0 when index is complete. */
+    void progress(int pending, int total);
+
+  private slots:
+    void scanFinished();
+    void addEntry(const WorkspaceIndex::Entry& entry, int generation);
+    void directoryChanged();
+    void startScan();
+    void save();
+
+  private:
+    struct Scan {
+        QString root;
+        QVector<Entry> files;
+        QStringList directories;
+    };
+    static Scan scanTree(const QString& root);
+
+    bool load();
+    void rebuildRows();
+    void enqueue(const Entry& entry);
+
+    QString m_root;
+    QVector<Entry> m_entries;
+    QHash<QString, int> m_rows;  /**< image file -> row */
+    QHash<QString, int> m_queued;  /**< image file -> running tasks */
+    int m_pending;
+    QAtomicInt m_generation;     /**< changed by open/close, stops tasks */
+    QThreadPool m_pool;
+    QFutureWatcher<Scan>* m_scanWatcher;
+    QFileSystemWatcher* m_watcher;
+    QTimer* m_rescanTimer;
+    QTimer* m_saveTimer;
+    bool m_rescan;               /**< change came during running scan */
+};
+
+Q_DECLARE_METATYPE(WorkspaceIndex::Entry)
+
+#endif  // SRC_WORKSPACEINDEX_H_
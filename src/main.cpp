@@ -23,16 +23,118 @@
 
 #include <QTextCodec>
 #include <QApplication>
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QStringList>
 #include <QStyleFactory>
+#include <QTextStream>
 #if defined _COMPOSE_STATIC_
 #include <QtPlugin>
 Q_IMPORT_PLUGIN(qsvg)
 #endif
 
+#include "BoxValidator.h"
 #include "MainWindow.h"
 #include "Settings.h"
+#include "TessTools.h"
+#include "TextExport.h"
+
+/*
+ * Headless validation: qt-box-editor --validate image...
+ * Box file of every image is found by its name (image.box). Prints one
+ * line per problem. Exit code is 0 if no problems were found, 1 if there
+ * are problems and 2 if some file could not be read.
+ */
+int validate(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  app.setOrganizationName(SETTING_ORGANIZATION);
+  app.setApplicationName(SETTING_APPLICATION);
+  QStringList files = app.arguments().mid(2);
+  QTextStream out(stdout);
+  QTextStream err(stderr);
+  if (files.isEmpty()) {
+    err << "Usage: " << app.arguments().at(0) << " --validate image...\n";
+    return 2;
+  }
+
+  // pages may be thresholded by tesseract (Binarize/Method)
+  TessTools::setupEnvironment();
+  QVector<BoxValidator::Issue> issues;
+  QStringList errors;
+  BoxValidator::validateFiles(files, BoxValidator::Options::fromSettings(),
+                              &issues, &errors);
+  out.setCodec("UTF-8");
+  for (int i = 0; i < issues.size(); ++i) {
+    const BoxValidator::Issue& issue = issues.at(i);
+    out << issue.imageFile << ":" << issue.page + 1 << ":" << issue.row + 1
+        << ": " << BoxValidator::typeName(issue.type) << ": "
+        << issue.message << " '" << issue.glyph.letter << "'\n";
+  }
+  for (int i = 0; i < errors.size(); ++i)
+    err << errors.at(i) << "\n";
+
+  if (!errors.isEmpty())
+    return 2;
+  return issues.isEmpty() ? 0 : 1;
+}
+
+/*
+ * Headless text export: qt-box-editor --export-text symbol|line|paragraph
+ * file.box... Text of every box file is written next to it (file.txt).
+ * Documents are exported in parallel. Exit code is 0 on success and 2 if
+ * some file could not be read or written.
+ */
+int exportText(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  app.setOrganizationName(SETTING_ORGANIZATION);
+  app.setApplicationName(SETTING_APPLICATION);
+  QStringList args = app.arguments().mid(2);
+  QTextStream err(stderr);
+  QString mode = args.isEmpty() ? QString() : args.takeFirst();
+  TextExport::Mode exportMode = TextExport::SymbolPerLine;
+  if (mode == "line")
+    exportMode = TextExport::LinePerLine;
+  else if (mode == "paragraph")
+    exportMode = TextExport::ParagraphPerLine;
+  else if (mode != "symbol")
+    args.clear();
+  if (args.isEmpty()) {
+    err << "Usage: " << app.arguments().at(0)
+        << " --export-text symbol|line|paragraph file.box...\n";
+    return 2;
+  }
+
+  bool ok = true;
+  QVector<TextExport::Job> jobs;
+  for (int i = 0; i < args.size(); ++i) {
+    TextExport::Job job;
+    QString error;
+    if (!BoxValidator::readBoxFile(args.at(i), &job.pages, &error)) {
+      err << error << "\n";
+      ok = false;
+      continue;
+    }
+    QFileInfo info(args.at(i));
+    job.fileName = info.path() + "/" + info.completeBaseName() + ".txt";
+    job.ok = false;
+    jobs.append(job);
+  }
+  if (!TextExport::exportDocuments(&jobs, exportMode,
+                                   TextExport::Options::fromSettings())) {
+    for (int i = 0; i < jobs.size(); ++i)
+      if (!jobs.at(i).ok)
+        err << jobs.at(i).error << "\n";
+    ok = false;
+  }
+  return ok ? 0 : 2;
+}
 
 int main(int argc, char* argv[]) {
+  if (argc > 1 && QString(argv[1]) == "--validate")
+    return validate(argc, argv);
+  if (argc > 1 && QString(argv[1]) == "--export-text")
+    return exportText(argc, argv);
+
   Q_INIT_RESOURCE(application);
 
   QApplication app(argc, argv);
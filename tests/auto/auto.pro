@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+SUBDIRS = selectiontracker \
+    glyphdiff \
+    editjournal \
+    pagestructure
@@ -0,0 +1,9 @@
+include(../../tests.pri)
+
+TARGET = tst_editjournal
+
+SOURCES += tst_editjournal.cpp \
+    $$SRC/EditJournal.cpp \
+    $$SRC/Glyph.cpp
+
+HEADERS += $$SRC/EditJournal.h
@@ -0,0 +1,210 @@
+/**********************************************************************
+* File:        tst_editjournal.cpp
+* Description: Tests of EditJournal recording and replay
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QStandardItemModel>
+#include <QtTest>
+
+#include "EditJournal.h"
+
+namespace {
+
+const int kImageHeight = 100;
+
+Glyph makeGlyph(const QString& letter, int left, int bottom, int right,
+                int top, int page = 0) {
+    Glyph glyph;
+    glyph.letter = letter;
+    glyph.left = left;
+    glyph.bottom = bottom;
+    glyph.right = right;
+    glyph.top = top;
+    glyph.page = page;
+    return glyph;
+}
+
+}  // namespace
+
+class TestEditJournal : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void init();
+    void cleanup();
+    void replayModelEdits();
+    void replayPageAndMove();
+    void tornTail();
+    void staleJournal();
+    void discard();
+
+  private:
+    /** Box file with one glyph on page 0 and its parsed pages. */
+    void writeBoxFile();
+    /** Table row of glyph as ChildWidget shows it (image coordinates). */
+    void setRow(int row, const Glyph& glyph);
+
+    QString m_boxFile;
+    QVector<GlyphPage> m_pages;
+    QStandardItemModel* m_model;
+    EditJournal* m_journal;
+};
+
+void TestEditJournal::init() {
+    m_boxFile = QDir::tempPath() + QString("/tst_editjournal_%1.box")
+            .arg(QCoreApplication::applicationPid());
+    writeBoxFile();
+    m_model = new QStandardItemModel(0, 10);
+    m_journal = new EditJournal();
+    m_journal->open(m_boxFile);
+    m_journal->attach(m_model, 0, kImageHeight);
+}
+
+void TestEditJournal::cleanup() {
+    delete m_journal;
+    delete m_model;
+    QFile::remove(EditJournal::journalFileName(m_boxFile));
+    QFile::remove(m_boxFile);
+}
+
+void TestEditJournal::writeBoxFile() {
+    Glyph glyph = makeGlyph("a", 1, 2, 3, 4);
+    QFile file(m_boxFile);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Text));
+    file.write(glyph.toBoxLine().toUtf8() + "\n");
+    file.close();
+    m_pages.clear();
+    m_pages.append(GlyphPage() << glyph);
+}
+
+void TestEditJournal::setRow(int row, const Glyph& glyph) {
+    m_model->setData(m_model->index(row, 0), glyph.letter);
+    m_model->setData(m_model->index(row, 1), glyph.left);
+    m_model->setData(m_model->index(row, 2), kImageHeight - glyph.bottom);
+    m_model->setData(m_model->index(row, 3), glyph.right);
+    m_model->setData(m_model->index(row, 4), kImageHeight - glyph.top);
+    m_model->setData(m_model->index(row, 5), glyph.page);
+    m_model->setData(m_model->index(row, 6), glyph.italic);
+    m_model->setData(m_model->index(row, 7), glyph.bold);
+    m_model->setData(m_model->index(row, 8), glyph.underline);
+}
+
+void TestEditJournal::replayModelEdits() {
+    // table is filled as loaded box file - not journaled
+    m_journal->setSuspended(true);
+    m_model->insertRow(0);
+    setRow(0, m_pages.at(0).at(0));
+    m_journal->setSuspended(false);
+    QVERIFY(!EditJournal::hasRecovery(m_boxFile));
+
+    Glyph inserted = makeGlyph("b", 10, 20, 30, 40);
+    inserted.bold = true;
+    m_model->insertRow(1);
+    setRow(1, inserted);
+    Glyph changed = makeGlyph("c", 5, 6, 7, 8);
+    setRow(0, changed);
+    m_model->insertRow(2);
+    setRow(2, makeGlyph("d", 1, 1, 2, 2));
+    m_model->removeRow(2);
+    m_journal->flush();
+    QVERIFY(EditJournal::hasRecovery(m_boxFile));
+
+    QVector<GlyphPage> pages = m_pages;
+    int applied = 0;
+    QVERIFY(EditJournal::replay(m_boxFile, &pages, &applied));
+    QVERIFY(applied > 0);
+    QCOMPARE(pages.size(), 1);
+    QCOMPARE(pages.at(0).size(), 2);
+    QVERIFY(pages.at(0).at(0) == changed);
+    QVERIFY(pages.at(0).at(1) == inserted);
+}
+
+void TestEditJournal::replayPageAndMove() {
+    GlyphPage generated;
+    generated << makeGlyph("x", 0, 0, 1, 1, 1) << makeGlyph("y", 2, 0, 3, 1, 1)
+              << makeGlyph("z", 4, 0, 5, 1, 1);
+    m_journal->recordPage(1, generated);
+    m_journal->attach(m_model, 1, kImageHeight);
+    m_journal->recordMove(0, 2);
+    m_journal->flush();
+
+    QVector<GlyphPage> pages = m_pages;
+    int applied = 0;
+    QVERIFY(EditJournal::replay(m_boxFile, &pages, &applied));
+    QCOMPARE(applied, 2);
+    QCOMPARE(pages.size(), 2);
+    QVERIFY(pages.at(0) == m_pages.at(0));
+    QCOMPARE(pages.at(1).size(), 3);
+    QCOMPARE(pages.at(1).at(0).letter, QString("y"));
+    QCOMPARE(pages.at(1).at(1).letter, QString("z"));
+    QCOMPARE(pages.at(1).at(2).letter, QString("x"));
+}
+
+void TestEditJournal::tornTail() {
+    m_journal->recordMove(0, 0);
+    m_journal->recordPage(0, GlyphPage());
+    m_journal->flush();
+    delete m_journal;
+    m_journal = 0;
+
+    // interrupted write of last record
+    QFile file(EditJournal::journalFileName(m_boxFile));
+    QVERIFY(file.resize(file.size() - 1));
+
+    QVector<GlyphPage> pages = m_pages;
+    int applied = 0;
+    QVERIFY(EditJournal::replay(m_boxFile, &pages, &applied));
+    QCOMPARE(applied, 1);
+    QVERIFY(pages == m_pages);
+}
+
+void TestEditJournal::staleJournal() {
+    m_journal->recordPage(0, GlyphPage());
+    m_journal->flush();
+
+    // box file was saved by other program after the edits
+    QFile file(m_boxFile);
+    QVERIFY(file.open(QFile::Append | QFile::Text));
+    file.write(makeGlyph("b", 5, 6, 7, 8).toBoxLine().toUtf8() + "\n");
+    file.close();
+
+    QVERIFY(!EditJournal::hasRecovery(m_boxFile));
+    QVector<GlyphPage> pages = m_pages;
+    int applied = 0;
+    QVERIFY(!EditJournal::replay(m_boxFile, &pages, &applied));
+    QCOMPARE(applied, 0);
+    QVERIFY(pages == m_pages);
+}
+
+void TestEditJournal::discard() {
+    m_journal->recordPage(0, GlyphPage());
+    m_journal->flush();
+    QVERIFY(QFile::exists(EditJournal::journalFileName(m_boxFile)));
+    m_journal->discard();
+    QVERIFY(!QFile::exists(EditJournal::journalFileName(m_boxFile)));
+    QVERIFY(!EditJournal::hasRecovery(m_boxFile));
+}
+
+QTEST_MAIN(TestEditJournal)
+#include "tst_editjournal.moc"
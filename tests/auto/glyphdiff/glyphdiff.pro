@@ -0,0 +1,7 @@
+include(../../tests.pri)
+
+TARGET = tst_glyphdiff
+
+SOURCES += tst_glyphdiff.cpp \
+    $$SRC/Glyph.cpp \
+    $$SRC/GlyphDiff.cpp
@@ -0,0 +1,175 @@
+/**********************************************************************
+* File:        tst_glyphdiff.cpp
+* Description: Tests of GlyphDiff
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+
+#include <QtTest>
+
+#include "GlyphDiff.h"
+
+namespace {
+
+/*
+ * Page of one glyph per character of text. Box depends only on letter,
+ * so glyphs compare equal exactly when letters do.
+ */
+GlyphPage makePage(const QString& text, int page = 0) {
+    GlyphPage glyphs;
+    for (int i = 0; i < text.size(); ++i) {
+        Glyph glyph;
+        glyph.letter = text.at(i);
+        glyph.left = 10 * text.at(i).unicode();
+        glyph.bottom = 0;
+        glyph.right = glyph.left + 8;
+        glyph.top = 12;
+        glyph.page = page;
+        glyphs.append(glyph);
+    }
+    return glyphs;
+}
+
+QVector<GlyphPage> apply(QVector<GlyphPage> document,
+                         const QVector<GlyphDiff::Hunk>& hunks) {
+    for (int i = 0; i < hunks.size(); ++i) {
+        const GlyphDiff::Hunk& hunk = hunks.at(i);
+        while (document.size() <= hunk.page)
+            document.append(GlyphPage());
+        GlyphPage& page = document[hunk.page];
+        page.remove(hunk.first, hunk.removed);
+        for (int j = 0; j < hunk.inserted.size(); ++j)
+            page.insert(hunk.first + j, hunk.inserted.at(j));
+    }
+    return document;
+}
+
+}  // namespace
+
+class TestGlyphDiff : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void diffPage_data();
+    void diffPage();
+    void equalDocuments();
+    void changedPagesOnly();
+    void pageCount();
+    void confidenceIgnored();
+};
+
+void TestGlyphDiff::diffPage_data() {
+    QTest::addColumn<QString>("from");
+    QTest::addColumn<QString>("to");
+    QTest::addColumn<int>("first");
+    QTest::addColumn<int>("removed");
+    QTest::addColumn<int>("inserted");
+
+    QTest::newRow("equal") << "abc" << "abc" << 3 << 0 << 0;
+    QTest::newRow("change") << "abcde" << "abXde" << 2 << 1 << 1;
+    QTest::newRow("insert") << "abde" << "abcde" << 2 << 0 << 1;
+    QTest::newRow("remove") << "abcde" << "abde" << 2 << 1 << 0;
+    QTest::newRow("repeated") << "aaa" << "aa" << 2 << 1 << 0;
+    QTest::newRow("append") << "ab" << "abcd" << 2 << 0 << 2;
+    QTest::newRow("prepend") << "cd" << "abcd" << 0 << 0 << 2;
+    QTest::newRow("clear") << "abc" << "" << 0 << 3 << 0;
+    QTest::newRow("all") << "abc" << "xyz" << 0 << 3 << 3;
+}
+
+void TestGlyphDiff::diffPage() {
+    QFETCH(QString, from);
+    QFETCH(QString, to);
+    QFETCH(int, first);
+    QFETCH(int, removed);
+    QFETCH(int, inserted);
+
+    GlyphPage oldPage = makePage(from);
+    GlyphPage newPage = makePage(to);
+    GlyphDiff::Hunk hunk = GlyphDiff::diffPage(0, oldPage, newPage);
+    QCOMPARE(hunk.page, 0);
+    QCOMPARE(hunk.first, first);
+    QCOMPARE(hunk.removed, removed);
+    QCOMPARE(hunk.inserted.size(), inserted);
+
+    QVector<GlyphPage> document;
+    document.append(oldPage);
+    QVector<GlyphDiff::Hunk> hunks;
+    hunks.append(hunk);
+    QVERIFY(apply(document, hunks).at(0) == newPage);
+}
+
+void TestGlyphDiff::equalDocuments() {
+    QVector<GlyphPage> document;
+    document << makePage("abc", 0) << makePage("def", 1);
+    QVector<GlyphPage> copy = document;
+    QVERIFY(GlyphDiff::diff(document, copy).isEmpty());
+
+    // deep copy compares equal too
+    copy[1] = makePage("def", 1);
+    QVERIFY(GlyphDiff::diff(document, copy).isEmpty());
+}
+
+void TestGlyphDiff::changedPagesOnly() {
+    QVector<GlyphPage> from;
+    from << makePage("abc", 0) << makePage("def", 1) << makePage("ghi", 2);
+    QVector<GlyphPage> to = from;
+    to[1][1].letter = "X";
+
+    QVector<GlyphDiff::Hunk> hunks = GlyphDiff::diff(from, to);
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks.at(0).page, 1);
+    QCOMPARE(hunks.at(0).first, 1);
+    QCOMPARE(hunks.at(0).removed, 1);
+    QCOMPARE(hunks.at(0).inserted.size(), 1);
+    QCOMPARE(hunks.at(0).inserted.at(0).letter, QString("X"));
+    QVERIFY(apply(from, hunks) == to);
+}
+
+void TestGlyphDiff::pageCount() {
+    QVector<GlyphPage> from;
+    from << makePage("abc", 0) << makePage("def", 1);
+    QVector<GlyphPage> to;
+    to << makePage("abc", 0);
+
+    // missing page removes all its glyphs
+    QVector<GlyphDiff::Hunk> hunks = GlyphDiff::diff(from, to);
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks.at(0).page, 1);
+    QCOMPARE(hunks.at(0).removed, 3);
+    QVERIFY(hunks.at(0).inserted.isEmpty());
+
+    // new page inserts all its glyphs
+    hunks = GlyphDiff::diff(to, from);
+    QCOMPARE(hunks.size(), 1);
+    QCOMPARE(hunks.at(0).page, 1);
+    QCOMPARE(hunks.at(0).removed, 0);
+    QCOMPARE(hunks.at(0).inserted.size(), 3);
+    QVERIFY(apply(to, hunks) == from);
+}
+
+void TestGlyphDiff::confidenceIgnored() {
+    QVector<GlyphPage> from;
+    from << makePage("abc");
+    QVector<GlyphPage> to = from;
+    to[0][0].confidence = 42;
+    QVERIFY(GlyphDiff::diff(from, to).isEmpty());
+}
+
+QTEST_MAIN(TestGlyphDiff)
+#include "tst_glyphdiff.moc"
@@ -0,0 +1,7 @@
+include(../../tests.pri)
+
+TARGET = tst_pagestructure
+
+SOURCES += tst_pagestructure.cpp \
+    $$SRC/Glyph.cpp \
+    $$SRC/PageStructure.cpp
@@ -0,0 +1,217 @@
+/**********************************************************************
+* File:        tst_pagestructure.cpp
+* Description: Tests of PageStructure
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+
+#include <QStringList>
+#include <QtTest>
+
+#include "PageStructure.h"
+
+namespace {
+
+// Explicit word space of tests (gap inside word is 2, between words 12)
+const int kWordSpace = 6;
+const int kLineHeight = 30;
+const int kTop = 1000;
+
+/*
+ * Glyphs of text lines; every character is box 8 wide, space is
+ * 10 wide gap
+ */
+GlyphPage makeText(const QStringList& lines) {
+    GlyphPage glyphs;
+    for (int i = 0; i < lines.size(); ++i) {
+        int x = 0;
+        int bottom = kTop - i * kLineHeight;
+        for (int j = 0; j < lines.at(i).size(); ++j) {
+            QChar c = lines.at(i).at(j);
+            if (c != ' ') {
+                Glyph glyph;
+                glyph.letter = c;
+                glyph.left = x;
+                glyph.right = x + 8;
+                glyph.bottom = bottom;
+                glyph.top = bottom + 10;
+                glyphs.append(glyph);
+            }
+            x += 10;
+        }
+    }
+    return glyphs;
+}
+
+bool sameLine(const PageStructure::Line& a, const PageStructure::Line& b) {
+    return a.first == b.first && a.last == b.last && a.left == b.left &&
+            a.bottom == b.bottom && a.right == b.right && a.top == b.top &&
+            a.baseline == b.baseline && a.xHeight == b.xHeight &&
+            a.paragraph == b.paragraph && a.words == b.words;
+}
+
+}  // namespace
+
+class TestPageStructure : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void build();
+    void wordRange();
+    void incrementalUpdate_data();
+    void incrementalUpdate();
+    void readingOrder_data();
+    void readingOrder();
+};
+
+void TestPageStructure::build() {
+    GlyphPage glyphs = makeText(QStringList() << "ab cd" << "efg");
+    PageStructure structure(kWordSpace);
+    QVERIFY(structure.isDirty());
+    structure.build(glyphs);
+    QVERIFY(!structure.isDirty());
+
+    QCOMPARE(structure.lineCount(), 2);
+    const PageStructure::Line& first = structure.line(0);
+    QCOMPARE(first.first, 0);
+    QCOMPARE(first.last, 3);
+    QCOMPARE(first.left, 0);
+    QCOMPARE(first.right, 48);
+    QCOMPARE(first.bottom, kTop);
+    QCOMPARE(first.top, kTop + 10);
+    QCOMPARE(first.baseline, kTop);
+    QCOMPARE(first.words, QVector<int>() << 0 << 2);
+    QVERIFY(first.paragraph);
+
+    const PageStructure::Line& second = structure.line(1);
+    QCOMPARE(second.first, 4);
+    QCOMPARE(second.last, 6);
+    QCOMPARE(second.words, QVector<int>() << 0);
+    QCOMPARE(structure.lineOf(5), 1);
+    QCOMPARE(structure.lineOf(7), -1);
+}
+
+void TestPageStructure::wordRange() {
+    GlyphPage glyphs = makeText(QStringList() << "ab cd e" << "fg");
+    PageStructure structure(kWordSpace);
+    structure.build(glyphs);
+
+    int first = -1, last = -1;
+    QVERIFY(structure.wordRange(3, &first, &last));
+    QCOMPARE(first, 2);
+    QCOMPARE(last, 3);
+    QVERIFY(structure.wordRange(4, &first, &last));
+    QCOMPARE(first, 4);
+    QCOMPARE(last, 4);
+    QVERIFY(structure.wordRange(6, &first, &last));
+    QCOMPARE(first, 5);
+    QCOMPARE(last, 6);
+    QVERIFY(!structure.wordRange(7, &first, &last));
+
+    QVERIFY(structure.isWordStart(0));
+    QVERIFY(!structure.isWordStart(1));
+    QVERIFY(structure.isWordStart(2));
+    QVERIFY(structure.isWordStart(5));
+}
+
+void TestPageStructure::incrementalUpdate_data() {
+    QTest::addColumn<QString>("edit");
+    QTest::newRow("insert word") << "insert";
+    QTest::newRow("remove line") << "remove";
+    QTest::newRow("split word") << "change";
+    QTest::newRow("break line") << "break";
+}
+
+void TestPageStructure::incrementalUpdate() {
+    QFETCH(QString, edit);
+    QStringList text;
+    text << "the quick" << "brown fox" << "jumps over" << "the lazy dog";
+    GlyphPage glyphs = makeText(text);
+    PageStructure structure(kWordSpace);
+    structure.build(glyphs);
+
+    // edit rows as editor does and tell structure about it
+    if (edit == "insert") {
+        // word "red" at end of second line (rows 8..15)
+        GlyphPage word = makeText(QStringList() << "" << "          red");
+        for (int i = 0; i < word.size(); ++i)
+            glyphs.insert(16 + i, word.at(i));
+        structure.rowsInserted(16, word.size());
+    } else if (edit == "remove") {
+        // third line (rows 16..24)
+        glyphs.remove(16, 9);
+        structure.rowsRemoved(16, 9);
+    } else if (edit == "change") {
+        // gap inside "brown" becomes space between words
+        for (int row = 10; row <= 15; ++row) {
+            glyphs[row].left += 20;
+            glyphs[row].right += 20;
+        }
+        structure.rowsChanged(10, 15);
+    } else {
+        // "fox" moves to start of new line
+        for (int row = 13; row <= 15; ++row) {
+            glyphs[row].left -= 60;
+            glyphs[row].right -= 60;
+        }
+        structure.rowsChanged(13, 15);
+    }
+    QVERIFY(structure.isDirty());
+    structure.update(PageStructure::PageSource(glyphs));
+    QVERIFY(!structure.isDirty());
+
+    PageStructure expected(kWordSpace);
+    expected.build(glyphs);
+    QCOMPARE(structure.lineCount(), expected.lineCount());
+    for (int i = 0; i < expected.lineCount(); ++i)
+        QVERIFY2(sameLine(structure.line(i), expected.line(i)),
+                 qPrintable(QString("line %1").arg(i)));
+}
+
+void TestPageStructure::readingOrder_data() {
+    QTest::addColumn<bool>("rightToLeft");
+    QTest::addColumn<QString>("order");
+    QTest::newRow("left to right") << false << "2 3 4 5 0 1 6 7";
+    QTest::newRow("right to left") << true << "1 0 7 6 3 2 5 4";
+}
+
+void TestPageStructure::readingOrder() {
+    QFETCH(bool, rightToLeft);
+    QFETCH(QString, order);
+
+    // two columns 400 apart; box file lists lines of both mixed
+    GlyphPage left = makeText(QStringList() << "ab" << "cd");
+    GlyphPage right = makeText(QStringList() << "ef" << "gh");
+    for (int i = 0; i < right.size(); ++i) {
+        right[i].left += 400;
+        right[i].right += 400;
+    }
+    GlyphPage glyphs;
+    glyphs << right.at(0) << right.at(1) << left.at(0) << left.at(1)
+           << left.at(2) << left.at(3) << right.at(2) << right.at(3);
+
+    QVector<int> rows = PageStructure::readingOrder(glyphs, rightToLeft);
+    QStringList result;
+    for (int i = 0; i < rows.size(); ++i)
+        result << QString::number(rows.at(i));
+    QCOMPARE(result.join(" "), order);
+}
+
+QTEST_MAIN(TestPageStructure)
+#include "tst_pagestructure.moc"
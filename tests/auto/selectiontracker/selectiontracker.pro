@@ -0,0 +1,8 @@
+include(../../tests.pri)
+
+TARGET = tst_selectiontracker
+
+SOURCES += tst_selectiontracker.cpp \
+    $$SRC/SelectionTracker.cpp
+
+HEADERS += $$SRC/SelectionTracker.h
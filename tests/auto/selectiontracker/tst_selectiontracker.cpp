@@ -0,0 +1,174 @@
+/**********************************************************************
+* File:        tst_selectiontracker.cpp
+* Description: Tests of SelectionTracker
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+
+#include <QItemSelectionModel>
+#include <QStandardItemModel>
+#include <QtTest>
+
+#include "SelectionTracker.h"
+
+class TestSelectionTracker : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void init();
+    void cleanup();
+    void selectRange();
+    void deselectMiddle();
+    void mergeAdjacent();
+    void insertRows();
+    void removeRows();
+    void removeSelectedRows();
+    void clearSelection();
+    void resetOnModelReset();
+
+  private:
+    void select(int first, int last,
+                QItemSelectionModel::SelectionFlags command =
+                        QItemSelectionModel::Select);
+    QVector<int> range(int first, int last) const;
+
+    QStandardItemModel* m_model;
+    QItemSelectionModel* m_selection;
+    SelectionTracker* m_tracker;
+};
+
+void TestSelectionTracker::init() {
+    m_model = new QStandardItemModel(100, 3);
+    m_selection = new QItemSelectionModel(m_model);
+    m_tracker = new SelectionTracker();
+    m_tracker->setSelectionModel(m_selection);
+}
+
+void TestSelectionTracker::cleanup() {
+    delete m_tracker;
+    delete m_selection;
+    delete m_model;
+}
+
+void TestSelectionTracker::select(
+        int first, int last, QItemSelectionModel::SelectionFlags command) {
+    QItemSelection selection(m_model->index(first, 0),
+                             m_model->index(last, 0));
+    m_selection->select(selection, command | QItemSelectionModel::Rows);
+}
+
+QVector<int> TestSelectionTracker::range(int first, int last) const {
+    QVector<int> rows;
+    for (int row = first; row <= last; ++row)
+        rows.append(row);
+    return rows;
+}
+
+void TestSelectionTracker::selectRange() {
+    QVERIFY(m_tracker->isEmpty());
+    QCOMPARE(m_tracker->currentRow(), -1);
+
+    select(10, 19);
+    QCOMPARE(m_tracker->count(), 10);
+    QCOMPARE(m_tracker->rows(), range(10, 19));
+    QCOMPARE(m_tracker->anchorRow(), 10);
+    QCOMPARE(m_tracker->currentRow(), 19);
+    QVERIFY(!m_tracker->isSelected(9));
+    QVERIFY(m_tracker->isSelected(15));
+    QVERIFY(!m_tracker->isSelected(20));
+}
+
+void TestSelectionTracker::deselectMiddle() {
+    select(10, 19);
+    select(13, 15, QItemSelectionModel::Deselect);
+    QCOMPARE(m_tracker->count(), 7);
+    QCOMPARE(m_tracker->rows(), range(10, 12) + range(16, 19));
+    QVERIFY(!m_tracker->isSelected(14));
+
+    // current row was deselected: last selected row takes its place
+    select(16, 19, QItemSelectionModel::Deselect);
+    QCOMPARE(m_tracker->rows(), range(10, 12));
+    QCOMPARE(m_tracker->currentRow(), 12);
+}
+
+void TestSelectionTracker::mergeAdjacent() {
+    select(10, 12);
+    select(20, 22);
+    select(13, 19);
+    QCOMPARE(m_tracker->count(), 13);
+    QCOMPARE(m_tracker->rows(), range(10, 22));
+    QCOMPARE(m_tracker->currentRow(), 19);
+}
+
+void TestSelectionTracker::insertRows() {
+    select(10, 19);
+    m_model->insertRows(5, 2);
+    QCOMPARE(m_tracker->rows(), range(12, 21));
+    QCOMPARE(m_tracker->anchorRow(), 12);
+    QCOMPARE(m_tracker->currentRow(), 21);
+
+    // rows inserted inside selection follow selection model
+    m_model->insertRows(15, 3);
+    QCOMPARE(m_tracker->count(), m_selection->selectedRows().size());
+    for (int row = 0; row < m_model->rowCount(); ++row)
+        QCOMPARE(m_tracker->isSelected(row),
+                 m_selection->isRowSelected(row, QModelIndex()));
+}
+
+void TestSelectionTracker::removeRows() {
+    select(10, 19);
+    m_model->removeRows(0, 5);
+    QCOMPARE(m_tracker->rows(), range(5, 14));
+    QCOMPARE(m_tracker->currentRow(), 14);
+
+    m_model->removeRows(20, 10);
+    QCOMPARE(m_tracker->rows(), range(5, 14));
+}
+
+void TestSelectionTracker::removeSelectedRows() {
+    select(10, 12);
+    select(16, 19);
+    // removing gap joins both ranges
+    m_model->removeRows(13, 3);
+    QCOMPARE(m_tracker->rows(), range(10, 16));
+    QCOMPARE(m_tracker->count(), 7);
+
+    m_model->removeRows(11, 2);
+    QCOMPARE(m_tracker->rows(), range(10, 14));
+    QVERIFY(m_tracker->isSelected(m_tracker->currentRow()));
+    QVERIFY(m_tracker->isSelected(m_tracker->anchorRow()));
+}
+
+void TestSelectionTracker::clearSelection() {
+    select(10, 19);
+    m_selection->clearSelection();
+    QVERIFY(m_tracker->isEmpty());
+    QVERIFY(m_tracker->rows().isEmpty());
+    QCOMPARE(m_tracker->anchorRow(), -1);
+    QCOMPARE(m_tracker->currentRow(), -1);
+}
+
+void TestSelectionTracker::resetOnModelReset() {
+    select(10, 19);
+    m_model->clear();
+    QVERIFY(m_tracker->isEmpty());
+}
+
+QTEST_MAIN(TestSelectionTracker)
+#include "tst_selectiontracker.moc"
@@ -0,0 +1,8 @@
+include(../../tests.pri)
+
+TARGET = tst_bench_selection
+
+SOURCES += tst_bench_selection.cpp \
+    $$SRC/SelectionTracker.cpp
+
+HEADERS += $$SRC/SelectionTracker.h
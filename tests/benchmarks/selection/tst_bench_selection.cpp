@@ -0,0 +1,127 @@
+/**********************************************************************
+* File:        tst_bench_selection.cpp
+* Description: Benchmarks of large table selections
+* Author:      qt-box-editor developers
+* Created:     2026-10-19
+*
+* (C) Copyright 2026, qt-box-editor developers
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**    http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*
+**********************************************************************/
+
+
+#include <QItemSelectionModel>
+#include <QStandardItemModel>
+#include <QtTest>
+
+#include "SelectionTracker.h"
+
+/*
+ * Large selection in table of big page: cost of keyboard step
+ * (shift+arrow extends selection by one row) and of queries.
+ */
+class BenchSelection : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void extendSelection_data();
+    void extendSelection();
+    void selectedRows_data();
+    void selectedRows();
+    void insertAndRemoveRow();
+
+  private:
+    void selectRows(int count);
+
+    QStandardItemModel* m_model;
+    QItemSelectionModel* m_selection;
+    SelectionTracker* m_tracker;
+};
+
+namespace {
+
+const int kRowCount = 50000;
+
+}  // namespace
+
+void BenchSelection::initTestCase() {
+    // box table has 10 columns
+    m_model = new QStandardItemModel(kRowCount, 10);
+    m_selection = new QItemSelectionModel(m_model);
+    m_tracker = new SelectionTracker();
+    m_tracker->setSelectionModel(m_selection);
+}
+
+void BenchSelection::cleanupTestCase() {
+    delete m_tracker;
+    delete m_selection;
+    delete m_model;
+}
+
+void BenchSelection::selectRows(int count) {
+    m_selection->select(QItemSelection(m_model->index(0, 0),
+                                       m_model->index(count - 1, 9)),
+                        QItemSelectionModel::ClearAndSelect);
+}
+
+void BenchSelection::extendSelection_data() {
+    QTest::addColumn<int>("selected");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("40000") << 40000;
+}
+
+void BenchSelection::extendSelection() {
+    QFETCH(int, selected);
+    selectRows(selected);
+    int row = selected;
+    QBENCHMARK {
+        m_selection->select(QItemSelection(m_model->index(row, 0),
+                                           m_model->index(row, 9)),
+                            QItemSelectionModel::Select);
+        QVERIFY(m_tracker->currentRow() == row);
+        m_selection->select(QItemSelection(m_model->index(row, 0),
+                                           m_model->index(row, 9)),
+                            QItemSelectionModel::Deselect);
+    }
+    QCOMPARE(m_tracker->count(), selected);
+}
+
+void BenchSelection::selectedRows_data() {
+    extendSelection_data();
+}
+
+void BenchSelection::selectedRows() {
+    QFETCH(int, selected);
+    selectRows(selected);
+    QVector<int> rows;
+    QBENCHMARK {
+        rows = m_tracker->rows();
+    }
+    QCOMPARE(rows.size(), selected);
+}
+
+void BenchSelection::insertAndRemoveRow() {
+    selectRows(kRowCount / 2);
+    QBENCHMARK {
+        m_model->insertRow(0);
+        m_model->removeRow(0);
+    }
+    QCOMPARE(m_tracker->count(), kRowCount / 2);
+}
+
+QTEST_MAIN(BenchSelection)
+#include "tst_bench_selection.moc"
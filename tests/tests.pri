@@ -0,0 +1,13 @@
+# Common settings of test executables (qmake tests/tests.pro && make check)
+SRC = $$PWD/../src
+
+INCLUDEPATH += $$SRC
+DEPENDPATH += $$SRC
+
+QT += testlib
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
+CONFIG += testcase console
+CONFIG -= app_bundle
+
+OBJECTS_DIR += temp
+MOC_DIR += temp